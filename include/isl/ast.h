@@ -108,6 +108,8 @@ __isl_give isl_ast_expr *isl_ast_node_for_get_inc(
 __isl_give isl_ast_node *isl_ast_node_for_get_body(
 	__isl_keep isl_ast_node *node);
 isl_bool isl_ast_node_for_is_degenerate(__isl_keep isl_ast_node *node);
+isl_bool isl_ast_node_for_is_coincident(__isl_keep isl_ast_node *node);
+isl_bool isl_ast_node_for_is_vectorizable(__isl_keep isl_ast_node *node);
 
 __isl_give isl_ast_expr *isl_ast_node_if_get_cond(
 	__isl_keep isl_ast_node *node);
@@ -159,6 +161,8 @@ __isl_give isl_ast_print_options *isl_ast_print_options_set_print_for(
 
 isl_stat isl_options_set_ast_print_macro_once(isl_ctx *ctx, int val);
 int isl_options_get_ast_print_macro_once(isl_ctx *ctx);
+isl_stat isl_options_set_ast_print_openmp(isl_ctx *ctx, int val);
+int isl_options_get_ast_print_openmp(isl_ctx *ctx);
 
 isl_stat isl_ast_expr_foreach_ast_op_type(__isl_keep isl_ast_expr *expr,
 	isl_stat (*fn)(enum isl_ast_op_type type, void *user), void *user);
@@ -43,6 +43,12 @@ int isl_options_get_ast_build_allow_else(isl_ctx *ctx);
 isl_stat isl_options_set_ast_build_allow_or(isl_ctx *ctx, int val);
 int isl_options_get_ast_build_allow_or(isl_ctx *ctx);
 
+isl_stat isl_options_set_ast_build_share_exprs(isl_ctx *ctx, int val);
+int isl_options_get_ast_build_share_exprs(isl_ctx *ctx);
+
+int isl_ctx_get_ast_expr_cache_hits(isl_ctx *ctx);
+int isl_ctx_get_ast_expr_cache_misses(isl_ctx *ctx);
+
 isl_ctx *isl_ast_build_get_ctx(__isl_keep isl_ast_build *build);
 
 __isl_constructor
@@ -93,6 +99,10 @@ __isl_give isl_ast_build *isl_ast_build_set_create_leaf(
 	__isl_take isl_ast_build *build,
 	__isl_give isl_ast_node *(*fn)(__isl_take isl_ast_build *build,
 		void *user), void *user);
+__isl_give isl_ast_build *isl_ast_build_set_subtree_reuse(
+	__isl_take isl_ast_build *build, int reuse);
+__isl_give isl_ast_build *isl_ast_build_set_dependences(
+	__isl_take isl_ast_build *build, __isl_take isl_union_map *dependences);
 
 __isl_overload
 __isl_give isl_ast_expr *isl_ast_build_expr_from_set(
@@ -115,6 +125,15 @@ __isl_give isl_ast_expr *isl_ast_build_call_from_multi_pw_aff(
 
 __isl_give isl_ast_node *isl_ast_build_node_from_schedule(
 	__isl_keep isl_ast_build *build, __isl_take isl_schedule *schedule);
+__isl_give isl_ast_node *isl_ast_build_node_from_schedule_list(
+	__isl_keep isl_ast_build *build, __isl_take isl_schedule_list *schedules,
+	__isl_take isl_set_list *conditions);
+isl_stat isl_ast_build_foreach_node_from_schedule(
+	__isl_keep isl_ast_build *build, __isl_take isl_schedule *schedule,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user);
+__isl_give isl_printer *isl_ast_build_print_from_schedule(
+	__isl_keep isl_ast_build *build, __isl_take isl_schedule *schedule,
+	__isl_take isl_printer *p, __isl_take isl_ast_print_options *options);
 __isl_export
 __isl_give isl_ast_node *isl_ast_build_node_from_schedule_map(
 	__isl_keep isl_ast_build *build, __isl_take isl_union_map *schedule);
@@ -50,6 +50,27 @@ int isl_options_get_schedule_whole_component(isl_ctx *ctx);
 isl_stat isl_options_set_schedule_carry_self_first(isl_ctx *ctx, int val);
 int isl_options_get_schedule_carry_self_first(isl_ctx *ctx);
 
+isl_stat isl_options_set_schedule_max_operations(isl_ctx *ctx, int val);
+int isl_options_get_schedule_max_operations(isl_ctx *ctx);
+
+enum isl_schedule_fallback {
+	isl_schedule_fallback_none = 0,
+	isl_schedule_fallback_clustering = 1 << 0,
+	isl_schedule_fallback_carry = 1 << 1,
+	isl_schedule_fallback_serialize = 1 << 2
+};
+
+int isl_ctx_last_schedule_fallbacks(isl_ctx *ctx);
+
+isl_stat isl_options_set_schedule_cache_dir(isl_ctx *ctx, const char *val);
+const char *isl_options_get_schedule_cache_dir(isl_ctx *ctx);
+
+isl_stat isl_options_set_schedule_cache_size(isl_ctx *ctx, int val);
+int isl_options_get_schedule_cache_size(isl_ctx *ctx);
+
+int isl_ctx_get_schedule_cache_hits(isl_ctx *ctx);
+int isl_ctx_get_schedule_cache_misses(isl_ctx *ctx);
+
 __isl_give isl_schedule_constraints *isl_schedule_constraints_copy(
 	__isl_keep isl_schedule_constraints *sc);
 __isl_export
@@ -122,6 +143,8 @@ __isl_give char *isl_schedule_constraints_to_str(
 __isl_export
 __isl_give isl_schedule *isl_schedule_constraints_compute_schedule(
 	__isl_take isl_schedule_constraints *sc);
+__isl_give isl_schedule *isl_schedule_constraints_recompute_schedule(
+	__isl_take isl_schedule_constraints *sc, __isl_take isl_schedule *prev);
 
 __isl_give isl_schedule *isl_union_set_compute_schedule(
 	__isl_take isl_union_set *domain,
@@ -192,6 +215,8 @@ __isl_give isl_printer *isl_printer_print_schedule(__isl_take isl_printer *p,
 void isl_schedule_dump(__isl_keep isl_schedule *schedule);
 __isl_give char *isl_schedule_to_str(__isl_keep isl_schedule *schedule);
 
+ISL_DECLARE_LIST_FN(schedule)
+
 #if defined(__cplusplus)
 }
 #endif
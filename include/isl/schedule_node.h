@@ -131,6 +131,8 @@ isl_stat isl_options_set_tile_scale_tile_loops(isl_ctx *ctx, int val);
 int isl_options_get_tile_scale_tile_loops(isl_ctx *ctx);
 isl_stat isl_options_set_tile_shift_point_loops(isl_ctx *ctx, int val);
 int isl_options_get_tile_shift_point_loops(isl_ctx *ctx);
+isl_stat isl_options_set_tile_cache_size(isl_ctx *ctx, int val);
+int isl_options_get_tile_cache_size(isl_ctx *ctx);
 
 __isl_give isl_schedule_node *isl_schedule_node_band_scale(
 	__isl_take isl_schedule_node *node, __isl_take isl_multi_val *mv);
@@ -143,6 +145,8 @@ __isl_give isl_schedule_node *isl_schedule_node_band_shift(
 	__isl_take isl_multi_union_pw_aff *shift);
 __isl_give isl_schedule_node *isl_schedule_node_band_tile(
 	__isl_take isl_schedule_node *node, __isl_take isl_multi_val *sizes);
+__isl_give isl_schedule_node *isl_schedule_node_band_tile_auto(
+	__isl_take isl_schedule_node *node, __isl_take isl_union_map *access);
 __isl_give isl_schedule_node *isl_schedule_node_band_sink(
 	__isl_take isl_schedule_node *node);
 __isl_give isl_schedule_node *isl_schedule_node_band_split(
@@ -201,6 +205,9 @@ __isl_give isl_schedule_node *isl_schedule_node_insert_guard(
 	__isl_take isl_schedule_node *node, __isl_take isl_set *context);
 __isl_give isl_schedule_node *isl_schedule_node_insert_mark(
 	__isl_take isl_schedule_node *node, __isl_take isl_id *mark);
+__isl_give isl_schedule_node *isl_schedule_node_insert_private_mark(
+	__isl_take isl_schedule_node *node, __isl_take isl_union_map *reads,
+	__isl_take isl_union_map *writes);
 __isl_give isl_schedule_node *isl_schedule_node_insert_sequence(
 	__isl_take isl_schedule_node *node,
 	__isl_take isl_union_set_list *filters);
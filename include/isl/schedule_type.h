@@ -1,6 +1,8 @@
 #ifndef ISL_SCHEDULE_TYPE_H
 #define ISL_SCHEDULE_TYPE_H
 
+#include <isl/list.h>
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -25,6 +27,7 @@ typedef struct isl_schedule_node isl_schedule_node;
 
 struct __isl_export isl_schedule;
 typedef struct isl_schedule isl_schedule;
+ISL_DECLARE_LIST_TYPE(schedule)
 
 #if defined(__cplusplus)
 }
@@ -444,6 +444,9 @@ isl_bool isl_set_plain_is_disjoint(__isl_keep isl_set *set1,
 
 uint32_t isl_set_get_hash(struct isl_set *set);
 
+__isl_give isl_set *isl_set_canonicalize(__isl_take isl_set *set);
+isl_stat isl_set_get_stable_hash(__isl_keep isl_set *set, uint64_t *hash);
+
 int isl_set_n_basic_set(__isl_keep isl_set *set);
 __isl_export
 isl_stat isl_set_foreach_basic_set(__isl_keep isl_set *set,
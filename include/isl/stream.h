@@ -82,8 +82,26 @@ __isl_give isl_pw_qpolynomial *isl_stream_read_pw_qpolynomial(
 	__isl_keep isl_stream *s);
 __isl_give isl_union_set *isl_stream_read_union_set(__isl_keep isl_stream *s);
 __isl_give isl_union_map *isl_stream_read_union_map(__isl_keep isl_stream *s);
+isl_stat isl_stream_read_union_map_foreach_map(__isl_keep isl_stream *s,
+	isl_stat (*fn)(__isl_take isl_map *map, void *user), void *user);
+isl_stat isl_stream_read_union_set_foreach_set(__isl_keep isl_stream *s,
+	isl_stat (*fn)(__isl_take isl_set *set, void *user), void *user);
 __isl_give isl_schedule *isl_stream_read_schedule(isl_stream *s);
 
+__isl_give isl_basic_map *isl_stream_read_binary_basic_map(
+	__isl_keep isl_stream *s);
+__isl_give isl_basic_set *isl_stream_read_binary_basic_set(
+	__isl_keep isl_stream *s);
+__isl_give isl_map *isl_stream_read_binary_map(__isl_keep isl_stream *s);
+__isl_give isl_set *isl_stream_read_binary_set(__isl_keep isl_stream *s);
+__isl_give isl_union_map *isl_stream_read_binary_union_map(
+	__isl_keep isl_stream *s);
+__isl_give isl_union_set *isl_stream_read_binary_union_set(
+	__isl_keep isl_stream *s);
+__isl_give isl_multi_aff *isl_stream_read_binary_multi_aff(
+	__isl_keep isl_stream *s);
+__isl_give isl_pw_aff *isl_stream_read_binary_pw_aff(__isl_keep isl_stream *s);
+
 int isl_stream_yaml_read_start_mapping(__isl_keep isl_stream *s);
 int isl_stream_yaml_read_end_mapping(__isl_keep isl_stream *s);
 int isl_stream_yaml_read_start_sequence(__isl_keep isl_stream *s);
@@ -229,6 +229,10 @@ isl_bool isl_union_map_is_strict_subset(__isl_keep isl_union_map *umap1,
 	__isl_keep isl_union_map *umap2);
 
 uint32_t isl_union_map_get_hash(__isl_keep isl_union_map *umap);
+__isl_give isl_union_map *isl_union_map_canonicalize(
+	__isl_take isl_union_map *umap);
+isl_stat isl_union_map_get_stable_hash(__isl_keep isl_union_map *umap,
+	uint64_t *hash);
 
 int isl_union_map_n_map(__isl_keep isl_union_map *umap);
 __isl_export
@@ -277,6 +281,11 @@ __isl_give isl_union_map *isl_union_map_lex_gt_at_multi_union_pw_aff(
 
 __isl_give isl_union_map *isl_union_map_read_from_file(isl_ctx *ctx,
 	FILE *input);
+__isl_give isl_union_map *isl_union_map_read_binary_from_file(
+	isl_ctx *ctx, FILE *input);
+isl_stat isl_union_map_str_foreach_chunk(isl_ctx *ctx, const char *str,
+	size_t size, isl_stat (*fn)(__isl_take char *chunk, void *user),
+	void *user);
 __isl_constructor
 __isl_give isl_union_map *isl_union_map_read_from_str(isl_ctx *ctx,
 	const char *str);
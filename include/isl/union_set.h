@@ -114,6 +114,10 @@ isl_bool isl_union_set_is_strict_subset(__isl_keep isl_union_set *uset1,
 	__isl_keep isl_union_set *uset2);
 
 uint32_t isl_union_set_get_hash(__isl_keep isl_union_set *uset);
+__isl_give isl_union_set *isl_union_set_canonicalize(
+	__isl_take isl_union_set *uset);
+isl_stat isl_union_set_get_stable_hash(__isl_keep isl_union_set *uset,
+	uint64_t *hash);
 
 int isl_union_set_n_set(__isl_keep isl_union_set *uset);
 __isl_export
@@ -156,6 +160,8 @@ __isl_give isl_union_set *isl_union_set_solutions(
 
 __isl_give isl_union_set *isl_union_set_read_from_file(isl_ctx *ctx,
 	FILE *input);
+__isl_give isl_union_set *isl_union_set_read_binary_from_file(
+	isl_ctx *ctx, FILE *input);
 __isl_constructor
 __isl_give isl_union_set *isl_union_set_read_from_str(isl_ctx *ctx,
 	const char *str);
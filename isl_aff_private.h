@@ -99,6 +99,8 @@ __isl_give isl_aff *isl_aff_expand_divs( __isl_take isl_aff *aff,
 
 __isl_give isl_pw_aff *isl_pw_aff_alloc_size(__isl_take isl_space *space,
 	int n);
+__isl_give isl_pw_aff *isl_pw_aff_add_piece(__isl_take isl_pw_aff *pwaff,
+	__isl_take isl_set *set, __isl_take isl_aff *aff);
 __isl_give isl_pw_aff *isl_pw_aff_reset_space(__isl_take isl_pw_aff *pwaff,
 	__isl_take isl_space *dim);
 __isl_give isl_pw_aff *isl_pw_aff_reset_domain_space(
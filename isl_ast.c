@@ -11,7 +11,9 @@
 
 #include <isl/id.h>
 #include <isl/val.h>
+#include <isl/hash.h>
 #include <isl_ast_private.h>
+#include <isl_printer_private.h>
 
 #undef BASE
 #define BASE ast_expr
@@ -62,6 +64,10 @@ __isl_give isl_ast_print_options *isl_ast_print_options_dup(
 	dup->print_for_user = options->print_for_user;
 	dup->print_user = options->print_user;
 	dup->print_user_user = options->print_user_user;
+	dup->in_omp_parallel = options->in_omp_parallel;
+	dup->omp_clauses = isl_id_list_copy(options->omp_clauses);
+	if (options->omp_clauses && !dup->omp_clauses)
+		return isl_ast_print_options_free(dup);
 
 	return dup;
 }
@@ -99,6 +105,7 @@ __isl_null isl_ast_print_options *isl_ast_print_options_free(
 
 	isl_ctx_deref(options->ctx);
 
+	isl_id_list_free(options->omp_clauses);
 	free(options);
 	return NULL;
 }
@@ -988,6 +995,8 @@ __isl_give isl_ast_node *isl_ast_node_dup(__isl_keep isl_ast_node *node)
 		dup->u.f.cond = isl_ast_expr_copy(node->u.f.cond);
 		dup->u.f.inc = isl_ast_expr_copy(node->u.f.inc);
 		dup->u.f.body = isl_ast_node_copy(node->u.f.body);
+		dup->u.f.degenerate = node->u.f.degenerate;
+		dup->u.f.coincident = node->u.f.coincident;
 		if (!dup->u.f.iterator || !dup->u.f.init || !dup->u.f.cond ||
 		    !dup->u.f.inc || !dup->u.f.body)
 			return isl_ast_node_free(dup);
@@ -1123,6 +1132,67 @@ isl_bool isl_ast_node_for_is_degenerate(__isl_keep isl_ast_node *node)
 	return node->u.f.degenerate;
 }
 
+/* Mark the given for node as being coincident.
+ */
+__isl_give isl_ast_node *isl_ast_node_for_mark_coincident(
+	__isl_take isl_ast_node *node)
+{
+	node = isl_ast_node_cow(node);
+	if (!node)
+		return NULL;
+	node->u.f.coincident = 1;
+	return node;
+}
+
+/* Was the for node "node" generated from a coincident band member?
+ * If so, the iterations of the loop can be executed in parallel
+ * for fixed values of the outer loop iterators.
+ */
+isl_bool isl_ast_node_for_is_coincident(__isl_keep isl_ast_node *node)
+{
+	if (!node)
+		return isl_bool_error;
+	if (node->type != isl_ast_node_for)
+		isl_die(isl_ast_node_get_ctx(node), isl_error_invalid,
+			"not a for node", return isl_bool_error);
+	return node->u.f.coincident;
+}
+
+/* Is "node" a for node that is not degenerate?
+ * If so, set *found and abort the search.
+ */
+static isl_bool is_proper_for(__isl_keep isl_ast_node *node, void *user)
+{
+	int *found = user;
+
+	if (node->type != isl_ast_node_for || node->u.f.degenerate)
+		return isl_bool_true;
+	*found = 1;
+	return isl_bool_error;
+}
+
+/* Is the for node "node" coincident and innermost?
+ * That is, is it coincident and does its body not contain any loops?
+ * Degenerate for nodes in the body do not count as loops.
+ * Such a loop is a candidate for vectorization.
+ */
+isl_bool isl_ast_node_for_is_vectorizable(__isl_keep isl_ast_node *node)
+{
+	int found = 0;
+
+	if (!node)
+		return isl_bool_error;
+	if (node->type != isl_ast_node_for)
+		isl_die(isl_ast_node_get_ctx(node), isl_error_invalid,
+			"not a for node", return isl_bool_error);
+	if (!node->u.f.coincident)
+		return isl_bool_false;
+	if (isl_ast_node_foreach_descendant_top_down(node->u.f.body,
+					&is_proper_for, &found) < 0 && !found)
+		return isl_bool_error;
+	return !found;
+}
+
 __isl_give isl_ast_expr *isl_ast_node_for_get_iterator(
 	__isl_keep isl_ast_node *node)
 {
@@ -1208,6 +1278,28 @@ error:
 	return NULL;
 }
 
+/* Replace the else branch of the if node "node" by "child".
+ */
+__isl_give isl_ast_node *isl_ast_node_if_set_else(
+	__isl_take isl_ast_node *node, __isl_take isl_ast_node *child)
+{
+	node = isl_ast_node_cow(node);
+	if (!node || !child)
+		goto error;
+	if (node->type != isl_ast_node_if)
+		isl_die(isl_ast_node_get_ctx(node), isl_error_invalid,
+			"not an if node", goto error);
+
+	isl_ast_node_free(node->u.i.else_node);
+	node->u.i.else_node = child;
+
+	return node;
+error:
+	isl_ast_node_free(node);
+	isl_ast_node_free(child);
+	return NULL;
+}
+
 __isl_give isl_ast_node *isl_ast_node_if_get_then(
 	__isl_keep isl_ast_node *node)
 {
@@ -1403,6 +1495,335 @@ isl_stat isl_ast_node_foreach_descendant_top_down(
 	return isl_stat_ok;
 }
 
+/* Are "expr1" and "expr2" either both NULL or equal to each other?
+ * This is used to compare optional expressions such as
+ * the condition and increment of a for node.
+ */
+static isl_bool optional_expr_is_equal(__isl_keep isl_ast_expr *expr1,
+	__isl_keep isl_ast_expr *expr2)
+{
+	if (!expr1 || !expr2)
+		return !expr1 && !expr2;
+	return isl_ast_expr_is_equal(expr1, expr2);
+}
+
+static isl_bool optional_node_plain_is_equal(__isl_keep isl_ast_node *node1,
+	__isl_keep isl_ast_node *node2);
+
+/* Are the for nodes "node1" and "node2" obviously equal to each other,
+ * ignoring their bodies?
+ */
+static isl_bool for_header_plain_is_equal(__isl_keep isl_ast_node *node1,
+	__isl_keep isl_ast_node *node2)
+{
+	isl_bool equal;
+
+	if (node1->u.f.degenerate != node2->u.f.degenerate ||
+	    node1->u.f.coincident != node2->u.f.coincident)
+		return isl_bool_false;
+	equal = isl_ast_expr_is_equal(node1->u.f.iterator, node2->u.f.iterator);
+	if (equal < 0 || !equal)
+		return equal;
+	equal = isl_ast_expr_is_equal(node1->u.f.init, node2->u.f.init);
+	if (equal < 0 || !equal)
+		return equal;
+	equal = optional_expr_is_equal(node1->u.f.cond, node2->u.f.cond);
+	if (equal < 0 || !equal)
+		return equal;
+	return optional_expr_is_equal(node1->u.f.inc, node2->u.f.inc);
+}
+
+/* Do "node1" and "node2" have obviously equal headers?
+ * That is, are they of the same type with equal expressions,
+ * ignoring their children (if any)?
+ * For block nodes, only the number of children is compared.
+ */
+isl_bool isl_ast_node_plain_has_equal_header(__isl_keep isl_ast_node *node1,
+	__isl_keep isl_ast_node *node2)
+{
+	if (!node1 || !node2)
+		return isl_bool_error;
+
+	if (node1 == node2)
+		return isl_bool_true;
+	if (node1->type != node2->type)
+		return isl_bool_false;
+	if (node1->annotation != node2->annotation)
+		return isl_bool_false;
+
+	switch (node1->type) {
+	case isl_ast_node_for:
+		return for_header_plain_is_equal(node1, node2);
+	case isl_ast_node_if:
+		if (!node1->u.i.else_node != !node2->u.i.else_node)
+			return isl_bool_false;
+		return isl_ast_expr_is_equal(node1->u.i.guard,
+					    node2->u.i.guard);
+	case isl_ast_node_block:
+		if (!node1->u.b.children || !node2->u.b.children)
+			return isl_bool_error;
+		return node1->u.b.children->n == node2->u.b.children->n;
+	case isl_ast_node_mark:
+		return node1->u.m.mark == node2->u.m.mark;
+	case isl_ast_node_user:
+		return isl_ast_expr_is_equal(node1->u.e.expr, node2->u.e.expr);
+	case isl_ast_node_error:
+		return isl_bool_error;
+	}
+
+	return isl_bool_false;
+}
+
+/* Are "node1" and "node2" obviously equal to each other,
+ * i.e., do they have the same structure and equal expressions?
+ */
+isl_bool isl_ast_node_plain_is_equal(__isl_keep isl_ast_node *node1,
+	__isl_keep isl_ast_node *node2)
+{
+	int i;
+	isl_bool equal;
+
+	equal = isl_ast_node_plain_has_equal_header(node1, node2);
+	if (equal < 0 || !equal || node1 == node2)
+		return equal;
+
+	switch (node1->type) {
+	case isl_ast_node_for:
+		return isl_ast_node_plain_is_equal(node1->u.f.body,
+						    node2->u.f.body);
+	case isl_ast_node_if:
+		equal = isl_ast_node_plain_is_equal(node1->u.i.then,
+						    node2->u.i.then);
+		if (equal < 0 || !equal)
+			return equal;
+		return optional_node_plain_is_equal(node1->u.i.else_node,
+						    node2->u.i.else_node);
+	case isl_ast_node_block:
+		for (i = 0; i < node1->u.b.children->n; ++i) {
+			equal = isl_ast_node_plain_is_equal(
+					node1->u.b.children->p[i],
+					node2->u.b.children->p[i]);
+			if (equal < 0 || !equal)
+				return equal;
+		}
+		return isl_bool_true;
+	case isl_ast_node_mark:
+		return isl_ast_node_plain_is_equal(node1->u.m.node,
+						    node2->u.m.node);
+	case isl_ast_node_user:
+		return isl_bool_true;
+	case isl_ast_node_error:
+		return isl_bool_error;
+	}
+
+	return isl_bool_true;
+}
+
+/* Are "node1" and "node2" either both NULL or obviously equal to each other?
+ */
+static isl_bool optional_node_plain_is_equal(__isl_keep isl_ast_node *node1,
+	__isl_keep isl_ast_node *node2)
+{
+	if (!node1 || !node2)
+		return !node1 && !node2;
+	return isl_ast_node_plain_is_equal(node1, node2);
+}
+
+/* Compute a hash value for "expr", assuming that the arguments
+ * of "expr" (if any) have already been replaced by their
+ * representatives in the table of shared expressions.
+ * The arguments can then be hashed by their addresses.
+ */
+static uint32_t shared_expr_hash(__isl_keep isl_ast_expr *expr)
+{
+	int i;
+	uint32_t hash;
+
+	hash = isl_hash_init();
+	isl_hash_byte(hash, expr->type & 0xFF);
+	switch (expr->type) {
+	case isl_ast_expr_int:
+		isl_hash_hash(hash, isl_val_get_hash(expr->u.v));
+		break;
+	case isl_ast_expr_id:
+		hash = isl_hash_builtin(hash, expr->u.id);
+		break;
+	case isl_ast_expr_op:
+		isl_hash_byte(hash, expr->u.op.op & 0xFF);
+		for (i = 0; i < expr->u.op.n_arg; ++i)
+			hash = isl_hash_builtin(hash, expr->u.op.args[i]);
+		break;
+	case isl_ast_expr_error:
+		break;
+	}
+
+	return hash;
+}
+
+/* Is the expression "entry" in the table of shared expressions
+ * structurally equal to "val"?
+ * The arguments of both expressions have already been replaced
+ * by their representatives, so they can be compared by address.
+ */
+static int shared_expr_has_equal(const void *entry, const void *val)
+{
+	int i;
+	isl_ast_expr *expr1 = (isl_ast_expr *) entry;
+	isl_ast_expr *expr2 = (isl_ast_expr *) val;
+
+	if (expr1->type != expr2->type)
+		return 0;
+	switch (expr1->type) {
+	case isl_ast_expr_int:
+		return isl_val_eq(expr1->u.v, expr2->u.v) == isl_bool_true;
+	case isl_ast_expr_id:
+		return expr1->u.id == expr2->u.id;
+	case isl_ast_expr_op:
+		if (expr1->u.op.op != expr2->u.op.op)
+			return 0;
+		if (expr1->u.op.n_arg != expr2->u.op.n_arg)
+			return 0;
+		for (i = 0; i < expr1->u.op.n_arg; ++i)
+			if (expr1->u.op.args[i] != expr2->u.op.args[i])
+				return 0;
+		return 1;
+	case isl_ast_expr_error:
+		return 0;
+	}
+
+	return 0;
+}
+
+/* Return the representative of "expr" in "table",
+ * making "expr" itself the representative if there is
+ * no structurally equal expression in "table" yet.
+ *
+ * The arguments of "expr" are first replaced by their representatives.
+ * This replacement is performed in place, even if "expr" is shared,
+ * since it does not change the meaning of "expr".
+ * The representatives are kept alive by the AST in which
+ * they appear, so "table" does not hold any references.
+ */
+static __isl_give isl_ast_expr *share_expr(isl_ctx *ctx,
+	struct isl_hash_table *table, __isl_take isl_ast_expr *expr)
+{
+	int i;
+	uint32_t hash;
+	struct isl_hash_table_entry *entry;
+
+	if (!expr)
+		return NULL;
+
+	if (expr->type == isl_ast_expr_op) {
+		for (i = 0; i < expr->u.op.n_arg; ++i) {
+			expr->u.op.args[i] = share_expr(ctx, table,
+							expr->u.op.args[i]);
+			if (!expr->u.op.args[i])
+				return isl_ast_expr_free(expr);
+		}
+	}
+
+	hash = shared_expr_hash(expr);
+	entry = isl_hash_table_find(ctx, table, hash,
+				    &shared_expr_has_equal, expr, 1);
+	if (!entry)
+		return isl_ast_expr_free(expr);
+	if (!entry->data) {
+		entry->data = expr;
+		return expr;
+	}
+	if (entry->data == expr)
+		return expr;
+
+	isl_ast_expr_free(expr);
+	return isl_ast_expr_copy(entry->data);
+}
+
+/* Replace the expression "*expr", if any, by its representative in "table".
+ */
+static isl_stat share_expr_in_place(isl_ctx *ctx,
+	struct isl_hash_table *table, isl_ast_expr **expr)
+{
+	if (!*expr)
+		return isl_stat_ok;
+	*expr = share_expr(ctx, table, *expr);
+	return *expr ? isl_stat_ok : isl_stat_error;
+}
+
+/* Replace all expressions in "node" by their representatives in "table".
+ * The nodes are modified in place since the replacement
+ * does not change their meaning.
+ */
+static isl_stat share_node_exprs(isl_ctx *ctx, struct isl_hash_table *table,
+	__isl_keep isl_ast_node *node)
+{
+	int i;
+
+	if (!node)
+		return isl_stat_error;
+
+	switch (node->type) {
+	case isl_ast_node_for:
+		if (share_expr_in_place(ctx, table, &node->u.f.iterator) < 0 ||
+		    share_expr_in_place(ctx, table, &node->u.f.init) < 0 ||
+		    share_expr_in_place(ctx, table, &node->u.f.cond) < 0 ||
+		    share_expr_in_place(ctx, table, &node->u.f.inc) < 0)
+			return isl_stat_error;
+		return share_node_exprs(ctx, table, node->u.f.body);
+	case isl_ast_node_if:
+		if (share_expr_in_place(ctx, table, &node->u.i.guard) < 0)
+			return isl_stat_error;
+		if (share_node_exprs(ctx, table, node->u.i.then) < 0)
+			return isl_stat_error;
+		if (!node->u.i.else_node)
+			return isl_stat_ok;
+		return share_node_exprs(ctx, table, node->u.i.else_node);
+	case isl_ast_node_block:
+		if (!node->u.b.children)
+			return isl_stat_error;
+		for (i = 0; i < node->u.b.children->n; ++i)
+			if (share_node_exprs(ctx, table,
+					    node->u.b.children->p[i]) < 0)
+				return isl_stat_error;
+		return isl_stat_ok;
+	case isl_ast_node_mark:
+		return share_node_exprs(ctx, table, node->u.m.node);
+	case isl_ast_node_user:
+		return share_expr_in_place(ctx, table, &node->u.e.expr);
+	case isl_ast_node_error:
+		return isl_stat_error;
+	}
+
+	return isl_stat_ok;
+}
+
+/* Make structurally identical expressions in "node" share storage.
+ * That is, turn the expressions in "node" into a DAG in which
+ * each distinct (sub)expression is represented by a single
+ * isl_ast_expr object.
+ * Since isl_ast_expr objects are only modified after
+ * they have been made unique (see isl_ast_expr_cow), this
+ * does not affect any subsequent operations on "node" or
+ * on any of the expressions extracted from it.
+ */
+__isl_give isl_ast_node *isl_ast_node_share_exprs(
+	__isl_take isl_ast_node *node)
+{
+	isl_ctx *ctx;
+	struct isl_hash_table *table;
+
+	if (!node)
+		return NULL;
+
+	ctx = isl_ast_node_get_ctx(node);
+	table = isl_hash_table_alloc(ctx, 64);
+	if (!table || share_node_exprs(ctx, table, node) < 0)
+		node = isl_ast_node_free(node);
+	isl_hash_table_free(ctx, table);
+
+	return node;
+}
+
 /* Textual C representation of the various operators.
  */
 static char *op_str_c[] = {
@@ -2139,6 +2560,9 @@ static __isl_give isl_printer *print_ast_node_isl(__isl_take isl_printer *p,
  * the child of the mark node.  However, even if the child would not
  * require us to print a block, for readability it is probably best
  * to print a block anyway.
+ * If the node is a coincident for node and the ast_print_openmp option
+ * has been set, then the for node may be preceded by a pragma,
+ * which should not be used as the body of a for or if node.
  * If the ast_always_print_block option has been set, then we print a block.
  */
 static int need_block(__isl_keep isl_ast_node *node)
@@ -2155,6 +2579,9 @@ static int need_block(__isl_keep isl_ast_node *node)
 		return 1;
 
 	ctx = isl_ast_node_get_ctx(node);
+	if (node->type == isl_ast_node_for && node->u.f.coincident &&
+	    isl_options_get_ast_print_openmp(ctx))
+		return 1;
 	return isl_options_get_ast_always_print_block(ctx);
 }
 
@@ -2247,6 +2674,134 @@ static __isl_give isl_printer *end_block(__isl_take isl_printer *p)
 	return p;
 }
 
+/* Is "node" a for node that is printed with an "omp parallel for" pragma
+ * when printed using "options"?
+ * That is, is the ast_print_openmp option set and is "node"
+ * a non-degenerate coincident for node that does not appear
+ * inside a loop that was printed with such a pragma?
+ * The result does not depend on whether a print_for callback is set
+ * since such a callback may in turn call isl_ast_node_for_print,
+ * which should then print the same pragma as in the absence
+ * of the callback.
+ */
+static int is_omp_parallel_for(__isl_keep isl_ast_node *node,
+	__isl_keep isl_ast_print_options *options)
+{
+	if (!isl_options_get_ast_print_openmp(isl_ast_node_get_ctx(node)))
+		return 0;
+	if (node->type != isl_ast_node_for)
+		return 0;
+	if (node->u.f.degenerate || !node->u.f.coincident)
+		return 0;
+	return !options->in_omp_parallel;
+}
+
+/* Is "id" the identifier of a mark that represents an OpenMP clause,
+ * i.e., a "private" or "reduction" clause?
+ */
+static int is_omp_clause(__isl_keep isl_id *id)
+{
+	const char *name;
+
+	name = isl_id_get_name(id);
+	if (!name)
+		return 0;
+	return !strncmp(name, "private(", strlen("private(")) ||
+		!strncmp(name, "reduction(", strlen("reduction("));
+}
+
+/* Is "node" a mark node representing an OpenMP clause
+ * that applies to a for node printed with an "omp parallel for" pragma
+ * when printed using "options"?
+ * That is, is the first descendant of "node" that is not
+ * also such a mark node a for node that is printed with such a pragma?
+ */
+static int is_omp_clause_mark(__isl_keep isl_ast_node *node,
+	__isl_keep isl_ast_print_options *options)
+{
+	if (node->type != isl_ast_node_mark || !is_omp_clause(node->u.m.mark))
+		return 0;
+	while (node->type == isl_ast_node_mark &&
+	    is_omp_clause(node->u.m.mark))
+		node = node->u.m.node;
+	return is_omp_parallel_for(node, options);
+}
+
+/* Print the OpenMP clauses collected in "options", if any,
+ * each preceded by a space.
+ */
+static __isl_give isl_printer *print_omp_clauses(__isl_take isl_printer *p,
+	__isl_keep isl_ast_print_options *options)
+{
+	int i, n;
+
+	n = isl_id_list_n_id(options->omp_clauses);
+	for (i = 0; i < n; ++i) {
+		isl_id *id;
+
+		id = isl_id_list_get_id(options->omp_clauses, i);
+		p = isl_printer_print_str(p, " ");
+		p = isl_printer_print_str(p, isl_id_get_name(id));
+		isl_id_free(id);
+	}
+
+	return p;
+}
+
+/* Print an OpenMP pragma for the non-degenerate for node "node", if needed,
+ * and return the print options that should be used for printing its body
+ * in "body_options".
+ *
+ * Pragmas are only printed if the ast_print_openmp option is set
+ * and only for coincident loops.
+ * A coincident loop that does not appear inside a loop that
+ * was printed with an "omp parallel for" pragma is printed
+ * with such a pragma itself, along with the clauses of
+ * any enclosing clause marks collected in "options".
+ * The print options of its body record that the body appears
+ * inside such a loop and no longer contain any clauses.
+ * A vectorizable loop inside such a loop is printed
+ * with an "omp simd" pragma.
+ */
+static __isl_give isl_printer *print_omp_pragma(__isl_take isl_printer *p,
+	__isl_keep isl_ast_node *node,
+	__isl_keep isl_ast_print_options *options,
+	__isl_give isl_ast_print_options **body_options)
+{
+	isl_bool vectorizable;
+
+	*body_options = isl_ast_print_options_copy(options);
+	if (!isl_options_get_ast_print_openmp(isl_printer_get_ctx(p)))
+		return p;
+	if (!node->u.f.coincident)
+		return p;
+
+	if (is_omp_parallel_for(node, options)) {
+		p = isl_printer_start_line(p);
+		p = isl_printer_print_str(p, "#pragma omp parallel for");
+		p = print_omp_clauses(p, options);
+		p = isl_printer_end_line(p);
+		*body_options = isl_ast_print_options_cow(*body_options);
+		if (!*body_options)
+			return isl_printer_free(p);
+		(*body_options)->in_omp_parallel = 1;
+		(*body_options)->omp_clauses =
+			isl_id_list_free((*body_options)->omp_clauses);
+		return p;
+	}
+
+	vectorizable = isl_ast_node_for_is_vectorizable(node);
+	if (vectorizable < 0)
+		return isl_printer_free(p);
+	if (!vectorizable)
+		return p;
+	p = isl_printer_start_line(p);
+	p = isl_printer_print_str(p, "#pragma omp simd");
+	p = isl_printer_end_line(p);
+
+	return p;
+}
+
 /* Print the for node "node".
  *
  * If the for node is degenerate, it is printed as
@@ -2259,6 +2814,8 @@ static __isl_give isl_printer *end_block(__isl_take isl_printer *p)
  *	for (type iterator = init; cond; iterator += inc)
  *		body
  *
+ * possibly preceded by an OpenMP pragma.  See print_omp_pragma.
+ *
  * "in_block" is set if we are currently inside a block.
  * "in_list" is set if the current node is not alone in the block.
  * If we are not in a block or if the current not is not alone in the block
@@ -2276,9 +2833,12 @@ static __isl_give isl_printer *print_for_c(__isl_take isl_printer *p,
 
 	type = isl_options_get_ast_iterator_type(isl_printer_get_ctx(p));
 	if (!node->u.f.degenerate) {
+		isl_ast_print_options *body_options;
+
 		id = isl_ast_expr_get_id(node->u.f.iterator);
 		name = isl_id_get_name(id);
 		isl_id_free(id);
+		p = print_omp_pragma(p, node, options, &body_options);
 		p = isl_printer_start_line(p);
 		p = isl_printer_print_str(p, "for (");
 		p = isl_printer_print_str(p, type);
@@ -2293,7 +2853,8 @@ static __isl_give isl_printer *print_for_c(__isl_take isl_printer *p,
 		p = isl_printer_print_str(p, " += ");
 		p = isl_printer_print_ast_expr(p, node->u.f.inc);
 		p = isl_printer_print_str(p, ")");
-		p = print_body_c(p, node->u.f.body, NULL, options, 0);
+		p = print_body_c(p, node->u.f.body, NULL, body_options, 0);
+		isl_ast_print_options_free(body_options);
 	} else {
 		id = isl_ast_expr_get_id(node->u.f.iterator);
 		name = isl_id_get_name(id);
@@ -2336,6 +2897,36 @@ static __isl_give isl_printer *print_if_c(__isl_take isl_printer *p,
 	return p;
 }
 
+/* Print the mark node "node", representing an OpenMP clause
+ * that applies to a for node printed with an "omp parallel for" pragma,
+ * to "p".
+ * Instead of printing the mark as a comment, add the clause
+ * to the print options such that it gets printed along with the pragma.
+ */
+static __isl_give isl_printer *print_omp_clause_mark(
+	__isl_take isl_printer *p, __isl_keep isl_ast_node *node,
+	__isl_keep isl_ast_print_options *options, int in_list)
+{
+	isl_ctx *ctx;
+
+	ctx = isl_ast_node_get_ctx(node);
+	options = isl_ast_print_options_copy(options);
+	options = isl_ast_print_options_cow(options);
+	if (!options)
+		return isl_printer_free(p);
+	if (!options->omp_clauses)
+		options->omp_clauses = isl_id_list_alloc(ctx, 1);
+	options->omp_clauses = isl_id_list_add(options->omp_clauses,
+					isl_id_copy(node->u.m.mark));
+	if (!options->omp_clauses)
+		p = isl_printer_free(p);
+	else
+		p = print_ast_node_c(p, node->u.m.node, options, 0, in_list);
+	isl_ast_print_options_free(options);
+
+	return p;
+}
+
 /* Print the "node" to "p".
  *
  * "in_block" is set if we are currently inside a block.
@@ -2368,6 +2959,8 @@ static __isl_give isl_printer *print_ast_node_c(__isl_take isl_printer *p,
 			p = end_block(p);
 		break;
 	case isl_ast_node_mark:
+		if (is_omp_clause_mark(node, options))
+			return print_omp_clause_mark(p, node, options, in_list);
 		p = isl_printer_start_line(p);
 		p = isl_printer_print_str(p, "// ");
 		p = isl_printer_print_str(p, isl_id_get_name(node->u.m.mark));
@@ -2804,9 +3397,7 @@ __isl_give char *isl_ast_expr_to_C_str(__isl_keep isl_ast_expr *expr)
 	p = isl_printer_set_output_format(p, ISL_FORMAT_C);
 	p = isl_printer_print_ast_expr(p, expr);
 
-	str = isl_printer_get_str(p);
-
-	isl_printer_free(p);
+	str = isl_printer_take_str(p);
 
 	return str;
 }
@@ -2825,9 +3416,7 @@ __isl_give char *isl_ast_node_to_C_str(__isl_keep isl_ast_node *node)
 	p = isl_printer_set_output_format(p, ISL_FORMAT_C);
 	p = isl_printer_print_ast_node(p, node);
 
-	str = isl_printer_get_str(p);
-
-	isl_printer_free(p);
+	str = isl_printer_take_str(p);
 
 	return str;
 }
@@ -10,7 +10,7 @@
  * B.P. 105 - 78153 Le Chesnay, France
  */
 
-#include <isl/id.h>
+#include <isl_id_private.h>
 #include <isl/val.h>
 #include <isl/space.h>
 #include <isl/map.h>
@@ -79,7 +79,8 @@ static __isl_give isl_ast_build *isl_ast_build_init_derived(
 
 	if (!build->iterators || !build->domain || !build->generated ||
 	    !build->pending || !build->values || !build->internal2input ||
-	    !build->strides || !build->offsets || !build->options)
+	    !build->strides || !build->offsets || !build->options ||
+	    !build->expr_cache)
 		return isl_ast_build_free(build);
 
 	return build;
@@ -134,6 +135,7 @@ __isl_give isl_ast_build *isl_ast_build_from_context(__isl_take isl_set *set)
 	build->generated = isl_set_copy(build->domain);
 	build->pending = isl_set_universe(isl_set_get_space(build->domain));
 	build->options = isl_union_map_empty(isl_space_params_alloc(ctx, 0));
+	build->expr_cache = isl_ast_build_expr_cache_alloc(ctx);
 	n = isl_set_dim(set, isl_dim_set);
 	build->depth = n;
 	build->iterators = isl_id_list_alloc(ctx, n);
@@ -177,6 +179,37 @@ __isl_give isl_ast_build *isl_ast_build_copy(__isl_keep isl_ast_build *build)
 	return build;
 }
 
+/* Apply the restrictions on build->generated that have been recorded
+ * by isl_ast_build_restrict_generated, but not yet applied.
+ * Each of them is intersected with build->generated in turn,
+ * followed by a coalescing of the result.
+ *
+ * Since this does not change the meaning of "build",
+ * it may also be performed on a shared "build".
+ */
+static isl_stat apply_generated_restrictions(__isl_keep isl_ast_build *build)
+{
+	int i, n;
+
+	if (!build)
+		return isl_stat_error;
+	if (!build->generated_restrictions)
+		return isl_stat_ok;
+
+	n = isl_set_list_n_set(build->generated_restrictions);
+	for (i = 0; i < n; ++i) {
+		isl_set *set;
+
+		set = isl_set_list_get_set(build->generated_restrictions, i);
+		build->generated = isl_set_intersect(build->generated, set);
+		build->generated = isl_set_coalesce(build->generated);
+	}
+	build->generated_restrictions =
+			isl_set_list_free(build->generated_restrictions);
+
+	return build->generated ? isl_stat_ok : isl_stat_error;
+}
+
 __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 {
 	isl_ctx *ctx;
@@ -196,6 +229,8 @@ __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 	dup->iterators = isl_id_list_copy(build->iterators);
 	dup->domain = isl_set_copy(build->domain);
 	dup->generated = isl_set_copy(build->generated);
+	dup->generated_restrictions =
+			isl_set_list_copy(build->generated_restrictions);
 	dup->pending = isl_set_copy(build->pending);
 	dup->values = isl_multi_aff_copy(build->values);
 	dup->internal2input = isl_multi_aff_copy(build->internal2input);
@@ -204,6 +239,7 @@ __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 	dup->offsets = isl_multi_aff_copy(build->offsets);
 	dup->executed = isl_union_map_copy(build->executed);
 	dup->single_valued = build->single_valued;
+	dup->dependences = isl_union_map_copy(build->dependences);
 	dup->options = isl_union_map_copy(build->options);
 	dup->at_each_domain = build->at_each_domain;
 	dup->at_each_domain_user = build->at_each_domain_user;
@@ -218,6 +254,9 @@ __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 	dup->create_leaf = build->create_leaf;
 	dup->create_leaf_user = build->create_leaf_user;
 	dup->node = isl_schedule_node_copy(build->node);
+	dup->expr_cache = isl_ast_build_expr_cache_copy(build->expr_cache);
+	dup->subtree_cache =
+		isl_ast_build_subtree_cache_copy(build->subtree_cache);
 	if (build->loop_type) {
 		int i;
 
@@ -229,12 +268,22 @@ __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 		for (i = 0; i < dup->n; ++i)
 			dup->loop_type[i] = build->loop_type[i];
 	}
+	if (build->coincident) {
+		int i;
+
+		dup->coincident = isl_alloc_array(ctx, int, build->n);
+		if (build->n && !dup->coincident)
+			return isl_ast_build_free(dup);
+		for (i = 0; i < build->n; ++i)
+			dup->coincident[i] = build->coincident[i];
+	}
 
 	if (!dup->iterators || !dup->domain || !dup->generated ||
 	    !dup->pending || !dup->values ||
 	    !dup->strides || !dup->offsets || !dup->options ||
 	    (build->internal2input && !dup->internal2input) ||
 	    (build->executed && !dup->executed) ||
+	    (build->dependences && !dup->dependences) ||
 	    (build->value && !dup->value) ||
 	    (build->node && !dup->node))
 		return isl_ast_build_free(dup);
@@ -249,7 +298,7 @@ __isl_give isl_ast_build *isl_ast_build_align_params(
 	__isl_take isl_ast_build *build, __isl_take isl_space *model)
 {
 	build = isl_ast_build_cow(build);
-	if (!build)
+	if (apply_generated_restrictions(build) < 0)
 		goto error;
 
 	build->domain = isl_set_align_params(build->domain,
@@ -307,6 +356,7 @@ __isl_null isl_ast_build *isl_ast_build_free(
 	isl_id_list_free(build->iterators);
 	isl_set_free(build->domain);
 	isl_set_free(build->generated);
+	isl_set_list_free(build->generated_restrictions);
 	isl_set_free(build->pending);
 	isl_multi_aff_free(build->values);
 	isl_multi_aff_free(build->internal2input);
@@ -315,10 +365,14 @@ __isl_null isl_ast_build *isl_ast_build_free(
 	isl_multi_aff_free(build->offsets);
 	isl_multi_aff_free(build->schedule_map);
 	isl_union_map_free(build->executed);
+	isl_union_map_free(build->dependences);
 	isl_union_map_free(build->options);
 	isl_schedule_node_free(build->node);
 	free(build->loop_type);
+	free(build->coincident);
 	isl_set_free(build->isolated);
+	isl_ast_build_expr_cache_free(build->expr_cache);
+	isl_ast_build_subtree_cache_free(build->subtree_cache);
 
 	free(build);
 
@@ -330,6 +384,108 @@ isl_ctx *isl_ast_build_get_ctx(__isl_keep isl_ast_build *build)
 	return build ? isl_set_get_ctx(build->domain) : NULL;
 }
 
+/* Are "ma1" and "ma2" obviously equal, where either may be NULL?
+ */
+static isl_bool multi_aff_plain_is_equal_or_null(__isl_keep isl_multi_aff *ma1,
+	__isl_keep isl_multi_aff *ma2)
+{
+	if (!ma1 || !ma2)
+		return ma1 == ma2;
+	return isl_multi_aff_plain_is_equal(ma1, ma2);
+}
+
+/* Are "build1" and "build2" obviously equal?
+ * That is, do they have the same callbacks and
+ * (obviously) the same values for all the fields that
+ * may affect AST generation?
+ *
+ * The fields that are computed on demand, the caches and
+ * the fields that are only set right before calling a callback
+ * are ignored.
+ * The schedule nodes and the dependences are only considered to be equal
+ * if they are both NULL or if they are the same object.
+ * The sets are compared last since they are the most expensive
+ * to compare.
+ */
+isl_bool isl_ast_build_plain_is_equal(__isl_keep isl_ast_build *build1,
+	__isl_keep isl_ast_build *build2)
+{
+	int i;
+	isl_bool equal;
+
+	if (!build1 || !build2)
+		return isl_bool_error;
+	if (build1 == build2)
+		return isl_bool_true;
+
+	if (build1->outer_pos != build2->outer_pos ||
+	    build1->depth != build2->depth ||
+	    build1->single_valued != build2->single_valued ||
+	    build1->node != build2->node || build1->n != build2->n ||
+	    build1->dependences != build2->dependences)
+		return isl_bool_false;
+	if (build1->at_each_domain != build2->at_each_domain ||
+	    build1->at_each_domain_user != build2->at_each_domain_user ||
+	    build1->before_each_for != build2->before_each_for ||
+	    build1->before_each_for_user != build2->before_each_for_user ||
+	    build1->after_each_for != build2->after_each_for ||
+	    build1->after_each_for_user != build2->after_each_for_user ||
+	    build1->before_each_mark != build2->before_each_mark ||
+	    build1->before_each_mark_user != build2->before_each_mark_user ||
+	    build1->after_each_mark != build2->after_each_mark ||
+	    build1->after_each_mark_user != build2->after_each_mark_user ||
+	    build1->create_leaf != build2->create_leaf ||
+	    build1->create_leaf_user != build2->create_leaf_user)
+		return isl_bool_false;
+	if (!build1->loop_type != !build2->loop_type)
+		return isl_bool_false;
+	for (i = 0; build1->loop_type && i < build1->n; ++i)
+		if (build1->loop_type[i] != build2->loop_type[i])
+			return isl_bool_false;
+	if (!build1->coincident != !build2->coincident)
+		return isl_bool_false;
+	for (i = 0; build1->coincident && i < build1->n; ++i)
+		if (build1->coincident[i] != build2->coincident[i])
+			return isl_bool_false;
+
+	equal = isl_id_list_plain_is_equal(build1->iterators, build2->iterators);
+	if (equal < 0 || !equal)
+		return equal;
+	equal = isl_vec_is_equal(build1->strides, build2->strides);
+	if (equal < 0 || !equal)
+		return equal;
+	equal = isl_multi_aff_plain_is_equal(build1->offsets, build2->offsets);
+	if (equal < 0 || !equal)
+		return equal;
+	equal = isl_multi_aff_plain_is_equal(build1->values, build2->values);
+	if (equal < 0 || !equal)
+		return equal;
+	equal = multi_aff_plain_is_equal_or_null(build1->internal2input,
+						build2->internal2input);
+	if (equal < 0 || !equal)
+		return equal;
+	if (!build1->value || !build2->value)
+		equal = build1->value == build2->value;
+	else
+		equal = isl_pw_aff_plain_is_equal(build1->value, build2->value);
+	if (equal < 0 || !equal)
+		return equal;
+	equal = isl_union_map_is_equal(build1->options, build2->options);
+	if (equal < 0 || !equal)
+		return equal;
+
+	if (apply_generated_restrictions(build1) < 0 ||
+	    apply_generated_restrictions(build2) < 0)
+		return isl_bool_error;
+	equal = isl_set_plain_is_equal(build1->domain, build2->domain);
+	if (equal < 0 || !equal)
+		return equal;
+	equal = isl_set_plain_is_equal(build1->generated, build2->generated);
+	if (equal < 0 || !equal)
+		return equal;
+	return isl_set_plain_is_equal(build1->pending, build2->pending);
+}
+
 /* Replace build->options by "options".
  */
 __isl_give isl_ast_build *isl_ast_build_set_options(
@@ -490,6 +646,61 @@ __isl_give isl_ast_build *isl_ast_build_set_create_leaf(
 	return build;
 }
 
+/* Enable or disable the reuse of parts of ASTs generated
+ * from schedule trees by subsequent calls to
+ * isl_ast_build_node_from_schedule on "build" (or builds derived from it)
+ * depending on the value of "reuse".
+ *
+ * If reuse is enabled, then the ASTs of subtrees of the schedule tree
+ * are kept in a cache that is shared by all builds derived from "build".
+ * Disabling reuse drops this cache.
+ */
+__isl_give isl_ast_build *isl_ast_build_set_subtree_reuse(
+	__isl_take isl_ast_build *build, int reuse)
+{
+	if (!build)
+		return NULL;
+	if (reuse == (build->subtree_cache != NULL))
+		return build;
+
+	build = isl_ast_build_cow(build);
+	if (!build)
+		return NULL;
+
+	if (reuse)
+		build->subtree_cache = isl_ast_build_subtree_cache_alloc(
+						isl_ast_build_get_ctx(build));
+	else
+		build->subtree_cache =
+			isl_ast_build_subtree_cache_free(build->subtree_cache);
+	if (reuse && !build->subtree_cache)
+		return isl_ast_build_free(build);
+
+	return build;
+}
+
+/* Set the dependences between the statement instances
+ * that should be taken into account when marking for nodes
+ * as being parallel to "dependences".
+ * See isl_ast_build_is_parallel.
+ */
+__isl_give isl_ast_build *isl_ast_build_set_dependences(
+	__isl_take isl_ast_build *build, __isl_take isl_union_map *dependences)
+{
+	build = isl_ast_build_cow(build);
+	if (!build || !dependences)
+		goto error;
+
+	isl_union_map_free(build->dependences);
+	build->dependences = dependences;
+
+	return build;
+error:
+	isl_ast_build_free(build);
+	isl_union_map_free(dependences);
+	return NULL;
+}
+
 /* Clear all information that is specific to this code generation
  * and that is (probably) not meaningful to any nested code generation.
  */
@@ -658,7 +869,7 @@ __isl_give isl_ast_build *isl_ast_build_increase_depth(
 
 void isl_ast_build_dump(__isl_keep isl_ast_build *build)
 {
-	if (!build)
+	if (apply_generated_restrictions(build) < 0)
 		return;
 
 	fprintf(stderr, "domain: ");
@@ -694,7 +905,7 @@ static __isl_give isl_ast_build *isl_ast_build_init(
 	isl_set *set;
 
 	build = isl_ast_build_cow(build);
-	if (!build)
+	if (apply_generated_restrictions(build) < 0)
 		goto error;
 
 	set = isl_set_universe(isl_space_copy(space));
@@ -889,7 +1100,7 @@ __isl_give isl_ast_build *isl_ast_build_set_pending_generated(
 	}
 
 	build = isl_ast_build_cow(build);
-	if (!build)
+	if (apply_generated_restrictions(build) < 0)
 		goto error;
 
 	pending = isl_basic_set_copy(bounds);
@@ -939,6 +1150,12 @@ error:
 
 /* Intersect build->generated and build->domain with "set",
  * where "set" is specified in terms of the internal schedule domain.
+ *
+ * The intersection with build->domain is performed immediately.
+ * The intersection with build->generated is only recorded here
+ * and only performed when build->generated is needed.
+ * In particular, the builds that are only used to construct
+ * AST expressions never look at build->generated.
  */
 __isl_give isl_ast_build *isl_ast_build_restrict_generated(
 	__isl_take isl_ast_build *build, __isl_take isl_set *set)
@@ -949,10 +1166,13 @@ __isl_give isl_ast_build *isl_ast_build_restrict_generated(
 	if (!build)
 		goto error;
 
-	build->generated = isl_set_intersect(build->generated, set);
-	build->generated = isl_set_coalesce(build->generated);
+	if (!build->generated_restrictions)
+		build->generated_restrictions =
+			isl_set_list_alloc(isl_ast_build_get_ctx(build), 1);
+	build->generated_restrictions =
+		isl_set_list_add(build->generated_restrictions, set);
 
-	if (!build->generated)
+	if (!build->generated_restrictions)
 		return isl_ast_build_free(build);
 
 	return build;
@@ -972,8 +1192,8 @@ __isl_give isl_ast_build *isl_ast_build_replace_pending_by_guard(
 {
 	build = isl_ast_build_restrict_generated(build, guard);
 	build = isl_ast_build_cow(build);
-	if (!build)
-		return NULL;
+	if (apply_generated_restrictions(build) < 0)
+		return isl_ast_build_free(build);
 
 	isl_set_free(build->domain);
 	build->domain = isl_set_copy(build->generated);
@@ -1042,8 +1262,9 @@ __isl_give isl_schedule_node *isl_ast_build_get_schedule_node(
 	return isl_schedule_node_copy(build->node);
 }
 
-/* Extract the loop AST generation types for the members of build->node
- * and store them in build->loop_type.
+/* Extract the loop AST generation types and the coincidence
+ * of the members of build->node and store them in build->loop_type and
+ * build->coincident.
  */
 static __isl_give isl_ast_build *extract_loop_types(
 	__isl_take isl_ast_build *build)
@@ -1060,15 +1281,25 @@ static __isl_give isl_ast_build *extract_loop_types(
 			return isl_ast_build_free(build));
 
 	free(build->loop_type);
+	free(build->coincident);
 	build->n = isl_schedule_node_band_n_member(build->node);
 	build->loop_type = isl_alloc_array(ctx,
 					    enum isl_ast_loop_type, build->n);
-	if (build->n && !build->loop_type)
+	build->coincident = isl_alloc_array(ctx, int, build->n);
+	if (build->n && (!build->loop_type || !build->coincident))
 		return isl_ast_build_free(build);
 	node = build->node;
-	for (i = 0; i < build->n; ++i)
+	for (i = 0; i < build->n; ++i) {
+		isl_bool coincident;
+
 		build->loop_type[i] =
 		    isl_schedule_node_band_member_get_ast_loop_type(node, i);
+		coincident = isl_schedule_node_band_member_get_coincident(node,
+									i);
+		if (coincident < 0)
+			return isl_ast_build_free(build);
+		build->coincident[i] = coincident;
+	}
 
 	return build;
 }
@@ -1131,7 +1362,9 @@ __isl_give isl_set *isl_ast_build_get_pending(
 __isl_give isl_set *isl_ast_build_get_generated(
 	__isl_keep isl_ast_build *build)
 {
-	return build ? isl_set_copy(build->generated) : NULL;
+	if (apply_generated_restrictions(build) < 0)
+		return NULL;
+	return isl_set_copy(build->generated);
 }
 
 /* Return a copy of the map from the internal schedule domain
@@ -1376,8 +1609,8 @@ __isl_give isl_ast_build *isl_ast_build_include_stride(
 	if (!isl_ast_build_has_stride(build, build->depth))
 		return build;
 	build = isl_ast_build_cow(build);
-	if (!build)
-		return NULL;
+	if (apply_generated_restrictions(build) < 0)
+		return isl_ast_build_free(build);
 
 	set = isl_ast_build_get_stride_constraint(build);
 
@@ -1568,7 +1801,7 @@ static __isl_give isl_union_map *options_insert_dim(
 }
 
 /* If we are generating an AST from a schedule tree (build->node is set),
- * then update the loop AST generation types
+ * then update the loop AST generation types and the coincidence
  * to reflect the insertion of a dimension at (global) position "pos"
  * in the schedule domain space.
  * We do not need to adjust any isolate option since we would not be inserting
@@ -1580,6 +1813,7 @@ static __isl_give isl_ast_build *node_insert_dim(
 	int i;
 	int local_pos;
 	enum isl_ast_loop_type *loop_type;
+	int *coincident;
 	isl_ctx *ctx;
 
 	build = isl_ast_build_cow(build);
@@ -1598,6 +1832,14 @@ static __isl_give isl_ast_build *node_insert_dim(
 	for (i = build->n - 1; i >= local_pos; --i)
 		loop_type[i + 1] = loop_type[i];
 	loop_type[local_pos] = isl_ast_loop_default;
+	coincident = isl_realloc_array(ctx, build->coincident,
+					int, build->n + 1);
+	if (!coincident)
+		return isl_ast_build_free(build);
+	build->coincident = coincident;
+	for (i = build->n - 1; i >= local_pos; --i)
+		coincident[i + 1] = coincident[i];
+	coincident[local_pos] = 0;
 	build->n++;
 
 	return build;
@@ -1630,8 +1872,8 @@ __isl_give isl_ast_build *isl_ast_build_insert_dim(
 	isl_multi_aff *ma;
 
 	build = isl_ast_build_cow(build);
-	if (!build)
-		return NULL;
+	if (apply_generated_restrictions(build) < 0)
+		return isl_ast_build_free(build);
 
 	ctx = isl_ast_build_get_ctx(build);
 	id = isl_id_alloc(ctx, "", NULL);
@@ -1823,7 +2065,7 @@ __isl_give isl_ast_build *isl_ast_build_product(
 	int dim, n_it;
 
 	build = isl_ast_build_cow(build);
-	if (!build)
+	if (apply_generated_restrictions(build) < 0)
 		goto error;
 
 	build->outer_pos = build->depth;
@@ -2240,6 +2482,129 @@ enum isl_ast_loop_type isl_ast_build_get_loop_type(
 							build->node, local_pos);
 }
 
+/* Is the current schedule dimension coincident?
+ * The coincidence has been extracted from the schedule node
+ * in extract_loop_types and stored in build->coincident.
+ * It has been updated to reflect any dimension insertion in
+ * node_insert_dim.
+ * If we are not generating an AST from a schedule tree,
+ * then no information about coincidence is available and
+ * the current schedule dimension is not considered to be coincident.
+ */
+isl_bool isl_ast_build_is_coincident(__isl_keep isl_ast_build *build)
+{
+	int local_pos;
+
+	if (!build)
+		return isl_bool_error;
+	if (!build->node)
+		return isl_bool_false;
+
+	local_pos = build->depth - build->outer_pos;
+	return build->coincident[local_pos];
+}
+
+/* Construct a relation between pairs of elements of the internal
+ * schedule domain of "build" that have the same values
+ * for the outer schedule dimensions and a different value
+ * for the current schedule dimension.
+ */
+static __isl_give isl_map *different_at_depth(__isl_keep isl_ast_build *build)
+{
+	int i, depth;
+	isl_space *space;
+	isl_map *map, *lt, *gt;
+
+	depth = isl_ast_build_get_depth(build);
+	space = isl_ast_build_get_space(build, 1);
+	map = isl_map_universe(isl_space_map_from_set(space));
+	for (i = 0; i < depth; ++i)
+		map = isl_map_equate(map, isl_dim_in, i, isl_dim_out, i);
+	lt = isl_map_order_lt(isl_map_copy(map),
+				isl_dim_in, depth, isl_dim_out, depth);
+	gt = isl_map_order_gt(map, isl_dim_in, depth, isl_dim_out, depth);
+
+	return isl_map_union(lt, gt);
+}
+
+/* Can the current schedule dimension of "build" take on
+ * more than one value for fixed values of the outer schedule dimensions
+ * within the domain of build->executed?
+ */
+static isl_bool has_multiple_iterations(__isl_keep isl_ast_build *build)
+{
+	isl_union_set *domain;
+	isl_union_map *pairs;
+	isl_bool empty;
+
+	domain = isl_union_map_domain(isl_union_map_copy(build->executed));
+	pairs = isl_union_map_from_map(different_at_depth(build));
+	pairs = isl_union_map_intersect_domain(pairs,
+						isl_union_set_copy(domain));
+	pairs = isl_union_map_intersect_range(pairs, domain);
+	empty = isl_union_map_is_empty(pairs);
+	isl_union_map_free(pairs);
+
+	return isl_bool_not(empty);
+}
+
+/* Is any of the dependences in build->dependences carried
+ * by the current schedule dimension?
+ * That is, are there any dependences between elements of the domain
+ * of build->executed that have the same values for the outer
+ * schedule dimensions, but a different value for the current
+ * schedule dimension?
+ * The dependences are mapped to the internal schedule domain
+ * through build->executed.
+ */
+static isl_bool carries_dependences(__isl_keep isl_ast_build *build)
+{
+	isl_union_map *executed, *dep;
+	isl_bool empty;
+
+	executed = isl_union_map_copy(build->executed);
+	dep = isl_union_map_apply_range(isl_union_map_copy(executed),
+				isl_union_map_copy(build->dependences));
+	dep = isl_union_map_apply_range(dep, isl_union_map_reverse(executed));
+	dep = isl_union_map_intersect(dep,
+			    isl_union_map_from_map(different_at_depth(build)));
+	empty = isl_union_map_is_empty(dep);
+	isl_union_map_free(dep);
+
+	return isl_bool_not(empty);
+}
+
+/* Can the iterations of the loop at the current schedule dimension
+ * of "build" be executed in parallel?
+ *
+ * The schedule dimension is only considered to be parallel
+ * if it was generated from a band member that is marked coincident,
+ * if the dependences have been set through isl_ast_build_set_dependences,
+ * if none of those dependences is carried by this dimension
+ * in the part of the schedule described by build->executed and
+ * if the dimension can take on more than one value for fixed values
+ * of the outer schedule dimensions.
+ * The coincident flag of the band member is not sufficient by itself
+ * since the scheduler only enforces it with respect to
+ * the coincidence constraints.  In particular, if no coincidence
+ * constraints are specified, then all band members are coincident.
+ */
+isl_bool isl_ast_build_is_parallel(__isl_keep isl_ast_build *build)
+{
+	isl_bool parallel;
+
+	parallel = isl_ast_build_is_coincident(build);
+	if (parallel < 0 || !parallel)
+		return parallel;
+	if (!build->dependences || !build->executed)
+		return isl_bool_false;
+
+	parallel = has_multiple_iterations(build);
+	if (parallel < 0 || !parallel)
+		return parallel;
+	return isl_bool_not(carries_dependences(build));
+}
+
 /* Extract the isolated set from the isolate option, if any,
  * and store in the build.
  * If there is no isolate option, then the isolated set is
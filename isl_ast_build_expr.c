@@ -10,11 +10,12 @@
  * B.P. 105 - 78153 Le Chesnay, France
  */
 
-#include <isl/id.h>
+#include <isl_id_private.h>
 #include <isl/space.h>
 #include <isl/constraint.h>
 #include <isl/ilp.h>
 #include <isl/val.h>
+#include <isl_ctx_private.h>
 #include <isl_ast_build_expr.h>
 #include <isl_ast_private.h>
 #include <isl_ast_build_private.h>
@@ -1486,6 +1487,221 @@ __isl_give isl_ast_expr *isl_ast_build_expr_from_basic_set(
 	return res;
 }
 
+/* The maximal number of AST expressions that are kept
+ * in an isl_ast_build_expr_cache.
+ */
+#define ISL_AST_BUILD_EXPR_CACHE_SIZE	64
+
+/* An AST expression "expr" that was constructed from "pa" or "set"
+ * (only one of which is not NULL) in the context of a build
+ * with domain "domain" and iterators "iterators",
+ * while the options that affect the result had values "options".
+ */
+struct isl_ast_build_expr_cache_entry {
+	int options;
+	isl_set *domain;
+	isl_id_list *iterators;
+	isl_pw_aff *pa;
+	isl_set *set;
+	isl_ast_expr *expr;
+};
+
+/* A cache of AST expressions, shared by all builds that are derived
+ * from the same initial build.
+ *
+ * The first "n" elements of "entries" are valid.
+ * Once the cache is full, the element at position "next"
+ * is the next one to be replaced.
+ */
+struct isl_ast_build_expr_cache {
+	int ref;
+
+	int n;
+	int next;
+	struct isl_ast_build_expr_cache_entry
+			entries[ISL_AST_BUILD_EXPR_CACHE_SIZE];
+};
+
+struct isl_ast_build_expr_cache *isl_ast_build_expr_cache_alloc(isl_ctx *ctx)
+{
+	struct isl_ast_build_expr_cache *cache;
+
+	cache = isl_calloc_type(ctx, struct isl_ast_build_expr_cache);
+	if (!cache)
+		return NULL;
+	cache->ref = 1;
+
+	return cache;
+}
+
+struct isl_ast_build_expr_cache *isl_ast_build_expr_cache_copy(
+	struct isl_ast_build_expr_cache *cache)
+{
+	if (!cache)
+		return NULL;
+
+	cache->ref++;
+	return cache;
+}
+
+/* Free the contents of "entry".
+ */
+static void expr_cache_entry_clear(
+	struct isl_ast_build_expr_cache_entry *entry)
+{
+	isl_set_free(entry->domain);
+	isl_id_list_free(entry->iterators);
+	isl_pw_aff_free(entry->pa);
+	isl_set_free(entry->set);
+	isl_ast_expr_free(entry->expr);
+}
+
+struct isl_ast_build_expr_cache *isl_ast_build_expr_cache_free(
+	struct isl_ast_build_expr_cache *cache)
+{
+	int i;
+
+	if (!cache)
+		return NULL;
+
+	if (--cache->ref > 0)
+		return NULL;
+
+	for (i = 0; i < cache->n; ++i)
+		expr_cache_entry_clear(&cache->entries[i]);
+	free(cache);
+
+	return NULL;
+}
+
+/* Return a bit vector representing the values of the options
+ * that affect the AST expressions constructed by
+ * isl_ast_build_expr_from_pw_aff_internal and
+ * isl_ast_build_expr_from_set_internal.
+ */
+static int expr_cache_options(isl_ctx *ctx)
+{
+	int options = 0;
+
+	if (isl_options_get_ast_build_prefer_pdiv(ctx))
+		options |= 1 << 0;
+	if (isl_options_get_ast_build_detect_min_max(ctx))
+		options |= 1 << 1;
+
+	return options;
+}
+
+/* Can "entry" be used in the context of "build"?
+ * That is, was it constructed under the same options
+ * in the context of a build with the same domain and iterators?
+ * The domain is compared last since it is the most expensive check.
+ */
+static isl_bool expr_cache_entry_matches_build(
+	struct isl_ast_build_expr_cache_entry *entry,
+	__isl_keep isl_ast_build *build, int options)
+{
+	isl_bool equal;
+
+	if (entry->options != options)
+		return isl_bool_false;
+	equal = isl_id_list_plain_is_equal(entry->iterators, build->iterators);
+	if (equal < 0 || !equal)
+		return equal;
+	return isl_set_plain_is_equal(entry->domain, build->domain);
+}
+
+/* Look for an AST expression constructed from "pa" or "set"
+ * (only one of which is not NULL) in the context of "build"
+ * in the cache of "build" and return it if it can be found.
+ * Return NULL otherwise.  In particular, errors are treated
+ * as cache misses.
+ * The AST expression is shared with the cache.
+ */
+static __isl_give isl_ast_expr *expr_cache_find(
+	__isl_keep isl_ast_build *build, __isl_keep isl_pw_aff *pa,
+	__isl_keep isl_set *set)
+{
+	int i, options;
+	struct isl_ast_build_expr_cache *cache = build->expr_cache;
+
+	if (!cache)
+		return NULL;
+
+	options = expr_cache_options(isl_ast_build_get_ctx(build));
+	for (i = 0; i < cache->n; ++i) {
+		struct isl_ast_build_expr_cache_entry *entry;
+		isl_bool equal;
+
+		entry = &cache->entries[i];
+		if (pa && entry->pa)
+			equal = isl_pw_aff_plain_is_equal(entry->pa, pa);
+		else if (set && entry->set)
+			equal = isl_set_plain_is_equal(entry->set, set);
+		else
+			equal = isl_bool_false;
+		if (equal >= 0 && equal)
+			equal = expr_cache_entry_matches_build(entry, build,
+								options);
+		if (equal < 0)
+			return NULL;
+		if (equal)
+			return isl_ast_expr_copy(entry->expr);
+	}
+
+	return NULL;
+}
+
+/* Store "expr" as the AST expression constructed from "pa" or "set"
+ * (only one of which is not NULL) in the context of "build"
+ * in the cache of "build".
+ * If the cache is full, then the oldest entry is replaced.
+ */
+static void expr_cache_add(__isl_keep isl_ast_build *build,
+	__isl_keep isl_pw_aff *pa, __isl_keep isl_set *set,
+	__isl_keep isl_ast_expr *expr)
+{
+	struct isl_ast_build_expr_cache *cache = build->expr_cache;
+	struct isl_ast_build_expr_cache_entry *entry;
+
+	if (!cache || !expr)
+		return;
+
+	if (cache->n < ISL_AST_BUILD_EXPR_CACHE_SIZE) {
+		entry = &cache->entries[cache->n++];
+	} else {
+		entry = &cache->entries[cache->next];
+		cache->next = (cache->next + 1) % ISL_AST_BUILD_EXPR_CACHE_SIZE;
+		expr_cache_entry_clear(entry);
+	}
+
+	entry->options = expr_cache_options(isl_ast_build_get_ctx(build));
+	entry->domain = isl_set_copy(build->domain);
+	entry->iterators = isl_id_list_copy(build->iterators);
+	entry->pa = isl_pw_aff_copy(pa);
+	entry->set = isl_set_copy(set);
+	entry->expr = isl_ast_expr_copy(expr);
+}
+
+/* Return the number of AST expressions that were found
+ * in the cache of the isl_ast_build in which they were constructed.
+ */
+int isl_ctx_get_ast_expr_cache_hits(isl_ctx *ctx)
+{
+	if (!ctx)
+		return -1;
+	return ctx->ast_expr_cache_hits;
+}
+
+/* Return the number of AST expressions that were not found
+ * in the cache of the isl_ast_build in which they were constructed.
+ */
+int isl_ctx_get_ast_expr_cache_misses(isl_ctx *ctx)
+{
+	if (!ctx)
+		return -1;
+	return ctx->ast_expr_cache_misses;
+}
+
 /* Construct an isl_ast_expr that evaluates the conditions defining "set".
  * The result is simplified in terms of build->domain.
  *
@@ -1507,7 +1723,7 @@ __isl_give isl_ast_expr *isl_ast_build_expr_from_basic_set(
  *
  * "set" lives in the internal schedule space.
  */
-__isl_give isl_ast_expr *isl_ast_build_expr_from_set_internal(
+static __isl_give isl_ast_expr *expr_from_set(
 	__isl_keep isl_ast_build *build, __isl_take isl_set *set)
 {
 	int i, n;
@@ -1555,6 +1771,42 @@ __isl_give isl_ast_expr *isl_ast_build_expr_from_set_internal(
 	return res;
 }
 
+/* Construct an isl_ast_expr that evaluates the conditions defining "set".
+ * The result is simplified in terms of build->domain.
+ *
+ * The same guards are typically constructed several times
+ * in the context of builds with the same domain (e.g., in unrolled code),
+ * so keep track of the previously constructed expressions.
+ *
+ * "set" lives in the internal schedule space.
+ */
+__isl_give isl_ast_expr *isl_ast_build_expr_from_set_internal(
+	__isl_keep isl_ast_build *build, __isl_take isl_set *set)
+{
+	isl_ctx *ctx;
+	isl_ast_expr *res;
+
+	if (!build || !set)
+		goto error;
+
+	ctx = isl_ast_build_get_ctx(build);
+	res = expr_cache_find(build, NULL, set);
+	if (res) {
+		ctx->ast_expr_cache_hits++;
+		isl_set_free(set);
+		return res;
+	}
+	ctx->ast_expr_cache_misses++;
+
+	res = expr_from_set(build, isl_set_copy(set));
+	expr_cache_add(build, NULL, set, res);
+	isl_set_free(set);
+	return res;
+error:
+	isl_set_free(set);
+	return NULL;
+}
+
 /* Construct an isl_ast_expr that evaluates the conditions defining "set".
  * The result is simplified in terms of build->domain.
  *
@@ -2168,11 +2420,16 @@ error:
 /* Construct an isl_ast_expr that evaluates "pa".
  * The result is simplified in terms of build->domain.
  *
+ * The same (simplified) loop bounds are typically constructed
+ * several times in the context of builds with the same domain,
+ * so keep track of the previously constructed expressions.
+ *
  * The domain of "pa" lives in the internal schedule space.
  */
 __isl_give isl_ast_expr *isl_ast_build_expr_from_pw_aff_internal(
 	__isl_keep isl_ast_build *build, __isl_take isl_pw_aff *pa)
 {
+	isl_ctx *ctx;
 	struct isl_from_pw_aff_data data = { NULL };
 	isl_ast_expr *res = NULL;
 
@@ -2181,12 +2438,22 @@ __isl_give isl_ast_expr *isl_ast_build_expr_from_pw_aff_internal(
 	if (!pa)
 		return NULL;
 
+	ctx = isl_pw_aff_get_ctx(pa);
+	res = expr_cache_find(build, pa, NULL);
+	if (res) {
+		ctx->ast_expr_cache_hits++;
+		isl_pw_aff_free(pa);
+		return res;
+	}
+	ctx->ast_expr_cache_misses++;
+
 	if (isl_from_pw_aff_data_init(&data, build, pa) < 0)
 		goto error;
 	set_none(&data);
 
 	if (isl_pw_aff_foreach_piece(pa, &ast_expr_from_pw_aff, &data) >= 0)
 		res = build_pieces(&data);
+	expr_cache_add(build, pa, NULL, res);
 
 	isl_pw_aff_free(pa);
 	isl_from_pw_aff_data_clear(&data);
@@ -43,6 +43,13 @@
  * constraints that were either given by the user or that have
  * effectively been generated (as bounds on a for loop).
  *
+ * "generated_restrictions" contains the sets by which "generated"
+ * still needs to be restricted (in order).  It is NULL if there are none.
+ * These restrictions are only applied when "generated" is actually needed.
+ * "generated" is the only field that is updated lazily.
+ * All other fields, including "strides", "values" and "internal2input",
+ * are updated as soon as the corresponding change is made.
+ *
  * "pending" is a superset of "domain" corresponding to the constraints
  * that still need to be generated (as guards), but that may end up
  * not getting generated if they are implied by any constraints
@@ -122,6 +129,10 @@
  * in turn only used by user code from within a callback.
  * The value is set right before we may be calling such a callback.
  *
+ * "dependences" contains the dependences between statement instances
+ * that are used to check whether a loop can be marked parallel.
+ * It is NULL if no dependences have been set.
+ *
  * "single_valued" is set if the current inverse schedule (which may or may
  * not be stored in "executed") is known to be single valued, specifically
  * an inverse schedule that was not (appeared not to be) single valued
@@ -138,9 +149,27 @@
  * a schedule dimension is inserted.
  * It is NULL if "node" is NULL.
  *
+ * "coincident" similarly contains the coincidence of the "n" members
+ * of "node" and it is updated along with "loop_type".
+ * Inserted schedule dimensions are not considered to be coincident.
+ * It is NULL if "node" is NULL.
+ *
  * "isolated" is the piece of the schedule domain isolated by the isolate
  * option on the current band.  This set may be NULL if we have not checked
  * for the isolate option yet.
+ *
+ * "expr_cache" keeps track of AST expressions that were constructed
+ * from loop bounds and guards in the context of this build.
+ * It is shared by all builds derived from the same initial build,
+ * so that the same expressions can be reused in different parts
+ * of the generated AST.  See isl_ast_build_expr.c.
+ *
+ * "subtree_cache" keeps track of the ASTs generated for subtrees
+ * of a schedule tree, such that they can be reused when
+ * an AST is generated for a modified version of the schedule tree.
+ * It is NULL if such reuse has not been enabled.
+ * Like "expr_cache", it is shared by all builds derived from
+ * the same initial build.  See isl_ast_codegen.c.
  */
 struct isl_ast_build {
 	int ref;
@@ -152,6 +181,7 @@ struct isl_ast_build {
 
 	isl_set *domain;
 	isl_set *generated;
+	isl_set_list *generated_restrictions;
 	isl_set *pending;
 	isl_multi_aff *values;
 
@@ -191,12 +221,17 @@ struct isl_ast_build {
 	void *create_leaf_user;
 
 	isl_union_map *executed;
+	isl_union_map *dependences;
 	int single_valued;
 
 	isl_schedule_node *node;
 	int n;
 	enum isl_ast_loop_type *loop_type;
+	int *coincident;
 	isl_set *isolated;
+
+	struct isl_ast_build_expr_cache *expr_cache;
+	struct isl_ast_build_subtree_cache *subtree_cache;
 };
 
 __isl_give isl_ast_build *isl_ast_build_clear_local_info(
@@ -210,6 +245,21 @@ __isl_give isl_space *isl_ast_build_get_space(
 	__isl_keep isl_ast_build *build, int internal);
 __isl_give isl_ast_build *isl_ast_build_align_params(
 	__isl_take isl_ast_build *build, __isl_take isl_space *model);
+struct isl_ast_build_expr_cache *isl_ast_build_expr_cache_alloc(
+	isl_ctx *ctx);
+struct isl_ast_build_expr_cache *isl_ast_build_expr_cache_copy(
+	struct isl_ast_build_expr_cache *cache);
+struct isl_ast_build_expr_cache *isl_ast_build_expr_cache_free(
+	struct isl_ast_build_expr_cache *cache);
+struct isl_ast_build_subtree_cache *isl_ast_build_subtree_cache_alloc(
+	isl_ctx *ctx);
+struct isl_ast_build_subtree_cache *isl_ast_build_subtree_cache_copy(
+	struct isl_ast_build_subtree_cache *cache);
+struct isl_ast_build_subtree_cache *isl_ast_build_subtree_cache_free(
+	struct isl_ast_build_subtree_cache *cache);
+isl_bool isl_ast_build_plain_is_equal(__isl_keep isl_ast_build *build1,
+	__isl_keep isl_ast_build *build2);
+
 __isl_give isl_ast_build *isl_ast_build_cow(
 	__isl_take isl_ast_build *build);
 __isl_give isl_ast_build *isl_ast_build_insert_dim(
@@ -319,6 +369,8 @@ __isl_give isl_set *isl_ast_build_eliminate_divs(
 
 enum isl_ast_loop_type isl_ast_build_get_loop_type(
 	__isl_keep isl_ast_build *build, int isolated);
+isl_bool isl_ast_build_is_coincident(__isl_keep isl_ast_build *build);
+isl_bool isl_ast_build_is_parallel(__isl_keep isl_ast_build *build);
 
 __isl_give isl_map *isl_ast_build_map_to_iterator(
 	__isl_keep isl_ast_build *build, __isl_take isl_set *set);
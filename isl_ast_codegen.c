@@ -27,6 +27,8 @@
 #include <isl_ast_build_expr.h>
 #include <isl_ast_build_private.h>
 #include <isl_ast_graft_private.h>
+#include <isl_schedule_node_private.h>
+#include <isl_schedule_tree.h>
 
 /* Data used in generate_domain.
  *
@@ -1321,6 +1323,9 @@ static __isl_give isl_ast_graft *refine_generic(
 /* Create a for node for the current level.
  *
  * Mark the for node degenerate if "degenerate" is set.
+ * Otherwise, mark it coincident if the iterations of the loop
+ * at the current schedule dimension can be executed in parallel.
+ * See isl_ast_build_is_parallel.
  */
 static __isl_give isl_ast_node *create_for(__isl_keep isl_ast_build *build,
 	int degenerate)
@@ -1328,6 +1333,7 @@ static __isl_give isl_ast_node *create_for(__isl_keep isl_ast_build *build,
 	int depth;
 	isl_id *id;
 	isl_ast_node *node;
+	isl_bool coincident;
 
 	if (!build)
 		return NULL;
@@ -1336,7 +1342,13 @@ static __isl_give isl_ast_node *create_for(__isl_keep isl_ast_build *build,
 	id = isl_ast_build_get_iterator_id(build, depth);
 	node = isl_ast_node_alloc_for(id);
 	if (degenerate)
-		node = isl_ast_node_for_mark_degenerate(node);
+		return isl_ast_node_for_mark_degenerate(node);
+
+	coincident = isl_ast_build_is_parallel(build);
+	if (coincident < 0)
+		return isl_ast_node_free(node);
+	if (coincident)
+		node = isl_ast_node_for_mark_coincident(node);
 
 	return node;
 }
@@ -2547,6 +2559,75 @@ error:
 	return isl_aff_free(data.lower);
 }
 
+/* Call "fn" on each of the "n" iterations of the current dimension
+ * of "domain", where "domain" consists of a single basic set,
+ * taking the slices in closed form.
+ * "domain" and "lower" are expressed in terms of the stride expanded
+ * iterator i', while "expansion" (and the corresponding "bmap")
+ * maps i' back to the original iterator i.
+ *
+ * Since "domain" consists of a single basic set, the slices
+ * at the different offsets are simply translates of each other
+ * and each of them is already a single basic set.
+ * Instead of slicing "domain" at each offset in terms of i'
+ * and then mapping the result back to i, "domain" is mapped back once
+ * and the slicing constraint
+ *
+ *	i' = l(j) + k
+ *
+ * is translated once into the constraint
+ *
+ *	i = s l(j) + offset(j) + s k
+ *
+ * on i.  Each iteration then only involves instantiating this
+ * constraint at the offset k and adding it to the mapped domain.
+ */
+static int foreach_iteration_closed_form(__isl_keep isl_set *domain,
+	__isl_keep isl_multi_aff *expansion, __isl_keep isl_basic_map *bmap,
+	int depth, __isl_keep isl_aff *lower, int n,
+	int (*fn)(__isl_take isl_basic_set *bset, void *user), void *user)
+{
+	int i;
+	isl_space *space;
+	isl_multi_aff *ma;
+	isl_basic_set *bset;
+	isl_aff *start;
+	isl_val *stride;
+
+	bset = isl_set_unshifted_simple_hull(isl_set_copy(domain));
+	bset = isl_basic_set_apply(bset, isl_basic_map_copy(bmap));
+	space = isl_space_map_from_set(isl_aff_get_domain_space(lower));
+	ma = isl_multi_aff_identity(space);
+	ma = isl_multi_aff_set_aff(ma, depth, isl_aff_copy(lower));
+	start = isl_multi_aff_get_aff(expansion, depth);
+	stride = isl_aff_get_coefficient_val(start, isl_dim_in, depth);
+	start = isl_aff_pullback_multi_aff(start, ma);
+	start = isl_aff_add_coefficient_si(start, isl_dim_in, depth, -1);
+	if (!bset || !start || !stride)
+		n = -1;
+
+	for (i = 0; i < n; ++i) {
+		isl_aff *aff;
+		isl_val *offset;
+		isl_basic_set *slice;
+
+		offset = isl_val_mul_ui(isl_val_copy(stride), i);
+		aff = isl_aff_add_constant_val(isl_aff_copy(start), offset);
+		slice = isl_basic_set_copy(bset);
+		slice = isl_basic_set_add_constraint(slice,
+						isl_equality_from_aff(aff));
+
+		if (fn(slice, user) < 0)
+			break;
+	}
+
+	isl_val_free(stride);
+	isl_aff_free(start);
+	isl_basic_set_free(bset);
+
+	return n < 0 || i < n ? -1 : 0;
+}
+
 /* Call "fn" on each iteration of the current dimension of "domain".
  * If "init" is not NULL, then it is called with the number of
  * iterations before any call to "fn".
@@ -2579,6 +2660,10 @@ error:
  * atomic option.
  *
  * Finally, we map i' back to i and call "fn".
+ *
+ * If "domain" consists of a single basic set, then the slices
+ * are computed in closed form by foreach_iteration_closed_form instead,
+ * avoiding a separate polyhedral computation for each offset.
  */
 static int foreach_iteration(__isl_take isl_set *domain,
 	__isl_keep isl_ast_build *build, int (*init)(int n, void *user),
@@ -2587,6 +2672,7 @@ static int foreach_iteration(__isl_take isl_set *domain,
 	int i, n;
 	int empty;
 	int depth;
+	int closed;
 	isl_multi_aff *expansion;
 	isl_basic_map *bmap;
 	isl_aff *lower = NULL;
@@ -2606,7 +2692,7 @@ static int foreach_iteration(__isl_take isl_set *domain,
 	domain = isl_ast_build_eliminate_divs(stride_build, domain);
 	isl_ast_build_free(stride_build);
 
-	bmap = isl_basic_map_from_multi_aff(expansion);
+	bmap = isl_basic_map_from_multi_aff(isl_multi_aff_copy(expansion));
 
 	empty = isl_set_is_empty(domain);
 	if (empty < 0) {
@@ -2620,7 +2706,11 @@ static int foreach_iteration(__isl_take isl_set *domain,
 	}
 	if (n >= 0 && init && init(n, user) < 0)
 		n = -1;
-	for (i = 0; i < n; ++i) {
+	closed = n > 0 && isl_set_n_basic_set(domain) == 1;
+	if (closed && foreach_iteration_closed_form(domain, expansion, bmap,
+						depth, lower, n, fn, user) < 0)
+		n = -1;
+	for (i = 0; !closed && i < n; ++i) {
 		isl_set *set;
 		isl_basic_set *bset;
 		isl_constraint *slice;
@@ -2639,8 +2729,9 @@ static int foreach_iteration(__isl_take isl_set *domain,
 	isl_aff_free(lower);
 	isl_set_free(domain);
 	isl_basic_map_free(bmap);
+	isl_multi_aff_free(expansion);
 
-	return n < 0 || i < n ? -1 : 0;
+	return n < 0 || (!closed && i < n) ? -1 : 0;
 }
 
 /* Data structure for storing the results and the intermediate objects
@@ -2905,6 +2996,10 @@ static int compute_separate_domain(struct isl_codegen_domains *domains,
  *
  * We first make sure that the class domain is disjoint from
  * previously considered class domains.
+ * The union of those previously considered class domains is coalesced
+ * after each addition.  Since the classes are considered in order,
+ * neighbouring class domains then typically get merged, such that
+ * the cost of the subtraction does not grow with the number of classes.
  *
  * The separate domains can be computed directly from the "class_domain".
  *
@@ -2942,6 +3037,7 @@ static isl_stat compute_partial_domains(struct isl_codegen_domains *domains,
 					isl_set_copy(domains->done));
 	domains->done = isl_set_union(domains->done,
 					isl_set_copy(class_domain));
+	domains->done = isl_set_coalesce(domains->done);
 
 	class_domain = compute_atomic_domain(domains, class_domain);
 	class_domain = compute_unroll_domains(domains, class_domain);
@@ -2974,23 +3070,108 @@ error:
 	return isl_stat_error;
 }
 
+/* Internal data structure for class_candidates.
+ *
+ * "pnt" is the separation class under consideration.
+ * "res" collects the basic maps that may map to "pnt".
+ */
+struct isl_class_candidates_data {
+	isl_point *pnt;
+	isl_map *res;
+};
+
+/* Is "bmap" obviously disjoint from the separation class data->pnt,
+ * i.e., does it assign a fixed value to some class coordinate
+ * that is different from the corresponding coordinate of data->pnt?
+ */
+static isl_bool class_is_obviously_different(__isl_keep isl_basic_map *bmap,
+	struct isl_class_candidates_data *data)
+{
+	int i, n;
+	isl_bool different = isl_bool_false;
+
+	n = isl_basic_map_dim(bmap, isl_dim_out);
+	for (i = 0; !different && i < n; ++i) {
+		isl_val *v, *c;
+
+		v = isl_basic_map_plain_get_val_if_fixed(bmap, isl_dim_out, i);
+		if (!v)
+			return isl_bool_error;
+		if (isl_val_is_nan(v)) {
+			isl_val_free(v);
+			continue;
+		}
+		c = isl_point_get_coordinate_val(data->pnt, isl_dim_set, i);
+		different = isl_val_ne(v, c);
+		isl_val_free(v);
+		isl_val_free(c);
+	}
+
+	return different;
+}
+
+/* Add "bmap" to data->res, unless it is obviously disjoint
+ * from the separation class data->pnt.
+ */
+static isl_stat add_class_candidate(__isl_take isl_basic_map *bmap,
+	void *user)
+{
+	struct isl_class_candidates_data *data = user;
+	isl_bool different;
+
+	different = class_is_obviously_different(bmap, data);
+	if (different < 0 || different) {
+		isl_basic_map_free(bmap);
+		return different < 0 ? isl_stat_error : isl_stat_ok;
+	}
+
+	data->res = isl_map_union(data->res, isl_map_from_basic_map(bmap));
+	return isl_stat_ok;
+}
+
+/* Return the basic maps of "sep_class" that may map to
+ * the separation class "pnt".
+ *
+ * Typically, each basic map of "sep_class" maps to a single
+ * separation class, so that most of them can be discarded
+ * by simply comparing the fixed values of the class coordinates,
+ * avoiding an intersection of every basic map with every class.
+ * The order of the remaining basic maps is preserved.
+ */
+static __isl_give isl_map *class_candidates(__isl_keep isl_map *sep_class,
+	__isl_keep isl_point *pnt)
+{
+	struct isl_class_candidates_data data;
+
+	data.pnt = pnt;
+	data.res = isl_map_empty(isl_map_get_space(sep_class));
+	if (isl_map_foreach_basic_map(sep_class,
+				&add_class_candidate, &data) < 0)
+		data.res = isl_map_free(data.res);
+
+	return data.res;
+}
+
 /* Split up the domain at the current depth into disjoint
  * basic sets for which code should be generated separately
  * for the separation class identified by "pnt".
  *
  * We extract the corresponding class domain from domains->sep_class,
  * eliminate inner dimensions and pass control to compute_partial_domains.
+ * Only the basic maps of domains->sep_class that may map to "pnt"
+ * are intersected with "pnt".
  */
 static isl_stat compute_class_domains(__isl_take isl_point *pnt, void *user)
 {
 	struct isl_codegen_domains *domains = user;
+	isl_map *sep_class;
 	isl_set *class_set;
 	isl_set *domain;
 	int disjoint;
 
+	sep_class = class_candidates(domains->sep_class, pnt);
 	class_set = isl_set_from_point(pnt);
-	domain = isl_map_domain(isl_map_intersect_range(
-				isl_map_copy(domains->sep_class), class_set));
+	domain = isl_map_domain(isl_map_intersect_range(sep_class, class_set));
 	domain = isl_ast_build_compute_gist(domains->build, domain);
 	domain = isl_ast_build_eliminate(domains->build, domain);
 
@@ -5430,7 +5611,7 @@ static __isl_give isl_ast_graft_list *build_ast_from_guard(
 	guard = isl_set_preimage_multi_aff(guard,
 			isl_multi_aff_copy(build->internal2input));
 	guard = isl_ast_build_specialize(build, guard);
-	guard = isl_set_gist(guard, isl_set_copy(build->generated));
+	guard = isl_set_gist(guard, isl_ast_build_get_generated(build));
 
 	sub_build = isl_ast_build_copy(build);
 	sub_build = isl_ast_build_restrict_generated(sub_build,
@@ -5542,6 +5723,307 @@ static __isl_give isl_ast_graft_list *build_ast_from_schedule_node(
 	__isl_take isl_ast_build *build, __isl_take isl_schedule_node *node,
 	__isl_take isl_union_map *executed);
 
+/* A graft list "list" that was generated for the schedule tree "tree"
+ * in the context of "build" and "executed",
+ * while the options that affect the result had values "options".
+ * "round" is the last round of AST generation in which the entry
+ * was either created or used.
+ */
+struct isl_ast_build_subtree_cache_entry {
+	int round;
+	int options;
+	isl_schedule_tree *tree;
+	isl_ast_build *build;
+	isl_union_map *executed;
+	isl_ast_graft_list *list;
+};
+
+/* A cache of graft lists generated for subtrees of schedule trees,
+ * shared by all builds that are derived from the same initial build.
+ *
+ * "round" is the current round of AST generation.
+ * A new round is started by each call to isl_ast_build_node_from_schedule
+ * (or isl_ast_build_foreach_node_from_schedule).
+ * Only the entries that were created or used in the previous round
+ * are kept when a new round is started.
+ *
+ * The first "n" elements of "entries" are valid.
+ * "size" is the number of elements for which memory has been allocated.
+ */
+struct isl_ast_build_subtree_cache {
+	int ref;
+	isl_ctx *ctx;
+
+	int round;
+	int n;
+	int size;
+	struct isl_ast_build_subtree_cache_entry *entries;
+};
+
+struct isl_ast_build_subtree_cache *isl_ast_build_subtree_cache_alloc(
+	isl_ctx *ctx)
+{
+	struct isl_ast_build_subtree_cache *cache;
+
+	cache = isl_calloc_type(ctx, struct isl_ast_build_subtree_cache);
+	if (!cache)
+		return NULL;
+	cache->ref = 1;
+	cache->ctx = ctx;
+	isl_ctx_ref(ctx);
+
+	return cache;
+}
+
+struct isl_ast_build_subtree_cache *isl_ast_build_subtree_cache_copy(
+	struct isl_ast_build_subtree_cache *cache)
+{
+	if (!cache)
+		return NULL;
+
+	cache->ref++;
+	return cache;
+}
+
+/* Free the contents of "entry".
+ */
+static void subtree_cache_entry_clear(
+	struct isl_ast_build_subtree_cache_entry *entry)
+{
+	isl_schedule_tree_free(entry->tree);
+	isl_ast_build_free(entry->build);
+	isl_union_map_free(entry->executed);
+	isl_ast_graft_list_free(entry->list);
+}
+
+struct isl_ast_build_subtree_cache *isl_ast_build_subtree_cache_free(
+	struct isl_ast_build_subtree_cache *cache)
+{
+	int i;
+
+	if (!cache)
+		return NULL;
+
+	if (--cache->ref > 0)
+		return NULL;
+
+	for (i = 0; i < cache->n; ++i)
+		subtree_cache_entry_clear(&cache->entries[i]);
+	free(cache->entries);
+	isl_ctx_deref(cache->ctx);
+	free(cache);
+
+	return NULL;
+}
+
+/* Start a new round of AST generation using the subtree cache
+ * of "build", if any.
+ * Drop all entries that were not created or used in the previous round.
+ */
+static void subtree_cache_next_round(__isl_keep isl_ast_build *build)
+{
+	int i, n;
+	struct isl_ast_build_subtree_cache *cache;
+
+	if (!build || !build->subtree_cache)
+		return;
+
+	cache = build->subtree_cache;
+	n = 0;
+	for (i = 0; i < cache->n; ++i) {
+		if (cache->entries[i].round < cache->round) {
+			subtree_cache_entry_clear(&cache->entries[i]);
+			continue;
+		}
+		cache->entries[n++] = cache->entries[i];
+	}
+	cache->n = n;
+	cache->round++;
+}
+
+/* Return a bit vector representing the values of the options
+ * that affect the generated AST.
+ */
+static int subtree_cache_options(isl_ctx *ctx)
+{
+	int options = 0;
+
+	if (isl_options_get_ast_build_atomic_upper_bound(ctx))
+		options |= 1 << 0;
+	if (isl_options_get_ast_build_prefer_pdiv(ctx))
+		options |= 1 << 1;
+	if (isl_options_get_ast_build_detect_min_max(ctx))
+		options |= 1 << 2;
+	if (isl_options_get_ast_build_exploit_nested_bounds(ctx))
+		options |= 1 << 3;
+	if (isl_options_get_ast_build_group_coscheduled(ctx))
+		options |= 1 << 4;
+	if (isl_options_get_ast_build_scale_strides(ctx))
+		options |= 1 << 5;
+	if (isl_options_get_ast_build_allow_else(ctx))
+		options |= 1 << 6;
+	if (isl_options_get_ast_build_allow_or(ctx))
+		options |= 1 << 7;
+	options |= isl_options_get_ast_build_separation_bounds(ctx) << 8;
+
+	return options;
+}
+
+/* Does "map" (obviously) appear in the union map "user"?
+ */
+static isl_bool map_plain_appears_in(__isl_keep isl_map *map, void *user)
+{
+	isl_union_map *umap = user;
+	isl_map *map2;
+	isl_bool equal;
+
+	map2 = isl_union_map_extract_map(umap, isl_map_get_space(map));
+	equal = isl_map_plain_is_equal(map, map2);
+	isl_map_free(map2);
+
+	return equal;
+}
+
+/* Are "umap1" and "umap2" obviously equal?
+ */
+static isl_bool union_map_plain_is_equal(__isl_keep isl_union_map *umap1,
+	__isl_keep isl_union_map *umap2)
+{
+	if (!umap1 || !umap2)
+		return isl_bool_error;
+	if (umap1 == umap2)
+		return isl_bool_true;
+	if (isl_union_map_n_map(umap1) != isl_union_map_n_map(umap2))
+		return isl_bool_false;
+	return isl_union_map_every_map(umap1, &map_plain_appears_in, umap2);
+}
+
+/* Look for a graft list generated for the subtree rooted at "node"
+ * in the context of "build" and "executed" in the subtree cache of "build"
+ * and return a copy if it can be found.
+ * Return NULL otherwise.  In particular, errors are treated
+ * as cache misses.
+ *
+ * The schedule trees are compared by identity.  Since the cache
+ * holds a reference to the schedule tree in each of its entries,
+ * a schedule tree can only be identical to one of these schedule trees
+ * if it is the very same (unmodified) tree.
+ * A copy of the graft list is returned because grafts are modified in place.
+ */
+static __isl_give isl_ast_graft_list *subtree_cache_find(
+	__isl_keep isl_ast_build *build, __isl_keep isl_schedule_node *node,
+	__isl_keep isl_union_map *executed)
+{
+	int i, options;
+	struct isl_ast_build_subtree_cache *cache = build->subtree_cache;
+
+	options = subtree_cache_options(isl_ast_build_get_ctx(build));
+	for (i = 0; i < cache->n; ++i) {
+		struct isl_ast_build_subtree_cache_entry *entry;
+		isl_bool equal;
+
+		entry = &cache->entries[i];
+		if (entry->tree != node->tree || entry->options != options)
+			continue;
+		equal = isl_ast_build_plain_is_equal(entry->build, build);
+		if (equal >= 0 && equal)
+			equal = union_map_plain_is_equal(entry->executed,
+							executed);
+		if (equal < 0)
+			return NULL;
+		if (!equal)
+			continue;
+		entry->round = cache->round;
+		return isl_ast_graft_list_dup_grafts(entry->list);
+	}
+
+	return NULL;
+}
+
+/* Store "list" as the graft list generated for the subtree rooted
+ * at "node" in the context of "build" and "executed"
+ * in the subtree cache of "build".
+ *
+ * The build is stored without its subtree cache
+ * to avoid a reference cycle.
+ * A copy of "list" is stored because grafts are modified in place.
+ * Failure to store the graft list is not considered to be an error.
+ */
+static void subtree_cache_add(__isl_keep isl_ast_build *build,
+	__isl_keep isl_schedule_node *node, __isl_keep isl_union_map *executed,
+	__isl_keep isl_ast_graft_list *list)
+{
+	struct isl_ast_build_subtree_cache *cache = build->subtree_cache;
+	struct isl_ast_build_subtree_cache_entry *entry;
+	isl_ast_build *stored;
+
+	if (!list)
+		return;
+
+	if (cache->n >= cache->size) {
+		struct isl_ast_build_subtree_cache_entry *entries;
+		int size = 2 * cache->size + 8;
+
+		entries = isl_realloc_array(cache->ctx, cache->entries,
+			    struct isl_ast_build_subtree_cache_entry, size);
+		if (!entries)
+			return;
+		cache->entries = entries;
+		cache->size = size;
+	}
+
+	stored = isl_ast_build_cow(isl_ast_build_copy(build));
+	if (!stored)
+		return;
+	stored->subtree_cache =
+		isl_ast_build_subtree_cache_free(stored->subtree_cache);
+
+	entry = &cache->entries[cache->n++];
+	entry->round = cache->round;
+	entry->options = subtree_cache_options(cache->ctx);
+	entry->tree = isl_schedule_tree_copy(node->tree);
+	entry->build = stored;
+	entry->executed = isl_union_map_copy(executed);
+	entry->list = isl_ast_graft_list_dup_grafts(list);
+}
+
+/* Generate an AST that visits the elements in the domain of "executed"
+ * in the relative order specified by the child "child" of a sequence
+ * (or set) node and its descendants.
+ *
+ * The relation "executed" maps the outer generated loop iterators
+ * to the domain elements executed by those iterations.
+ *
+ * If reuse has been enabled on "build", then first look for
+ * a graft list generated for the same subtree in the same context
+ * in the current or the previous round of AST generation.
+ * If no such graft list can be found, then the newly generated
+ * graft list is stored for use in the next round.
+ */
+static __isl_give isl_ast_graft_list *build_ast_from_sequence_child(
+	__isl_take isl_ast_build *build, __isl_take isl_schedule_node *child,
+	__isl_take isl_union_map *executed)
+{
+	isl_ast_graft_list *list;
+
+	if (!build || !child || !executed || !build->subtree_cache)
+		return build_ast_from_schedule_node(build, child, executed);
+
+	list = subtree_cache_find(build, child, executed);
+	if (!list) {
+		list = build_ast_from_schedule_node(isl_ast_build_copy(build),
+			    isl_schedule_node_copy(child),
+			    isl_union_map_copy(executed));
+		subtree_cache_add(build, child, executed, list);
+	}
+
+	isl_ast_build_free(build);
+	isl_schedule_node_free(child);
+	isl_union_map_free(executed);
+
+	return list;
+}
+
 /* Generate an AST that visits the elements in the domain of "executed"
  * in the relative order specified by the sequence (or set) node "node" and
  * its descendants.
@@ -5569,7 +6051,8 @@ static __isl_give isl_ast_graft_list *build_ast_from_sequence(
 		isl_ast_graft_list *list_i;
 
 		child = isl_schedule_node_get_child(node, i);
-		list_i = build_ast_from_schedule_node(isl_ast_build_copy(build),
+		list_i = build_ast_from_sequence_child(
+					isl_ast_build_copy(build),
 					child, isl_union_map_copy(executed));
 		list = isl_ast_graft_list_concat(list, list_i);
 	}
@@ -5660,8 +6143,11 @@ static __isl_give isl_ast_graft_list *build_ast_from_child(
 	return build_ast_from_schedule_node(build, node, executed);
 }
 
-/* Generate an AST that visits the elements in the domain of the domain
- * node "node" in the relative order specified by its descendants.
+/* Prepare for generating an AST that visits the elements in the domain
+ * of the domain node "node" in the relative order specified
+ * by its descendants.
+ * Return the updated build and store the initial inverse schedule
+ * in "executed".
  *
  * An initial inverse schedule is created that maps a zero-dimensional
  * schedule space to the node domain.
@@ -5675,30 +6161,30 @@ static __isl_give isl_ast_graft_list *build_ast_from_child(
  * more disjuncts than necessary.  We therefore approximate
  * the constraints on the parameters by a single disjunct set.
  */
-static __isl_give isl_ast_node *build_ast_from_domain(
-	__isl_take isl_ast_build *build, __isl_take isl_schedule_node *node)
+static __isl_give isl_ast_build *init_from_domain(
+	__isl_take isl_ast_build *build, __isl_keep isl_schedule_node *node,
+	__isl_give isl_union_map **executed)
 {
 	isl_ctx *ctx;
 	isl_union_set *domain, *schedule_domain;
-	isl_union_map *executed;
 	isl_space *space;
 	isl_set *set;
-	isl_ast_graft_list *list;
-	isl_ast_node *ast;
 	int is_params;
 
+	*executed = NULL;
 	if (!build)
-		goto error;
+		return NULL;
 
 	ctx = isl_ast_build_get_ctx(build);
 	space = isl_ast_build_get_space(build, 1);
 	is_params = isl_space_is_params(space);
 	isl_space_free(space);
 	if (is_params < 0)
-		goto error;
+		return isl_ast_build_free(build);
 	if (!is_params)
 		isl_die(ctx, isl_error_unsupported,
-			"expecting parametric initial context", goto error);
+			"expecting parametric initial context",
+			return isl_ast_build_free(build));
 
 	domain = isl_schedule_node_domain_get_domain(node);
 	domain = isl_union_set_coalesce(domain);
@@ -5711,7 +6197,28 @@ static __isl_give isl_ast_node *build_ast_from_domain(
 	set = isl_set_from_basic_set(isl_set_simple_hull(set));
 	schedule_domain = isl_union_set_from_set(set);
 
-	executed = isl_union_map_from_domain_and_range(schedule_domain, domain);
+	*executed = isl_union_map_from_domain_and_range(schedule_domain,
+							domain);
+	if (!*executed)
+		return isl_ast_build_free(build);
+
+	return build;
+}
+
+/* Generate an AST that visits the elements in the domain of the domain
+ * node "node" in the relative order specified by its descendants.
+ */
+static __isl_give isl_ast_node *build_ast_from_domain(
+	__isl_take isl_ast_build *build, __isl_take isl_schedule_node *node)
+{
+	isl_union_map *executed;
+	isl_ast_graft_list *list;
+	isl_ast_node *ast;
+
+	build = init_from_domain(build, node, &executed);
+	if (!build)
+		goto error;
+
 	list = build_ast_from_child(isl_ast_build_copy(build), node, executed);
 	ast = isl_ast_node_from_graft_list(list, build);
 	isl_ast_build_free(build);
@@ -5749,6 +6256,7 @@ __isl_give isl_ast_node *isl_ast_build_node_from_schedule(
 		goto error;
 	isl_schedule_free(schedule);
 
+	subtree_cache_next_round(build);
 	build = isl_ast_build_copy(build);
 	build = isl_ast_build_set_single_valued(build, 0);
 	if (isl_schedule_node_get_type(node) != isl_schedule_node_domain)
@@ -5760,3 +6268,496 @@ error:
 	isl_schedule_free(schedule);
 	return NULL;
 }
+
+/* Convert the graft list "list" to an AST node and call "fn" on it,
+ * unless the list is empty.
+ */
+static isl_stat emit_graft_list(__isl_take isl_ast_graft_list *list,
+	__isl_keep isl_ast_build *build,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user)
+{
+	int n;
+	isl_ast_node *node;
+
+	n = isl_ast_graft_list_n_ast_graft(list);
+	if (n <= 0) {
+		isl_ast_graft_list_free(list);
+		return n < 0 ? isl_stat_error : isl_stat_ok;
+	}
+
+	node = isl_ast_node_from_graft_list(list, build);
+	if (!node)
+		return isl_stat_error;
+	return fn(node, user);
+}
+
+/* Generate ASTs that together visit the elements in the domain
+ * of the domain node "node" in the relative order specified
+ * by its descendants and call "fn" on each of them.
+ *
+ * If the child of the domain node is a sequence or set node,
+ * then an AST is generated for each of its children and
+ * passed to "fn" as soon as it has been generated.
+ * The ASTs of the children are therefore never all kept in memory
+ * at the same time.
+ * Otherwise, "fn" is called on a single AST.
+ */
+static isl_stat foreach_ast_from_domain(__isl_take isl_ast_build *build,
+	__isl_take isl_schedule_node *node,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user)
+{
+	enum isl_schedule_node_type type;
+	isl_union_map *executed;
+	isl_ast_graft_list *list;
+	isl_stat r = isl_stat_ok;
+	int i, n;
+
+	build = init_from_domain(build, node, &executed);
+	node = isl_schedule_node_child(node, 0);
+	type = isl_schedule_node_get_type(node);
+	if (!build || type == isl_schedule_node_error)
+		goto error;
+
+	if (type != isl_schedule_node_sequence &&
+	    type != isl_schedule_node_set) {
+		list = build_ast_from_schedule_node(isl_ast_build_copy(build),
+							node, executed);
+		r = emit_graft_list(list, build, fn, user);
+		isl_ast_build_free(build);
+		return r;
+	}
+
+	n = isl_schedule_node_n_children(node);
+	for (i = 0; r >= 0 && i < n; ++i) {
+		isl_schedule_node *child;
+
+		child = isl_schedule_node_get_child(node, i);
+		list = build_ast_from_sequence_child(isl_ast_build_copy(build),
+					child, isl_union_map_copy(executed));
+		r = emit_graft_list(list, build, fn, user);
+	}
+
+	isl_union_map_free(executed);
+	isl_schedule_node_free(node);
+	isl_ast_build_free(build);
+
+	return r;
+error:
+	isl_union_map_free(executed);
+	isl_schedule_node_free(node);
+	isl_ast_build_free(build);
+	return isl_stat_error;
+}
+
+/* Generate ASTs that together visit the elements in the domain
+ * of "schedule" in the relative order specified by the schedule tree and
+ * call "fn" on each of them, in the order in which they should
+ * be executed.
+ *
+ * This is the same as isl_ast_build_node_from_schedule,
+ * except that if the root domain node has a sequence or set node
+ * as child, then the AST of each of the children of that node
+ * is passed to "fn" as soon as it has been generated
+ * instead of combining them into a single block node.
+ */
+isl_stat isl_ast_build_foreach_node_from_schedule(
+	__isl_keep isl_ast_build *build, __isl_take isl_schedule *schedule,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user)
+{
+	isl_ctx *ctx;
+	isl_schedule_node *node;
+
+	if (!build || !schedule || !fn)
+		goto error;
+
+	ctx = isl_ast_build_get_ctx(build);
+
+	node = isl_schedule_get_root(schedule);
+	isl_schedule_free(schedule);
+	if (!node)
+		return isl_stat_error;
+
+	if (isl_schedule_node_get_type(node) != isl_schedule_node_domain) {
+		isl_schedule_node_free(node);
+		isl_die(ctx, isl_error_unsupported,
+			"expecting root domain node", return isl_stat_error);
+	}
+
+	subtree_cache_next_round(build);
+	build = isl_ast_build_copy(build);
+	build = isl_ast_build_set_single_valued(build, 0);
+	return foreach_ast_from_domain(build, node, fn, user);
+error:
+	isl_schedule_free(schedule);
+	return isl_stat_error;
+}
+
+/* Data used in merge_versions.
+ *
+ * "guards" contains the AST expressions of the conditions
+ * under which the different versions should be executed.
+ * If "unconditional" is set, then the last version is executed
+ * whenever none of the others is and "guards" does not
+ * contain an expression for that version.
+ */
+struct isl_ast_version_data {
+	isl_ast_expr_list *guards;
+	int unconditional;
+};
+
+/* Construct an AST that executes the AST at position "i" of "nodes"
+ * when the corresponding guard in "data" holds and
+ * none of the guards of earlier versions hold.
+ * That is, construct a chain of if nodes with else branches.
+ */
+static __isl_give isl_ast_node *dispatch_versions(
+	__isl_take isl_ast_node_list *nodes, struct isl_ast_version_data *data)
+{
+	int i, n;
+	isl_ast_node *res = NULL;
+
+	n = isl_ast_node_list_n_ast_node(nodes);
+	for (i = n - 1; i >= 0; --i) {
+		isl_ast_expr *guard;
+		isl_ast_node *node, *if_node;
+
+		node = isl_ast_node_list_get_ast_node(nodes, i);
+		if (i == n - 1 && data->unconditional) {
+			res = node;
+			continue;
+		}
+		guard = isl_ast_expr_list_get_ast_expr(data->guards, i);
+		if_node = isl_ast_node_alloc_if(guard);
+		if_node = isl_ast_node_if_set_then(if_node, node);
+		if (res)
+			if_node = isl_ast_node_if_set_else(if_node, res);
+		res = if_node;
+	}
+	isl_ast_node_list_free(nodes);
+
+	return res;
+}
+
+static __isl_give isl_ast_node *merge_versions(
+	__isl_take isl_ast_node_list *nodes, struct isl_ast_version_data *data);
+
+/* Given a list "nodes" of versions of an AST node with
+ * obviously equal headers, extract the child at position "pos"
+ * of each of the versions and merge them into a single AST.
+ * For block nodes, "pos" refers to the position in the list of children.
+ * For if nodes, position 0 refers to the then branch and
+ * position 1 to the else branch.
+ * Other nodes only have a single child.
+ */
+static __isl_give isl_ast_node *merge_version_children(
+	__isl_keep isl_ast_node_list *nodes, int pos,
+	struct isl_ast_version_data *data)
+{
+	int i, n;
+	isl_ctx *ctx;
+	isl_ast_node_list *children;
+
+	ctx = isl_ast_node_list_get_ctx(nodes);
+	n = isl_ast_node_list_n_ast_node(nodes);
+	children = isl_ast_node_list_alloc(ctx, n);
+	for (i = 0; i < n; ++i) {
+		isl_ast_node *node, *child;
+
+		node = isl_ast_node_list_get_ast_node(nodes, i);
+		if (!node) {
+			isl_ast_node_list_free(children);
+			return NULL;
+		}
+		switch (node->type) {
+		case isl_ast_node_for:
+			child = isl_ast_node_copy(node->u.f.body);
+			break;
+		case isl_ast_node_if:
+			child = isl_ast_node_copy(pos == 0 ? node->u.i.then :
+							node->u.i.else_node);
+			break;
+		case isl_ast_node_block:
+			child = isl_ast_node_list_get_ast_node(
+						node->u.b.children, pos);
+			break;
+		case isl_ast_node_mark:
+			child = isl_ast_node_copy(node->u.m.node);
+			break;
+		default:
+			child = NULL;
+			break;
+		}
+		isl_ast_node_free(node);
+		children = isl_ast_node_list_add(children, child);
+	}
+
+	return merge_versions(children, data);
+}
+
+/* Replace the AST node "node" by the newly constructed "res",
+ * keeping the annotation of "node", if any.
+ */
+static __isl_give isl_ast_node *replace_version_node(
+	__isl_take isl_ast_node *node, __isl_take isl_ast_node *res)
+{
+	if (res && node->annotation)
+		res = isl_ast_node_set_annotation(res,
+						isl_id_copy(node->annotation));
+	isl_ast_node_free(node);
+	return res;
+}
+
+/* Given a list "nodes" of versions of an AST node with
+ * obviously equal headers, construct a single AST node with
+ * the same header and children that are obtained by merging
+ * the corresponding children of the versions.
+ */
+static __isl_give isl_ast_node *merge_version_headers(
+	__isl_take isl_ast_node_list *nodes, struct isl_ast_version_data *data)
+{
+	int i, n;
+	isl_ctx *ctx;
+	isl_ast_node *node, *child, *res;
+	isl_ast_node_list *children;
+
+	node = isl_ast_node_list_get_ast_node(nodes, 0);
+	if (!node)
+		goto error;
+
+	switch (node->type) {
+	case isl_ast_node_for:
+		child = merge_version_children(nodes, 0, data);
+		node = isl_ast_node_for_set_body(node, child);
+		break;
+	case isl_ast_node_if:
+		child = merge_version_children(nodes, 0, data);
+		node = isl_ast_node_if_set_then(node, child);
+		if (!node || !node->u.i.else_node)
+			break;
+		child = merge_version_children(nodes, 1, data);
+		node = isl_ast_node_if_set_else(node, child);
+		break;
+	case isl_ast_node_block:
+		ctx = isl_ast_node_get_ctx(node);
+		n = isl_ast_node_list_n_ast_node(node->u.b.children);
+		children = isl_ast_node_list_alloc(ctx, n);
+		for (i = 0; i < n; ++i) {
+			child = merge_version_children(nodes, i, data);
+			children = isl_ast_node_list_add(children, child);
+		}
+		res = isl_ast_node_alloc_block(children);
+		node = replace_version_node(node, res);
+		break;
+	case isl_ast_node_mark:
+		child = merge_version_children(nodes, 0, data);
+		res = isl_ast_node_alloc_mark(isl_id_copy(node->u.m.mark),
+						child);
+		node = replace_version_node(node, res);
+		break;
+	default:
+		isl_die(isl_ast_node_get_ctx(node), isl_error_internal,
+			"unexpected node type", node = isl_ast_node_free(node));
+	}
+
+	isl_ast_node_list_free(nodes);
+	return node;
+error:
+	isl_ast_node_list_free(nodes);
+	return NULL;
+}
+
+/* Merge the versions "nodes" of an AST into a single AST
+ * that selects the version to execute based on the guards in "data"
+ * only at the point where the versions diverge.
+ *
+ * If all versions are obviously equal, then the first one is returned.
+ * If they all have obviously equal headers, then the children
+ * are merged recursively.  Note that this is only the case
+ * for user nodes if they are also obviously equal.
+ * Otherwise, the versions diverge at this point and a dispatch
+ * between them is constructed.
+ * Since the guards only involve the parameters, it is safe
+ * to evaluate them inside the common outer loops.
+ */
+static __isl_give isl_ast_node *merge_versions(
+	__isl_take isl_ast_node_list *nodes, struct isl_ast_version_data *data)
+{
+	int i, n;
+	isl_ast_node *first;
+	isl_bool equal = isl_bool_true, header = isl_bool_true;
+
+	n = isl_ast_node_list_n_ast_node(nodes);
+	first = isl_ast_node_list_get_ast_node(nodes, 0);
+	for (i = 1; equal == isl_bool_true && i < n; ++i) {
+		isl_ast_node *node;
+
+		node = isl_ast_node_list_get_ast_node(nodes, i);
+		equal = isl_ast_node_plain_is_equal(first, node);
+		isl_ast_node_free(node);
+	}
+	for (i = 1; !equal && header == isl_bool_true && i < n; ++i) {
+		isl_ast_node *node;
+
+		node = isl_ast_node_list_get_ast_node(nodes, i);
+		header = isl_ast_node_plain_has_equal_header(first, node);
+		isl_ast_node_free(node);
+	}
+
+	if (!first || equal < 0 || header < 0) {
+		isl_ast_node_free(first);
+		isl_ast_node_list_free(nodes);
+		return NULL;
+	}
+	if (equal) {
+		isl_ast_node_list_free(nodes);
+		return first;
+	}
+	isl_ast_node_free(first);
+	if (header)
+		return merge_version_headers(nodes, data);
+	return dispatch_versions(nodes, data);
+}
+
+/* Generate a single AST that executes the version of the code
+ * generated from the schedule at position i of "schedules"
+ * if the parametric condition at position i of "conditions" holds and
+ * none of the conditions at earlier positions hold.
+ *
+ * If a condition is obviously satisfied, then the versions
+ * at later positions are never executed and are therefore
+ * not generated.
+ * All versions are generated from the same copy of "build",
+ * restricted to the union of the conditions of the generated versions,
+ * with subtree reuse enabled on this copy.
+ * Since the build is the same for all versions, the ASTs of subtrees
+ * that are shared by consecutive schedules are only generated once.
+ * Restricting the build to the individual conditions would allow
+ * each version to be simplified with respect to its own condition,
+ * but it would also prevent any such reuse.
+ * The guards are constructed in the context of the original "build".
+ * The ASTs of the different versions are then merged such that
+ * they share the outer parts that are obviously equal and
+ * only dispatch between the versions where they diverge.
+ */
+__isl_give isl_ast_node *isl_ast_build_node_from_schedule_list(
+	__isl_keep isl_ast_build *build, __isl_take isl_schedule_list *schedules,
+	__isl_take isl_set_list *conditions)
+{
+	int i, n;
+	isl_ctx *ctx;
+	isl_set *context;
+	isl_ast_node *node;
+	isl_ast_node_list *nodes;
+	struct isl_ast_version_data data = { NULL, 0 };
+
+	if (!build || !schedules || !conditions)
+		goto error;
+
+	ctx = isl_ast_build_get_ctx(build);
+	n = isl_schedule_list_n_schedule(schedules);
+	if (n != isl_set_list_n_set(conditions))
+		isl_die(ctx, isl_error_invalid,
+			"number of schedules and conditions do not match",
+			goto error);
+	if (n == 0)
+		isl_die(ctx, isl_error_invalid, "expecting at least one schedule",
+			goto error);
+
+	data.guards = isl_ast_expr_list_alloc(ctx, n);
+	for (i = 0; !data.unconditional && i < n; ++i) {
+		isl_set *cond;
+		isl_bool universe;
+
+		cond = isl_set_list_get_set(conditions, i);
+		universe = isl_set_plain_is_universe(cond);
+		if (universe < 0)
+			data.guards = isl_ast_expr_list_free(data.guards);
+		else if (universe)
+			data.unconditional = 1;
+		else
+			data.guards = isl_ast_expr_list_add(data.guards,
+			    isl_ast_build_expr_from_set(build,
+							isl_set_copy(cond)));
+		context = i == 0 ? cond : isl_set_union(context, cond);
+	}
+	n = i;
+
+	build = isl_ast_build_copy(build);
+	build = isl_ast_build_restrict(build, context);
+	build = isl_ast_build_set_subtree_reuse(build, 1);
+	nodes = isl_ast_node_list_alloc(ctx, n);
+	for (i = 0; i < n; ++i) {
+		isl_schedule *schedule;
+
+		schedule = isl_schedule_list_get_schedule(schedules, i);
+		node = isl_ast_build_node_from_schedule(build, schedule);
+		nodes = isl_ast_node_list_add(nodes, node);
+	}
+	isl_ast_build_free(build);
+	isl_schedule_list_free(schedules);
+	isl_set_list_free(conditions);
+
+	if (!nodes || !data.guards) {
+		isl_ast_node_list_free(nodes);
+		isl_ast_expr_list_free(data.guards);
+		return NULL;
+	}
+	node = merge_versions(nodes, &data);
+	isl_ast_expr_list_free(data.guards);
+
+	return node;
+error:
+	isl_schedule_list_free(schedules);
+	isl_set_list_free(conditions);
+	return NULL;
+}
+
+/* Data used in print_ast_node.
+ *
+ * "p" is the printer to which the ASTs are printed.
+ * "options" are the print options.
+ */
+struct isl_ast_print_stream_data {
+	isl_printer *p;
+	isl_ast_print_options *options;
+};
+
+/* Print "node" to data->p and free it.
+ */
+static isl_stat print_ast_node(__isl_take isl_ast_node *node, void *user)
+{
+	struct isl_ast_print_stream_data *data = user;
+	isl_ast_print_options *options;
+
+	options = isl_ast_print_options_copy(data->options);
+	data->p = isl_ast_node_print(node, data->p, options);
+	isl_ast_node_free(node);
+
+	return data->p ? isl_stat_ok : isl_stat_error;
+}
+
+/* Generate C code that visits the elements in the domain of "schedule"
+ * in the relative order specified by the schedule tree and
+ * print it to "p" using the print options "options".
+ *
+ * The code is printed while it is being generated, using
+ * isl_ast_build_foreach_node_from_schedule.
+ * In particular, the ASTs of the children of an outer sequence node
+ * are printed and freed one at a time.
+ * As in isl_ast_node_print, no macro definitions are printed.
+ */
+__isl_give isl_printer *isl_ast_build_print_from_schedule(
+	__isl_keep isl_ast_build *build, __isl_take isl_schedule *schedule,
+	__isl_take isl_printer *p, __isl_take isl_ast_print_options *options)
+{
+	struct isl_ast_print_stream_data data = { p, options };
+
+	if (!p || !options)
+		schedule = isl_schedule_free(schedule);
+	if (isl_ast_build_foreach_node_from_schedule(build, schedule,
+						&print_ast_node, &data) < 0)
+		data.p = isl_printer_free(data.p);
+	isl_ast_print_options_free(options);
+
+	return data.p;
+}
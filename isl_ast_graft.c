@@ -99,6 +99,62 @@ static __isl_give isl_ast_graft *isl_ast_graft_copy(
 	return graft;
 }
 
+/* Return a fresh copy of "graft" that shares the AST node,
+ * the guard and the enforced constraints of "graft", but that
+ * can be modified without affecting "graft".
+ */
+static __isl_give isl_ast_graft *isl_ast_graft_dup(
+	__isl_keep isl_ast_graft *graft)
+{
+	isl_ctx *ctx;
+	isl_ast_graft *dup;
+
+	if (!graft)
+		return NULL;
+
+	ctx = isl_ast_graft_get_ctx(graft);
+	dup = isl_calloc_type(ctx, isl_ast_graft);
+	if (!dup)
+		return NULL;
+
+	dup->ref = 1;
+	dup->node = isl_ast_node_copy(graft->node);
+	dup->guard = isl_set_copy(graft->guard);
+	dup->enforced = isl_basic_set_copy(graft->enforced);
+
+	if (!dup->node || !dup->guard || !dup->enforced)
+		return isl_ast_graft_free(dup);
+
+	return dup;
+}
+
+/* Return a copy of "list" in which each of the grafts
+ * has been replaced by a fresh copy.
+ * Since grafts are modified in place, the result can be used
+ * and modified independently of "list".
+ */
+__isl_give isl_ast_graft_list *isl_ast_graft_list_dup_grafts(
+	__isl_keep isl_ast_graft_list *list)
+{
+	int i, n;
+	isl_ast_graft_list *dup;
+
+	if (!list)
+		return NULL;
+
+	n = isl_ast_graft_list_n_ast_graft(list);
+	dup = isl_ast_graft_list_alloc(isl_ast_graft_list_get_ctx(list), n);
+	for (i = 0; i < n; ++i) {
+		isl_ast_graft *graft;
+
+		graft = isl_ast_graft_list_get_ast_graft(list, i);
+		dup = isl_ast_graft_list_add(dup, isl_ast_graft_dup(graft));
+		isl_ast_graft_free(graft);
+	}
+
+	return dup;
+}
+
 /* Do all the grafts in "list" have the same guard and is this guard
  * independent of the current depth?
  */
@@ -979,18 +1035,30 @@ error:
 /* Represent the graft list as an AST node.
  * This operation drops the information about guards in the grafts, so
  * if there are any pending guards, then they are materialized as if nodes.
+ *
+ * Since this function is only called on the final result
+ * of AST generation, this is also where structurally identical
+ * expressions are made to share storage,
+ * if the ast_build_share_exprs option is set.
  */
 __isl_give isl_ast_node *isl_ast_node_from_graft_list(
 	__isl_take isl_ast_graft_list *list,
 	__isl_keep isl_ast_build *build)
 {
+	isl_ctx *ctx;
 	isl_ast_node_list *node_list;
+	isl_ast_node *node;
 
 	list = insert_pending_guard_nodes(list, build);
 	node_list = extract_node_list(list);
 	isl_ast_graft_list_free(list);
 
-	return isl_ast_node_from_ast_node_list(node_list);
+	node = isl_ast_node_from_ast_node_list(node_list);
+	ctx = isl_ast_node_get_ctx(node);
+	if (ctx && isl_options_get_ast_build_share_exprs(ctx))
+		node = isl_ast_node_share_exprs(node);
+
+	return node;
 }
 
 void *isl_ast_graft_free(__isl_take isl_ast_graft *graft)
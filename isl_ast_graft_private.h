@@ -79,6 +79,9 @@ __isl_give isl_ast_graft *isl_ast_graft_enforce(
 __isl_give isl_ast_graft *isl_ast_graft_insert_mark(
 	__isl_take isl_ast_graft *graft, __isl_take isl_id *mark);
 
+__isl_give isl_ast_graft_list *isl_ast_graft_list_dup_grafts(
+	__isl_keep isl_ast_graft_list *list);
+
 __isl_give isl_ast_graft_list *isl_ast_graft_list_unembed(
 	__isl_take isl_ast_graft_list *list, int product);
 __isl_give isl_ast_graft_list *isl_ast_graft_list_preimage_multi_aff(
@@ -67,6 +67,7 @@ struct isl_ast_node {
 		} i;
 		struct {
 			unsigned degenerate : 1;
+			unsigned coincident : 1;
 			isl_ast_expr *iterator;
 			isl_ast_expr *init;
 			isl_ast_expr *cond;
@@ -88,6 +89,8 @@ struct isl_ast_node {
 __isl_give isl_ast_node *isl_ast_node_alloc_for(__isl_take isl_id *id);
 __isl_give isl_ast_node *isl_ast_node_for_mark_degenerate(
 	__isl_take isl_ast_node *node);
+__isl_give isl_ast_node *isl_ast_node_for_mark_coincident(
+	__isl_take isl_ast_node *node);
 __isl_give isl_ast_node *isl_ast_node_alloc_if(__isl_take isl_ast_expr *guard);
 __isl_give isl_ast_node *isl_ast_node_alloc_block(
 	__isl_take isl_ast_node_list *list);
@@ -95,10 +98,18 @@ __isl_give isl_ast_node *isl_ast_node_alloc_mark(__isl_take isl_id *id,
 	__isl_take isl_ast_node *node);
 __isl_give isl_ast_node *isl_ast_node_from_ast_node_list(
 	__isl_take isl_ast_node_list *list);
+__isl_give isl_ast_node *isl_ast_node_share_exprs(
+	__isl_take isl_ast_node *node);
 __isl_give isl_ast_node *isl_ast_node_for_set_body(
 	__isl_take isl_ast_node *node, __isl_take isl_ast_node *body);
 __isl_give isl_ast_node *isl_ast_node_if_set_then(
 	__isl_take isl_ast_node *node, __isl_take isl_ast_node *child);
+__isl_give isl_ast_node *isl_ast_node_if_set_else(
+	__isl_take isl_ast_node *node, __isl_take isl_ast_node *child);
+isl_bool isl_ast_node_plain_has_equal_header(__isl_keep isl_ast_node *node1,
+	__isl_keep isl_ast_node *node2);
+isl_bool isl_ast_node_plain_is_equal(__isl_keep isl_ast_node *node1,
+	__isl_keep isl_ast_node *node2);
 
 struct isl_ast_print_options {
 	int ref;
@@ -112,6 +123,9 @@ struct isl_ast_print_options {
 		__isl_take isl_ast_print_options *options,
 		__isl_keep isl_ast_node *node, void *user);
 	void *print_user_user;
+
+	int in_omp_parallel;
+	isl_id_list *omp_clauses;
 };
 
 __isl_give isl_printer *isl_ast_node_list_print(
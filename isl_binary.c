@@ -0,0 +1,1115 @@
+/*
+ * Use of this software is governed by the MIT license
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <isl_ctx_private.h>
+#include <isl_map_private.h>
+#include <isl_space_private.h>
+#include <isl_local_space_private.h>
+#include <isl_aff_private.h>
+#include <isl_mat_private.h>
+#include <isl_vec_private.h>
+#include <isl_printer_private.h>
+#include <isl_stream_private.h>
+#include <isl_binary_private.h>
+#include <isl/union_map.h>
+#include <isl/union_set.h>
+#include <isl_seq.h>
+
+#include <bset_to_bmap.c>
+#include <bset_from_bmap.c>
+#include <set_to_map.c>
+#include <set_from_map.c>
+#include <uset_to_umap.c>
+#include <uset_from_umap.c>
+
+/* This file implements a compact encoding of isl objects that
+ * is much cheaper to write and to read back than the textual isl format.
+ *
+ * An encoded object starts with the character '`', followed by
+ * the version of the encoding (ISL_BINARY_VERSION) and
+ * a character identifying the type of the object.
+ * The remainder of the encoding consists of unsigned integers,
+ * (arbitrary precision) integers and strings.
+ *
+ * An unsigned integer is encoded in groups of 5 bits,
+ * starting with the least significant group.
+ * Each group is encoded as a single character
+ * in the range '?' to '~', where bit 5 of the offset with respect to '?'
+ * is set if more groups follow.
+ * An integer that fits in 61 bits is encoded as twice its zigzag encoding.
+ * Any other integer is encoded as an unsigned integer 2 n + 1,
+ * followed by the n characters of its decimal representation.
+ * A string is encoded as its length plus one, followed by its characters,
+ * while a NULL string is encoded as 0.
+ *
+ * In particular, the encoding only uses printable characters such that
+ * the result can be stored in a string, e.g., using isl_printer_to_str.
+ *
+ * Identifiers are encoded by their names only, as in the textual format.
+ * The constraints of basic maps are stored as they are, along with
+ * the flags recording the simplifications that have been performed.
+ * If a basic map was finalized when it was written out, then
+ * it is not simplified again when it is read back in.
+ */
+
+#define ISL_BINARY_VERSION	1
+
+#define ARRAY_SIZE(array) (sizeof(array)/sizeof(*array))
+
+#define ISL_BINARY_MAGIC	'`'
+
+#define ISL_BINARY_BASIC_MAP	'b'
+#define ISL_BINARY_MAP		'm'
+#define ISL_BINARY_UNION_MAP	'u'
+#define ISL_BINARY_MULTI_AFF	'a'
+#define ISL_BINARY_PW_AFF	'p'
+
+#define ISL_BINARY_SPACE_PARAMS	0
+#define ISL_BINARY_SPACE_SET	1
+#define ISL_BINARY_SPACE_MAP	2
+
+/* The flags of a basic map that are stored in the encoding.
+ * Bit i of the encoded flags corresponds to element i of this array.
+ */
+static unsigned basic_map_flags[] = {
+	ISL_BASIC_MAP_FINAL,
+	ISL_BASIC_MAP_EMPTY,
+	ISL_BASIC_MAP_NO_IMPLICIT,
+	ISL_BASIC_MAP_NO_REDUNDANT,
+	ISL_BASIC_MAP_RATIONAL,
+	ISL_BASIC_MAP_NORMALIZED,
+	ISL_BASIC_MAP_NORMALIZED_DIVS,
+	ISL_BASIC_MAP_ALL_EQUALITIES,
+	ISL_BASIC_MAP_REDUCED_COEFFICIENTS,
+};
+
+#define ISL_BINARY_FINAL	(1 << 0)
+#define ISL_BINARY_RATIONAL	(1 << 4)
+
+#define ISL_BINARY_DISJOINT	(1 << 0)
+
+/* Print the unsigned integer "v".
+ */
+static __isl_give isl_printer *print_uint(__isl_take isl_printer *p,
+	unsigned long v)
+{
+	char buf[2 + 8 * sizeof(unsigned long) / 5];
+	int len = 0;
+
+	do {
+		int group = v & 31;
+
+		v >>= 5;
+		if (v)
+			group |= 32;
+		buf[len++] = '?' + group;
+	} while (v);
+	buf[len] = '\0';
+
+	return isl_printer_print_str(p, buf);
+}
+
+/* Is "l" small enough to be encoded directly as an unsigned integer?
+ * The encoding multiplies the absolute value by four,
+ * so the bound is at most a quarter of LONG_MAX.
+ * On platforms where long has 64 bits, the bound is 2^60.
+ */
+static int is_small_int(long l)
+{
+	int64_t bound = INT64_C(1) << 60;
+
+	if ((int64_t) (LONG_MAX >> 2) < bound)
+		bound = LONG_MAX >> 2;
+	return l >= -bound && l < bound;
+}
+
+/* Print the integer "v".
+ */
+static __isl_give isl_printer *print_int(__isl_take isl_printer *p,
+	isl_int v)
+{
+	char *s;
+	size_t len;
+
+	if (isl_int_fits_slong(v)) {
+		long l = isl_int_get_si(v);
+
+		if (is_small_int(l)) {
+			unsigned long u;
+
+			if (l < 0)
+				u = ((unsigned long) (-(l + 1)) << 1) | 1;
+			else
+				u = (unsigned long) l << 1;
+			return print_uint(p, u << 1);
+		}
+	}
+
+	s = isl_int_get_str(v);
+	if (!s)
+		return isl_printer_free(p);
+	len = strlen(s);
+	p = print_uint(p, 2 * len + 1);
+	p = isl_printer_print_str(p, s);
+	isl_int_free_str(s);
+
+	return p;
+}
+
+/* Print the sequence of "len" integers "v".
+ */
+static __isl_give isl_printer *print_seq(__isl_take isl_printer *p,
+	isl_int *v, unsigned len)
+{
+	int i;
+
+	for (i = 0; i < len; ++i)
+		p = print_int(p, v[i]);
+
+	return p;
+}
+
+/* Print the string "s", which may be NULL.
+ */
+static __isl_give isl_printer *print_string(__isl_take isl_printer *p,
+	const char *s)
+{
+	if (!s)
+		return print_uint(p, 0);
+	p = print_uint(p, strlen(s) + 1);
+	return isl_printer_print_str(p, s);
+}
+
+/* Print the start of the encoding of an object of type "type".
+ */
+static __isl_give isl_printer *print_header(__isl_take isl_printer *p,
+	char type)
+{
+	char buf[2] = { ISL_BINARY_MAGIC, '\0' };
+
+	p = isl_printer_print_str(p, buf);
+	p = print_uint(p, ISL_BINARY_VERSION);
+	buf[0] = type;
+	return isl_printer_print_str(p, buf);
+}
+
+static __isl_give isl_printer *print_tuple(__isl_take isl_printer *p,
+	__isl_keep isl_space *space, enum isl_dim_type type);
+
+/* Print the tuples of the map space "space".
+ */
+static __isl_give isl_printer *print_map_tuples(__isl_take isl_printer *p,
+	__isl_keep isl_space *space)
+{
+	p = print_tuple(p, space, isl_dim_in);
+	p = print_tuple(p, space, isl_dim_out);
+	return p;
+}
+
+/* Print the tuple of "space" of type "type".
+ * That is, print its name, whether it is a nested space and
+ * either the tuples of the nested space or the names of its dimensions.
+ */
+static __isl_give isl_printer *print_tuple(__isl_take isl_printer *p,
+	__isl_keep isl_space *space, enum isl_dim_type type)
+{
+	int i, n;
+	int pos;
+
+	if (!p || !space)
+		return isl_printer_free(p);
+
+	p = print_string(p, isl_space_get_tuple_name(space, type));
+	pos = type - isl_dim_in;
+	p = print_uint(p, space->nested[pos] != NULL);
+	if (space->nested[pos])
+		return print_map_tuples(p, space->nested[pos]);
+
+	n = isl_space_dim(space, type);
+	p = print_uint(p, n);
+	for (i = 0; i < n; ++i)
+		p = print_string(p, isl_space_get_dim_name(space, type, i));
+
+	return p;
+}
+
+/* Print "space".
+ */
+static __isl_give isl_printer *print_space(__isl_take isl_printer *p,
+	__isl_keep isl_space *space)
+{
+	int i, n;
+
+	if (!space)
+		return isl_printer_free(p);
+
+	if (isl_space_is_params(space))
+		p = print_uint(p, ISL_BINARY_SPACE_PARAMS);
+	else if (isl_space_is_set(space))
+		p = print_uint(p, ISL_BINARY_SPACE_SET);
+	else
+		p = print_uint(p, ISL_BINARY_SPACE_MAP);
+
+	n = isl_space_dim(space, isl_dim_param);
+	p = print_uint(p, n);
+	for (i = 0; i < n; ++i)
+		p = print_string(p,
+			    isl_space_get_dim_name(space, isl_dim_param, i));
+
+	if (isl_space_is_params(space))
+		return p;
+	if (isl_space_is_set(space))
+		return print_tuple(p, space, isl_dim_set);
+	return print_map_tuples(p, space);
+}
+
+/* Print the flags, the divs and the constraints of "bmap",
+ * but not its space.
+ */
+static __isl_give isl_printer *print_basic_map_body(__isl_take isl_printer *p,
+	__isl_keep isl_basic_map *bmap)
+{
+	int i;
+	unsigned total;
+	unsigned long flags = 0;
+
+	if (!bmap)
+		return isl_printer_free(p);
+
+	for (i = 0; i < ARRAY_SIZE(basic_map_flags); ++i)
+		if (ISL_F_ISSET(bmap, basic_map_flags[i]))
+			flags |= 1UL << i;
+
+	total = isl_basic_map_total_dim(bmap);
+	p = print_uint(p, flags);
+	p = print_uint(p, bmap->n_div);
+	p = print_uint(p, bmap->n_eq);
+	p = print_uint(p, bmap->n_ineq);
+	for (i = 0; i < bmap->n_div; ++i)
+		p = print_seq(p, bmap->div[i], 1 + 1 + total);
+	for (i = 0; i < bmap->n_eq; ++i)
+		p = print_seq(p, bmap->eq[i], 1 + total);
+	for (i = 0; i < bmap->n_ineq; ++i)
+		p = print_seq(p, bmap->ineq[i], 1 + total);
+
+	return p;
+}
+
+/* Print the flags and the basic maps of "map", but not its space.
+ */
+static __isl_give isl_printer *print_map_body(__isl_take isl_printer *p,
+	__isl_keep isl_map *map)
+{
+	int i;
+
+	if (!map)
+		return isl_printer_free(p);
+
+	p = print_uint(p, ISL_F_ISSET(map, ISL_MAP_DISJOINT) ?
+				ISL_BINARY_DISJOINT : 0);
+	p = print_uint(p, map->n);
+	for (i = 0; i < map->n; ++i)
+		p = print_basic_map_body(p, map->p[i]);
+
+	return p;
+}
+
+/* Print the divs and the coefficients of "aff", but not its space.
+ */
+static __isl_give isl_printer *print_aff_body(__isl_take isl_printer *p,
+	__isl_keep isl_aff *aff)
+{
+	int i;
+	isl_mat *div;
+
+	if (!aff)
+		return isl_printer_free(p);
+
+	div = aff->ls->div;
+	p = print_uint(p, div->n_row);
+	for (i = 0; i < div->n_row; ++i)
+		p = print_seq(p, div->row[i], div->n_col);
+	p = print_seq(p, aff->v->el, aff->v->size);
+
+	return p;
+}
+
+/* Print "bmap" in the compact encoding.
+ */
+__isl_give isl_printer *isl_basic_map_print_binary(
+	__isl_keep isl_basic_map *bmap, __isl_take isl_printer *p)
+{
+	if (!bmap)
+		return isl_printer_free(p);
+
+	p = print_header(p, ISL_BINARY_BASIC_MAP);
+	p = print_space(p, bmap->dim);
+	p = print_basic_map_body(p, bmap);
+
+	return p;
+}
+
+/* Print "map" in the compact encoding.
+ */
+__isl_give isl_printer *isl_map_print_binary(__isl_keep isl_map *map,
+	__isl_take isl_printer *p)
+{
+	if (!map)
+		return isl_printer_free(p);
+
+	p = print_header(p, ISL_BINARY_MAP);
+	p = print_space(p, map->dim);
+	p = print_map_body(p, map);
+
+	return p;
+}
+
+/* Print the space and the body of "map".
+ */
+static isl_stat print_union_map_entry(__isl_take isl_map *map, void *user)
+{
+	isl_printer **p = user;
+
+	*p = print_space(*p, map->dim);
+	*p = print_map_body(*p, map);
+	isl_map_free(map);
+
+	return *p ? isl_stat_ok : isl_stat_error;
+}
+
+/* Print "umap" in the compact encoding.
+ * That is, print its parameter space, followed by the number of maps
+ * and the spaces and bodies of these maps.
+ */
+__isl_give isl_printer *isl_union_map_print_binary(
+	__isl_keep isl_union_map *umap, __isl_take isl_printer *p)
+{
+	isl_space *space;
+
+	space = isl_union_map_get_space(umap);
+	p = print_header(p, ISL_BINARY_UNION_MAP);
+	p = print_space(p, space);
+	isl_space_free(space);
+	p = print_uint(p, isl_union_map_n_map(umap));
+	if (isl_union_map_foreach_map(umap, &print_union_map_entry, &p) < 0)
+		return isl_printer_free(p);
+
+	return p;
+}
+
+/* Print "ma" in the compact encoding.
+ */
+__isl_give isl_printer *isl_multi_aff_print_binary(
+	__isl_keep isl_multi_aff *ma, __isl_take isl_printer *p)
+{
+	int i;
+
+	if (!ma)
+		return isl_printer_free(p);
+
+	p = print_header(p, ISL_BINARY_MULTI_AFF);
+	p = print_space(p, ma->space);
+	for (i = 0; i < ma->n; ++i)
+		p = print_aff_body(p, ma->u.p[i]);
+
+	return p;
+}
+
+/* Print "pa" in the compact encoding.
+ * That is, print its space, followed by the number of pieces and,
+ * for each piece, the body of its domain and the body of its expression.
+ */
+__isl_give isl_printer *isl_pw_aff_print_binary(__isl_keep isl_pw_aff *pa,
+	__isl_take isl_printer *p)
+{
+	int i;
+
+	if (!pa)
+		return isl_printer_free(p);
+
+	p = print_header(p, ISL_BINARY_PW_AFF);
+	p = print_space(p, pa->dim);
+	p = print_uint(p, pa->n);
+	for (i = 0; i < pa->n; ++i) {
+		p = print_map_body(p, set_to_map(pa->p[i].set));
+		p = print_aff_body(p, pa->p[i].aff);
+	}
+
+	return p;
+}
+
+/* Report that the input of "s" is not a valid encoding.
+ */
+static void invalid(__isl_keep isl_stream *s)
+{
+	isl_die(isl_stream_get_ctx(s), isl_error_invalid,
+		"invalid binary encoding", return);
+}
+
+/* Read an unsigned integer from "s" and store it in "v".
+ * The input is rejected if the integer does not fit in an unsigned long,
+ * i.e., if a group of bits does not fit in the remaining bits.
+ */
+static isl_stat read_uint(__isl_keep isl_stream *s, unsigned long *v)
+{
+	int c;
+	int shift = 0;
+	const int bits = 8 * sizeof(unsigned long);
+
+	*v = 0;
+	do {
+		unsigned long group;
+
+		c = isl_stream_getc_raw(s);
+		if (c < '?' || c > '~' || shift >= bits) {
+			invalid(s);
+			return isl_stat_error;
+		}
+		group = (c - '?') & 31;
+		if (shift + 5 > bits && (group >> (bits - shift)) != 0) {
+			invalid(s);
+			return isl_stat_error;
+		}
+		*v |= group << shift;
+		shift += 5;
+	} while ((c - '?') & 32);
+
+	return isl_stat_ok;
+}
+
+/* Read an unsigned integer from "s" that is at most "max"
+ * and store it in "v".
+ */
+static isl_stat read_size(__isl_keep isl_stream *s, int *v, int max)
+{
+	unsigned long u;
+
+	if (read_uint(s, &u) < 0)
+		return isl_stat_error;
+	if (u > max) {
+		invalid(s);
+		return isl_stat_error;
+	}
+	*v = u;
+	return isl_stat_ok;
+}
+
+/* Read the decimal representation of an integer of "len" characters
+ * from "s" and store the integer in "v".
+ */
+static isl_stat read_big_int(__isl_keep isl_stream *s, isl_int v,
+	unsigned long len)
+{
+	int i;
+	char *buf;
+
+	buf = isl_alloc_array(isl_stream_get_ctx(s), char, len + 1);
+	if (!buf)
+		return isl_stat_error;
+	for (i = 0; i < len; ++i) {
+		int c = isl_stream_getc_raw(s);
+
+		if (!((i == 0 && c == '-') || (c >= '0' && c <= '9')))
+			break;
+		buf[i] = c;
+	}
+	buf[i] = '\0';
+	if (i < len || len == 0) {
+		free(buf);
+		invalid(s);
+		return isl_stat_error;
+	}
+	isl_int_read(v, buf);
+	free(buf);
+
+	return isl_stat_ok;
+}
+
+/* Read an integer from "s" and store it in "v".
+ */
+static isl_stat read_int(__isl_keep isl_stream *s, isl_int v)
+{
+	unsigned long u;
+
+	if (read_uint(s, &u) < 0)
+		return isl_stat_error;
+	if (u & 1)
+		return read_big_int(s, v, u >> 1);
+	u >>= 1;
+	if (u & 1)
+		isl_int_set_si(v, -(long) (u >> 1) - 1);
+	else
+		isl_int_set_si(v, (long) (u >> 1));
+	return isl_stat_ok;
+}
+
+/* Read a sequence of "len" integers from "s" and store them in "v".
+ */
+static isl_stat read_seq(__isl_keep isl_stream *s, isl_int *v, unsigned len)
+{
+	int i;
+
+	for (i = 0; i < len; ++i)
+		if (read_int(s, v[i]) < 0)
+			return isl_stat_error;
+
+	return isl_stat_ok;
+}
+
+/* Read a sequence of "n" integers from "s" and
+ * return them in a newly allocated vector.
+ *
+ * Since "n" is derived from the input, it may be much larger
+ * than the number of integers that are actually available.
+ * The vector is therefore grown as the integers are read,
+ * such that the allocated memory remains proportional
+ * to the part of the input that has been read.
+ */
+static __isl_give isl_vec *read_vec(__isl_keep isl_stream *s, uint64_t n)
+{
+	uint64_t i;
+	isl_vec *v;
+
+	if (n > UINT_MAX) {
+		invalid(s);
+		return NULL;
+	}
+	v = isl_vec_alloc(isl_stream_get_ctx(s), n < 64 ? n : 64);
+	for (i = 0; v && i < n; ++i) {
+		if (i >= v->size)
+			v = isl_vec_extend(v,
+				    n - i < v->size ? n : 2 * v->size);
+		if (v && read_int(s, v->el[i]) < 0)
+			v = isl_vec_free(v);
+	}
+
+	return v;
+}
+
+/* Read a (possibly NULL) string from "s" and store it in "str".
+ * The caller is responsible for freeing the string.
+ */
+static isl_stat read_string(__isl_keep isl_stream *s, char **str)
+{
+	unsigned long u;
+	int i;
+
+	*str = NULL;
+	if (read_uint(s, &u) < 0)
+		return isl_stat_error;
+	if (u == 0)
+		return isl_stat_ok;
+	*str = isl_alloc_array(isl_stream_get_ctx(s), char, u);
+	if (!*str)
+		return isl_stat_error;
+	for (i = 0; i + 1 < u; ++i) {
+		int c = isl_stream_getc_raw(s);
+
+		if (c <= 0) {
+			free(*str);
+			*str = NULL;
+			invalid(s);
+			return isl_stat_error;
+		}
+		(*str)[i] = c;
+	}
+	(*str)[i] = '\0';
+
+	return isl_stat_ok;
+}
+
+/* Read the start of the encoding of an object from "s" and
+ * check that it is of type "type".
+ * Any white space preceding the encoding is skipped.
+ */
+static isl_stat read_header(__isl_keep isl_stream *s, char type)
+{
+	int c;
+	unsigned long version;
+
+	do {
+		c = isl_stream_getc_raw(s);
+	} while (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+	if (c != ISL_BINARY_MAGIC) {
+		invalid(s);
+		return isl_stat_error;
+	}
+	if (read_uint(s, &version) < 0)
+		return isl_stat_error;
+	if (version != ISL_BINARY_VERSION)
+		isl_die(isl_stream_get_ctx(s), isl_error_unsupported,
+			"unsupported version of binary encoding",
+			return isl_stat_error);
+	c = isl_stream_getc_raw(s);
+	if (c != type)
+		isl_die(isl_stream_get_ctx(s), isl_error_invalid,
+			"unexpected type of encoded object",
+			return isl_stat_error);
+
+	return isl_stat_ok;
+}
+
+/* Read the name of a tuple or dimension from "s" and
+ * assign it to the tuple of "space" of type "type" (if "pos" < 0) or
+ * the dimension at position "pos".
+ */
+static __isl_give isl_space *read_name(__isl_keep isl_stream *s,
+	__isl_take isl_space *space, enum isl_dim_type type, int pos)
+{
+	char *name;
+
+	if (read_string(s, &name) < 0)
+		return isl_space_free(space);
+	if (!name)
+		return space;
+	if (pos < 0)
+		space = isl_space_set_tuple_name(space, type, name);
+	else
+		space = isl_space_set_dim_name(space, type, pos, name);
+	free(name);
+
+	return space;
+}
+
+static __isl_give isl_space *read_tuple(__isl_keep isl_stream *s,
+	__isl_keep isl_space *params);
+
+/* Read the tuples of a map space from "s", with parameters "params".
+ */
+static __isl_give isl_space *read_map_tuples(__isl_keep isl_stream *s,
+	__isl_keep isl_space *params)
+{
+	isl_space *dom, *ran;
+
+	dom = read_tuple(s, params);
+	ran = read_tuple(s, params);
+	return isl_space_map_from_domain_and_range(dom, ran);
+}
+
+/* Read a tuple, as printed by print_tuple, from "s" and
+ * return it as a set space with parameters "params".
+ */
+static __isl_give isl_space *read_tuple(__isl_keep isl_stream *s,
+	__isl_keep isl_space *params)
+{
+	int i, n;
+	char *name;
+	unsigned long nested;
+	isl_space *space;
+
+	if (read_string(s, &name) < 0)
+		return NULL;
+	if (read_uint(s, &nested) < 0)
+		goto error;
+	if (nested) {
+		space = isl_space_wrap(read_map_tuples(s, params));
+	} else {
+		if (read_size(s, &n, INT_MAX) < 0)
+			goto error;
+		space = isl_space_set_from_params(isl_space_copy(params));
+		space = isl_space_add_dims(space, isl_dim_set, n);
+		for (i = 0; i < n; ++i)
+			space = read_name(s, space, isl_dim_set, i);
+	}
+	if (name)
+		space = isl_space_set_tuple_name(space, isl_dim_set, name);
+	free(name);
+
+	return space;
+error:
+	free(name);
+	return NULL;
+}
+
+/* Read a space, as printed by print_space, from "s".
+ */
+static __isl_give isl_space *read_space(__isl_keep isl_stream *s)
+{
+	int i, kind, n;
+	isl_space *params, *space;
+
+	if (read_size(s, &kind, ISL_BINARY_SPACE_MAP) < 0)
+		return NULL;
+	if (read_size(s, &n, INT_MAX) < 0)
+		return NULL;
+	params = isl_space_params_alloc(isl_stream_get_ctx(s), n);
+	for (i = 0; i < n; ++i)
+		params = read_name(s, params, isl_dim_param, i);
+	if (!params)
+		return NULL;
+
+	if (kind == ISL_BINARY_SPACE_PARAMS)
+		return params;
+	if (kind == ISL_BINARY_SPACE_SET)
+		space = read_tuple(s, params);
+	else
+		space = read_map_tuples(s, params);
+	isl_space_free(params);
+
+	return space;
+}
+
+/* Read the flags, the divs and the constraints of a basic map
+ * living in "space" from "s".
+ *
+ * The coefficients are read (see read_vec) before the basic map
+ * is allocated such that a basic map is only allocated
+ * if the input actually contains all its coefficients.
+ *
+ * If the basic map was not finalized when it was written out,
+ * then it is simplified and finalized here.
+ * Otherwise, the flags that were recorded are simply restored.
+ */
+static __isl_give isl_basic_map *read_basic_map_body(
+	__isl_keep isl_stream *s, __isl_take isl_space *space)
+{
+	int i, k;
+	int n_div, n_eq, n_ineq;
+	uint64_t total;
+	unsigned long flags;
+	isl_vec *div, *eq, *ineq;
+	isl_basic_map *bmap;
+
+	if (!space || read_uint(s, &flags) < 0 ||
+	    read_size(s, &n_div, INT_MAX) < 0 ||
+	    read_size(s, &n_eq, INT_MAX) < 0 ||
+	    read_size(s, &n_ineq, INT_MAX) < 0)
+		goto error;
+	total = isl_space_dim(space, isl_dim_all) + (uint64_t) n_div;
+	div = read_vec(s, n_div * (1 + 1 + total));
+	eq = div ? read_vec(s, n_eq * (1 + total)) : NULL;
+	ineq = eq ? read_vec(s, n_ineq * (1 + total)) : NULL;
+	if (!ineq) {
+		isl_vec_free(div);
+		isl_vec_free(eq);
+		goto error;
+	}
+
+	bmap = isl_basic_map_alloc_space(space, n_div, n_eq, n_ineq);
+	for (i = 0; bmap && i < n_div; ++i) {
+		k = isl_basic_map_alloc_div(bmap);
+		if (k < 0)
+			bmap = isl_basic_map_free(bmap);
+		else
+			isl_seq_swp_or_cpy(bmap->div[k],
+				div->el + i * (1 + 1 + total), 1 + 1 + total);
+	}
+	for (i = 0; bmap && i < n_eq; ++i) {
+		k = isl_basic_map_alloc_equality(bmap);
+		if (k < 0)
+			bmap = isl_basic_map_free(bmap);
+		else
+			isl_seq_swp_or_cpy(bmap->eq[k],
+				eq->el + i * (1 + total), 1 + total);
+	}
+	for (i = 0; bmap && i < n_ineq; ++i) {
+		k = isl_basic_map_alloc_inequality(bmap);
+		if (k < 0)
+			bmap = isl_basic_map_free(bmap);
+		else
+			isl_seq_swp_or_cpy(bmap->ineq[k],
+				ineq->el + i * (1 + total), 1 + total);
+	}
+	isl_vec_free(div);
+	isl_vec_free(eq);
+	isl_vec_free(ineq);
+
+	if (flags & ISL_BINARY_RATIONAL)
+		bmap = isl_basic_map_set_rational(bmap);
+	if (!(flags & ISL_BINARY_FINAL)) {
+		bmap = isl_basic_map_simplify(bmap);
+		return isl_basic_map_finalize(bmap);
+	}
+	if (!bmap)
+		return NULL;
+	for (i = 0; i < ARRAY_SIZE(basic_map_flags); ++i)
+		if (flags & (1UL << i))
+			ISL_F_SET(bmap, basic_map_flags[i]);
+
+	return bmap;
+error:
+	isl_space_free(space);
+	return NULL;
+}
+
+/* Read the flags and the basic maps of a map living in "space" from "s".
+ *
+ * The map is grown as the basic maps are read
+ * since the number of basic maps in the input may be arbitrarily large.
+ */
+static __isl_give isl_map *read_map_body(__isl_keep isl_stream *s,
+	__isl_take isl_space *space)
+{
+	int i, n;
+	unsigned long flags;
+	isl_map *map;
+
+	if (read_uint(s, &flags) < 0 || read_size(s, &n, INT_MAX) < 0) {
+		isl_space_free(space);
+		return NULL;
+	}
+	map = isl_map_alloc_space(isl_space_copy(space), n < 8 ? n : 8, 0);
+	for (i = 0; map && i < n; ++i) {
+		isl_basic_map *bmap;
+
+		if (map->n >= map->size)
+			map = isl_map_grow(map,
+				    n - i < map->size ? n - i : map->size);
+		bmap = read_basic_map_body(s, isl_space_copy(space));
+		map = isl_map_add_basic_map(map, bmap);
+	}
+	isl_space_free(space);
+	if (map && (flags & ISL_BINARY_DISJOINT))
+		ISL_F_SET(map, ISL_MAP_DISJOINT);
+
+	return map;
+}
+
+/* Read the divs and the coefficients of an affine expression
+ * on the domain "space" from "s".
+ * As in read_basic_map_body, the divs are only allocated
+ * after their coefficients have been read.
+ */
+static __isl_give isl_aff *read_aff_body(__isl_keep isl_stream *s,
+	__isl_take isl_space *space)
+{
+	int i, n_div;
+	uint64_t total;
+	isl_ctx *ctx;
+	isl_mat *div;
+	isl_vec *v;
+	isl_local_space *ls;
+
+	if (!space || read_size(s, &n_div, INT_MAX) < 0) {
+		isl_space_free(space);
+		return NULL;
+	}
+	ctx = isl_stream_get_ctx(s);
+	total = isl_space_dim(space, isl_dim_all) + (uint64_t) n_div;
+	v = read_vec(s, n_div * (1 + 1 + total));
+	div = v ? isl_mat_alloc(ctx, n_div, 1 + 1 + total) : NULL;
+	for (i = 0; div && i < n_div; ++i)
+		isl_seq_swp_or_cpy(div->row[i],
+			v->el + i * (1 + 1 + total), 1 + 1 + total);
+	isl_vec_free(v);
+	if (!div) {
+		isl_space_free(space);
+		return NULL;
+	}
+	ls = isl_local_space_alloc_div(space, div);
+	v = isl_vec_alloc(ctx, 1 + 1 + total);
+	if (v && read_seq(s, v->el, v->size) < 0)
+		v = isl_vec_free(v);
+
+	return isl_aff_alloc_vec(ls, v);
+}
+
+/* Read a basic map in the compact encoding from "s".
+ */
+__isl_give isl_basic_map *isl_stream_read_binary_basic_map(
+	__isl_keep isl_stream *s)
+{
+	if (read_header(s, ISL_BINARY_BASIC_MAP) < 0)
+		return NULL;
+	return read_basic_map_body(s, read_space(s));
+}
+
+/* Read a basic set in the compact encoding from "s".
+ */
+__isl_give isl_basic_set *isl_stream_read_binary_basic_set(
+	__isl_keep isl_stream *s)
+{
+	isl_basic_map *bmap;
+
+	bmap = isl_stream_read_binary_basic_map(s);
+	if (bmap && !isl_basic_map_may_be_set(bmap))
+		isl_die(isl_stream_get_ctx(s), isl_error_invalid,
+			"input is not a set", goto error);
+	return isl_basic_map_range(bmap);
+error:
+	isl_basic_map_free(bmap);
+	return NULL;
+}
+
+/* Read a map in the compact encoding from "s".
+ */
+__isl_give isl_map *isl_stream_read_binary_map(__isl_keep isl_stream *s)
+{
+	if (read_header(s, ISL_BINARY_MAP) < 0)
+		return NULL;
+	return read_map_body(s, read_space(s));
+}
+
+/* Read a set in the compact encoding from "s".
+ */
+__isl_give isl_set *isl_stream_read_binary_set(__isl_keep isl_stream *s)
+{
+	isl_map *map;
+
+	map = isl_stream_read_binary_map(s);
+	if (map && !isl_map_may_be_set(map))
+		isl_die(isl_stream_get_ctx(s), isl_error_invalid,
+			"input is not a set", goto error);
+	return isl_map_range(map);
+error:
+	isl_map_free(map);
+	return NULL;
+}
+
+/* Read a union map in the compact encoding from "s".
+ */
+__isl_give isl_union_map *isl_stream_read_binary_union_map(
+	__isl_keep isl_stream *s)
+{
+	int i, n;
+	isl_union_map *umap;
+
+	if (read_header(s, ISL_BINARY_UNION_MAP) < 0)
+		return NULL;
+	umap = isl_union_map_empty(read_space(s));
+	if (read_size(s, &n, INT_MAX) < 0)
+		return isl_union_map_free(umap);
+	for (i = 0; umap && i < n; ++i) {
+		isl_map *map;
+
+		map = read_map_body(s, read_space(s));
+		umap = isl_union_map_add_map(umap, map);
+	}
+
+	return umap;
+}
+
+/* isl_union_map_every_map callback that checks whether "map"
+ * may be a set.
+ */
+static isl_bool map_may_be_set(__isl_keep isl_map *map, void *user)
+{
+	return isl_map_may_be_set(map);
+}
+
+/* Read a union set in the compact encoding from "s".
+ */
+__isl_give isl_union_set *isl_stream_read_binary_union_set(
+	__isl_keep isl_stream *s)
+{
+	isl_bool is_set;
+	isl_union_map *umap;
+
+	umap = isl_stream_read_binary_union_map(s);
+	is_set = isl_union_map_every_map(umap, &map_may_be_set, NULL);
+	if (is_set < 0)
+		goto error;
+	if (!is_set)
+		isl_die(isl_stream_get_ctx(s), isl_error_invalid,
+			"input is not a union set", goto error);
+	return uset_from_umap(umap);
+error:
+	isl_union_map_free(umap);
+	return NULL;
+}
+
+/* Read a multi affine expression in the compact encoding from "s".
+ */
+__isl_give isl_multi_aff *isl_stream_read_binary_multi_aff(
+	__isl_keep isl_stream *s)
+{
+	int i, n;
+	isl_space *space;
+	isl_multi_aff *ma;
+
+	if (read_header(s, ISL_BINARY_MULTI_AFF) < 0)
+		return NULL;
+	space = read_space(s);
+	if (!space)
+		return NULL;
+	n = isl_space_dim(space, isl_dim_out);
+	ma = isl_multi_aff_alloc(isl_space_copy(space));
+	for (i = 0; i < n; ++i) {
+		isl_aff *aff;
+
+		aff = read_aff_body(s, isl_space_domain(isl_space_copy(space)));
+		ma = isl_multi_aff_set_aff(ma, i, aff);
+	}
+	isl_space_free(space);
+
+	return ma;
+}
+
+/* Read a piecewise affine expression in the compact encoding from "s".
+ */
+__isl_give isl_pw_aff *isl_stream_read_binary_pw_aff(__isl_keep isl_stream *s)
+{
+	int i, n;
+	isl_space *space;
+	isl_pw_aff *pa;
+
+	if (read_header(s, ISL_BINARY_PW_AFF) < 0)
+		return NULL;
+	space = read_space(s);
+	if (read_size(s, &n, INT_MAX) < 0) {
+		isl_space_free(space);
+		return NULL;
+	}
+	pa = isl_pw_aff_alloc_size(isl_space_copy(space), n);
+	for (i = 0; i < n; ++i) {
+		isl_space *dom;
+		isl_set *set;
+		isl_aff *aff;
+
+		dom = isl_space_domain(isl_space_copy(space));
+		set = set_from_map(read_map_body(s, isl_space_copy(dom)));
+		aff = read_aff_body(s, dom);
+		pa = isl_pw_aff_add_piece(pa, set, aff);
+	}
+	isl_space_free(space);
+
+	return pa;
+}
+
+/* Read a union map in the compact encoding from "input".
+ * If "input" is seekable, then it is read in blocks and
+ * the characters beyond the encoded object are returned to "input",
+ * such that further objects can be read from the same file.
+ *
+ * The result is decoded into newly allocated memory.
+ * Referencing the constraints in place in a read-only mapping
+ * of the file is not possible since the coefficients are
+ * isl_int values, which (in case of GMP) store their limbs
+ * in separately allocated memory, and since an isl_basic_map
+ * owns the isl_blk holding its constraints.
+ */
+__isl_give isl_union_map *isl_union_map_read_binary_from_file(isl_ctx *ctx,
+	FILE *input)
+{
+	isl_stream *s;
+	isl_union_map *umap;
+
+	s = isl_stream_new_file(ctx, input);
+	if (!s)
+		return NULL;
+	umap = isl_stream_read_binary_union_map(s);
+	isl_stream_free(s);
+
+	return umap;
+}
+
+/* Read a union set in the compact encoding from "input".
+ */
+__isl_give isl_union_set *isl_union_set_read_binary_from_file(isl_ctx *ctx,
+	FILE *input)
+{
+	isl_stream *s;
+	isl_union_set *uset;
+
+	s = isl_stream_new_file(ctx, input);
+	if (!s)
+		return NULL;
+	uset = isl_stream_read_binary_union_set(s);
+	isl_stream_free(s);
+
+	return uset;
+}
@@ -0,0 +1,20 @@
+#ifndef ISL_BINARY_PRIVATE_H
+#define ISL_BINARY_PRIVATE_H
+
+#include <isl/map_type.h>
+#include <isl/union_map_type.h>
+#include <isl/aff_type.h>
+#include <isl/printer.h>
+
+__isl_give isl_printer *isl_basic_map_print_binary(
+	__isl_keep isl_basic_map *bmap, __isl_take isl_printer *p);
+__isl_give isl_printer *isl_map_print_binary(__isl_keep isl_map *map,
+	__isl_take isl_printer *p);
+__isl_give isl_printer *isl_union_map_print_binary(
+	__isl_keep isl_union_map *umap, __isl_take isl_printer *p);
+__isl_give isl_printer *isl_multi_aff_print_binary(
+	__isl_keep isl_multi_aff *ma, __isl_take isl_printer *p);
+__isl_give isl_printer *isl_pw_aff_print_binary(__isl_keep isl_pw_aff *pa,
+	__isl_take isl_printer *p);
+
+#endif
@@ -7,6 +7,20 @@
  * while "error_file" and "error_line" specify where the last error occurred.
  * "error_msg" and "error_file" always point to statically allocated
  * strings (if not NULL).
+ *
+ * "schedule_fallbacks" keeps track of the isl_schedule_fallback values
+ * corresponding to the cheaper strategies that the scheduler switched to
+ * during the last schedule computation because it ran out of
+ * its operation budget.
+ *
+ * "schedule_cache_hits" and "schedule_cache_misses" count the number
+ * of schedule computations that were and were not found
+ * in the schedule cache directory.
+ *
+ * "ast_expr_cache_hits" and "ast_expr_cache_misses" count the number
+ * of AST expressions (loop bounds and guards) that were and were not found
+ * in the expression cache of the isl_ast_build in which they were
+ * constructed.
  */
 struct isl_ctx {
 	int			ref;
@@ -39,6 +53,14 @@ struct isl_ctx {
 
 	unsigned long		operations;
 	unsigned long		max_operations;
+
+	int			schedule_fallbacks;
+
+	int			schedule_cache_hits;
+	int			schedule_cache_misses;
+
+	int			ast_expr_cache_hits;
+	int			ast_expr_cache_misses;
 };
 
 int isl_ctx_next_operation(isl_ctx *ctx);
@@ -26,6 +26,7 @@
 #include <isl/schedule_node.h>
 #include <isl_sort.h>
 #include <isl/stream.h>
+#include <isl_printer_private.h>
 
 enum isl_restriction_type {
 	isl_restriction_type_empty,
@@ -1842,8 +1843,7 @@ __isl_give char *isl_union_access_info_to_str(
 	p = isl_printer_to_str(isl_union_access_info_get_ctx(access));
 	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_FLOW);
 	p = isl_printer_print_union_access_info(p, access);
-	s = isl_printer_get_str(p);
-	isl_printer_free(p);
+	s = isl_printer_take_str(p);
 
 	return s;
 }
@@ -3240,8 +3240,7 @@ __isl_give char *isl_union_flow_to_str(__isl_keep isl_union_flow *flow)
 	p = isl_printer_to_str(isl_union_flow_get_ctx(flow));
 	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_FLOW);
 	p = isl_printer_print_union_flow(p, flow);
-	s = isl_printer_get_str(p);
-	isl_printer_free(p);
+	s = isl_printer_take_str(p);
 
 	return s;
 }
@@ -19,6 +19,29 @@ uint32_t isl_hash_string(uint32_t hash, const char *s)
 	return hash;
 }
 
+/* Update the 64-bit hash value "hash" with the characters in "s".
+ * The characters are treated as unsigned such that the result
+ * does not depend on the signedness of char on the platform.
+ */
+uint64_t isl_hash64_string(uint64_t hash, const char *s)
+{
+	for (; *s; s++)
+		isl_hash64_byte(hash, (unsigned char) *s);
+	return hash;
+}
+
+/* Update the 64-bit hash value "hash" with the 64-bit value "h",
+ * one byte at a time, starting from the least significant byte.
+ */
+uint64_t isl_hash64_uint64(uint64_t hash, uint64_t h)
+{
+	int i;
+
+	for (i = 0; i < 8; ++i)
+		isl_hash64_byte(hash, (h >> (8 * i)) & 0xFF);
+	return hash;
+}
+
 uint32_t isl_hash_mem(uint32_t hash, const void *p, size_t len)
 {
 	int i;
@@ -5,4 +5,13 @@
 
 extern struct isl_hash_table_entry *isl_hash_table_entry_none;
 
+#define isl_hash64_init()	((uint64_t) 14695981039346656037ull)
+#define isl_hash64_byte(h,b)	do {					\
+					h *= (uint64_t) 1099511628211ull; \
+					h ^= b;				\
+				} while(0)
+
+uint64_t isl_hash64_string(uint64_t hash, const char *s);
+uint64_t isl_hash64_uint64(uint64_t hash, uint64_t h);
+
 #endif
@@ -177,6 +177,28 @@ uint32_t isl_hash_id(uint32_t hash, __isl_keep isl_id *id)
 	return hash;
 }
 
+/* Are "list1" and "list2" obviously equal?
+ * That is, do they contain the same isl_ids in the same order?
+ */
+isl_bool isl_id_list_plain_is_equal(__isl_keep isl_id_list *list1,
+	__isl_keep isl_id_list *list2)
+{
+	int i;
+
+	if (!list1 || !list2)
+		return isl_bool_error;
+	if (list1 == list2)
+		return isl_bool_true;
+
+	if (list1->n != list2->n)
+		return isl_bool_false;
+	for (i = 0; i < list1->n; ++i)
+		if (list1->p[i] != list2->p[i])
+			return isl_bool_false;
+
+	return isl_bool_true;
+}
+
 /* Replace the free_user callback by "free_user".
  */
 __isl_give isl_id *isl_id_set_free_user(__isl_take isl_id *id,
@@ -35,6 +35,8 @@ struct isl_id {
 
 uint32_t isl_hash_id(uint32_t hash, __isl_keep isl_id *id);
 int isl_id_cmp(__isl_keep isl_id *id1, __isl_keep isl_id *id2);
+isl_bool isl_id_list_plain_is_equal(__isl_keep isl_id_list *list1,
+	__isl_keep isl_id_list *list2);
 
 extern isl_id isl_id_none;
 
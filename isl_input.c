@@ -26,9 +26,11 @@
 #include <isl/union_map.h>
 #include <isl_mat_private.h>
 #include <isl_aff_private.h>
+#include <isl/options.h>
 #include <isl_vec_private.h>
 #include <isl/list.h>
 #include <isl_val_private.h>
+#include <set_from_map.c>
 
 struct variable {
 	char    	    	*name;
@@ -1505,6 +1507,204 @@ error:
 	return NULL;
 }
 
+/* Is "pa" a single affine expression with a unit denominator and
+ * without any integer divisions, defined over the entire domain?
+ */
+static int is_plain_affine(__isl_keep isl_pw_aff *pa)
+{
+	isl_aff *aff;
+
+	if (!pa || pa->n != 1)
+		return 0;
+	if (!isl_set_plain_is_universe(pa->p[0].set))
+		return 0;
+	aff = pa->p[0].aff;
+	if (isl_aff_is_nan(aff) != isl_bool_false)
+		return 0;
+	return isl_aff_dim(aff, isl_dim_div) == 0 &&
+	    isl_int_is_one(aff->v->el[0]);
+}
+
+/* Is every element of "list" a plain affine expression
+ * in the sense of is_plain_affine?
+ */
+static int is_plain_affine_list(__isl_keep isl_pw_aff_list *list)
+{
+	int i, n;
+
+	n = isl_pw_aff_list_n_pw_aff(list);
+	for (i = 0; i < n; ++i) {
+		isl_pw_aff *pa;
+		int plain;
+
+		pa = isl_pw_aff_list_get_pw_aff(list, i);
+		plain = is_plain_affine(pa);
+		isl_pw_aff_free(pa);
+		if (!plain)
+			return 0;
+	}
+
+	return 1;
+}
+
+/* Can the constraints of the form "a op b" with a an element of "left",
+ * op an operator of type "type" and b an element of "right"
+ * be added directly to the basic sets by add_plain_constraints?
+ * This is only possible for non-rational affine (in)equalities
+ * between plain affine expressions.
+ */
+static int is_plain_constraint(int type, __isl_keep isl_pw_aff_list *left,
+	__isl_keep isl_pw_aff_list *right, int rational)
+{
+	if (rational)
+		return 0;
+	if (type != ISL_TOKEN_LE && type != ISL_TOKEN_GE &&
+	    type != ISL_TOKEN_LT && type != ISL_TOKEN_GT && type != '=')
+		return 0;
+	return is_plain_affine_list(left) && is_plain_affine_list(right);
+}
+
+/* Add the constraint "a op b" to each basic set of "set",
+ * where a and b are plain affine expressions and
+ * op is an operator of type "type".
+ * The constraint is added directly, without simplifying the basic sets.
+ * The caller is responsible for simplifying the result
+ * through simplify_conjunction.
+ */
+static __isl_give isl_set *add_plain_constraint(__isl_take isl_set *set,
+	int type, __isl_keep isl_aff *a, __isl_keep isl_aff *b)
+{
+	int i, k;
+	unsigned n, total;
+	isl_aff *c;
+	int eq = type == '=';
+
+	if (type == ISL_TOKEN_LE || type == ISL_TOKEN_LT)
+		c = isl_aff_sub(isl_aff_copy(b), isl_aff_copy(a));
+	else
+		c = isl_aff_sub(isl_aff_copy(a), isl_aff_copy(b));
+	if (type == ISL_TOKEN_LT || type == ISL_TOKEN_GT)
+		c = isl_aff_add_constant_si(c, -1);
+	set = isl_set_cow(set);
+	if (!set || !c)
+		goto error;
+
+	n = c->v->size - 1;
+	for (i = 0; i < set->n; ++i) {
+		isl_basic_set *bset;
+
+		bset = isl_basic_set_cow(set->p[i]);
+		bset = isl_basic_set_extend_constraints(bset, eq, !eq);
+		set->p[i] = bset;
+		if (!bset)
+			goto error;
+		k = eq ? isl_basic_set_alloc_equality(bset) :
+			 isl_basic_set_alloc_inequality(bset);
+		if (k < 0)
+			goto error;
+		total = isl_basic_set_total_dim(bset);
+		if (eq) {
+			isl_seq_cpy(bset->eq[k], c->v->el + 1, n);
+			isl_seq_clr(bset->eq[k] + n, 1 + total - n);
+		} else {
+			isl_seq_cpy(bset->ineq[k], c->v->el + 1, n);
+			isl_seq_clr(bset->ineq[k] + n, 1 + total - n);
+		}
+		ISL_F_CLR(bset, ISL_BASIC_SET_FINAL);
+	}
+	ISL_F_CLR(set, ISL_MAP_NORMALIZED);
+
+	isl_aff_free(c);
+	return set;
+error:
+	isl_aff_free(c);
+	isl_set_free(set);
+	return NULL;
+}
+
+/* Add the constraints of the form "a op b" with a an element of "left",
+ * op an operator of type "type" and b an element of "right"
+ * directly to the basic sets of "set".
+ * The elements of "left" and "right" are known to be
+ * plain affine expressions in the sense of is_plain_affine.
+ */
+static __isl_give isl_set *add_plain_constraints(__isl_take isl_set *set,
+	int type, __isl_keep isl_pw_aff_list *left,
+	__isl_keep isl_pw_aff_list *right)
+{
+	int i, j, n_left, n_right;
+
+	n_left = isl_pw_aff_list_n_pw_aff(left);
+	n_right = isl_pw_aff_list_n_pw_aff(right);
+	for (i = 0; i < n_left; ++i) {
+		isl_pw_aff *a = isl_pw_aff_list_get_pw_aff(left, i);
+
+		for (j = 0; j < n_right; ++j) {
+			isl_pw_aff *b = isl_pw_aff_list_get_pw_aff(right, j);
+
+			set = add_plain_constraint(set, type,
+						a->p[0].aff, b->p[0].aff);
+			isl_pw_aff_free(b);
+		}
+		isl_pw_aff_free(a);
+	}
+
+	return set;
+}
+
+/* Simplify and finalize "bmap".
+ */
+static __isl_give isl_basic_map *simplify_conjunct(
+	__isl_take isl_basic_map *bmap)
+{
+	bmap = isl_basic_map_simplify(bmap);
+	return isl_basic_map_finalize(bmap);
+}
+
+/* Bring the equality constraints of "bmap" into the form
+ * expected by the rest of isl and finalize "bmap",
+ * without otherwise simplifying the constraints.
+ *
+ * That is, the constraints are divided by the greatest common divisor
+ * of their coefficients and Gaussian elimination is performed
+ * on the equality constraints, removing the pivot variables
+ * from the other constraints.  Any constraint that becomes
+ * trivially satisfied is removed and if any of them becomes
+ * trivially violated, then "bmap" is replaced by an empty basic map.
+ * Finally, redundant integer divisions are removed and
+ * "bmap" is marked final.
+ */
+static __isl_give isl_basic_map *normalize_trusted_conjunct(
+	__isl_take isl_basic_map *bmap)
+{
+	bmap = isl_basic_map_normalize_constraints(bmap);
+	bmap = isl_basic_map_gauss(bmap, NULL);
+	bmap = isl_basic_map_normalize_constraints(bmap);
+	return isl_basic_map_finalize(bmap);
+}
+
+/* Simplify the basic maps of "map" to which constraints
+ * may have been added directly by add_plain_constraint.
+ *
+ * If the input is trusted to have been printed by isl,
+ * then only the equality constraints are brought into normal form
+ * by normalize_trusted_conjunct.  In particular,
+ * redundant or duplicate inequality constraints are not removed,
+ * pairs of opposite inequality constraints are not combined
+ * into equality constraints, integer divisions are not simplified or
+ * eliminated and no (implicit) emptiness beyond that of
+ * a constraint that is trivially violated is detected.
+ */
+static __isl_give isl_map *simplify_conjunction(__isl_take isl_map *map)
+{
+	if (!map)
+		return NULL;
+	if (isl_options_get_trusted_input(isl_map_get_ctx(map)))
+		return isl_map_inline_foreach_basic_map(map,
+						&normalize_trusted_conjunct);
+	return isl_map_inline_foreach_basic_map(map, &simplify_conjunct);
+}
+
 /* Construct constraints of the form
  *
  *	a op b
@@ -1518,6 +1718,11 @@ error:
  * If "type" is the type of a comparison operator between lists
  * of affine expressions, then a single (compound) constraint
  * is constructed by list_cmp instead.
+ *
+ * Constraints between plain affine expressions are added directly
+ * to the basic sets of "set" without simplifying them.
+ * The caller is responsible for calling simplify_conjunction
+ * on the result.
  */
 static __isl_give isl_set *construct_constraints(
 	__isl_take isl_set *set, int type,
@@ -1526,6 +1731,9 @@ static __isl_give isl_set *construct_constraints(
 {
 	isl_set *cond;
 
+	if (is_plain_constraint(type, left, right, rational))
+		return add_plain_constraints(set, type, left, right);
+
 	left = isl_pw_aff_list_copy(left);
 	right = isl_pw_aff_list_copy(right);
 	if (rational) {
@@ -1768,27 +1976,66 @@ static __isl_give isl_map *read_conjunct(__isl_keep isl_stream *s,
 		return isl_map_empty(dim);
 	}
 		
-	return add_constraint(s, v, map, rational);
+	map = add_constraint(s, v, map, rational);
+	return simplify_conjunction(map);
 error:
 	isl_map_free(map);
 	return NULL;
 }
 
+/* Is the next conjunct on "s" a (possibly chained) comparison
+ * that does not start with a parenthesis?
+ * That is, is it handled by add_constraint in read_conjunct?
+ */
+static int next_is_constraint(__isl_keep isl_stream *s)
+{
+	return !isl_stream_next_token_is(s, '(') &&
+	    !isl_stream_next_token_is(s, ISL_TOKEN_MAP) &&
+	    !isl_stream_next_token_is(s, ISL_TOKEN_EXISTS) &&
+	    !isl_stream_next_token_is(s, ISL_TOKEN_TRUE) &&
+	    !isl_stream_next_token_is(s, ISL_TOKEN_FALSE);
+}
+
+/* Read a conjunction of (possibly negated) conjuncts from "s" and
+ * return the intersection of "map" with this conjunction.
+ *
+ * Plain constraints that are not negated are added directly
+ * to the result, while the other conjuncts are read separately
+ * and then combined with the result.
+ * Since add_constraint may add constraints to the basic maps
+ * without simplifying them, the result is simplified
+ * before it is combined with another conjunct and
+ * at the end, but only if any constraints were added directly.
+ */
 static __isl_give isl_map *read_conjuncts(__isl_keep isl_stream *s,
 	struct vars *v, __isl_take isl_map *map, int rational)
 {
 	isl_map *res;
 	int negate;
+	int added;
 
 	negate = isl_stream_eat_if_available(s, ISL_TOKEN_NOT);
-	res = read_conjunct(s, v, isl_map_copy(map), rational);
-	if (negate)
-		res = isl_map_subtract(isl_map_copy(map), res);
+	added = !negate && next_is_constraint(s);
+	if (added) {
+		res = add_constraint(s, v, isl_map_copy(map), rational);
+	} else {
+		res = read_conjunct(s, v, isl_map_copy(map), rational);
+		if (negate)
+			res = isl_map_subtract(isl_map_copy(map), res);
+	}
 
 	while (res && isl_stream_eat_if_available(s, ISL_TOKEN_AND)) {
 		isl_map *res_i;
 
 		negate = isl_stream_eat_if_available(s, ISL_TOKEN_NOT);
+		if (!negate && next_is_constraint(s)) {
+			res = add_constraint(s, v, res, rational);
+			added = 1;
+			continue;
+		}
+		if (added)
+			res = simplify_conjunction(res);
+		added = 0;
 		res_i = read_conjunct(s, v, isl_map_copy(map), rational);
 		if (negate)
 			res = isl_map_subtract(res, res_i);
@@ -1797,6 +2044,8 @@ static __isl_give isl_map *read_conjuncts(__isl_keep isl_stream *s,
 	}
 
 	isl_map_free(map);
+	if (added)
+		res = simplify_conjunction(res);
 	return res;
 }
 
@@ -2618,6 +2867,77 @@ static struct isl_obj obj_read_disjuncts(__isl_keep isl_stream *s,
 	return obj;
 }
 
+/* Read the optional parameter declaration, the opening brace and
+ * the optional declaration of symbolic constants of an object from "s".
+ * "v" collects the identifiers that are declared.
+ * Return a universe map in the declared parameters.
+ */
+static __isl_give isl_map *read_obj_start(__isl_keep isl_stream *s,
+	struct vars *v)
+{
+	struct isl_token *tok;
+	isl_map *map;
+
+	map = isl_map_universe(isl_space_params_alloc(s->ctx, 0));
+	tok = isl_stream_next_token(s);
+	if (tok && tok->type == '[') {
+		isl_stream_push_token(s, tok);
+		map = read_map_tuple(s, map, isl_dim_param, v, 0, 0);
+		if (!map)
+			return NULL;
+		tok = isl_stream_next_token(s);
+		if (!tok || tok->type != ISL_TOKEN_TO) {
+			isl_stream_error(s, tok, "expecting '->'");
+			if (tok)
+				isl_stream_push_token(s, tok);
+			goto error;
+		}
+		isl_token_free(tok);
+		tok = isl_stream_next_token(s);
+	}
+	if (!tok || tok->type != '{') {
+		isl_stream_error(s, tok, "expecting '{'");
+		if (tok)
+			isl_stream_push_token(s, tok);
+		goto error;
+	}
+	isl_token_free(tok);
+
+	tok = isl_stream_next_token(s);
+	if (!tok)
+		;
+	else if (tok->type == ISL_TOKEN_IDENT && !strcmp(tok->u.s, "Sym")) {
+		isl_token_free(tok);
+		if (isl_stream_eat(s, '='))
+			goto error;
+		map = read_map_tuple(s, map, isl_dim_param, v, 0, 1);
+	} else
+		isl_stream_push_token(s, tok);
+
+	return map;
+error:
+	isl_map_free(map);
+	return NULL;
+}
+
+/* Read the closing brace of an object from "s".
+ */
+static isl_stat read_obj_end(__isl_keep isl_stream *s)
+{
+	struct isl_token *tok;
+
+	tok = isl_stream_next_token(s);
+	if (tok && tok->type == '}') {
+		isl_token_free(tok);
+		return isl_stat_ok;
+	}
+
+	isl_stream_error(s, tok, "unexpected isl_token");
+	if (tok)
+		isl_token_free(tok);
+	return isl_stat_error;
+}
+
 static struct isl_obj obj_read(__isl_keep isl_stream *s)
 {
 	isl_map *map = NULL;
@@ -2660,61 +2980,20 @@ static struct isl_obj obj_read(__isl_keep isl_stream *s)
 		}
 		return obj;
 	}
+	isl_stream_push_token(s, tok);
 	v = vars_new(s->ctx);
-	if (!v) {
-		isl_stream_push_token(s, tok);
+	if (!v)
 		goto error;
-	}
-	map = isl_map_universe(isl_space_params_alloc(s->ctx, 0));
-	if (tok->type == '[') {
-		isl_stream_push_token(s, tok);
-		map = read_map_tuple(s, map, isl_dim_param, v, 0, 0);
-		if (!map)
-			goto error;
-		tok = isl_stream_next_token(s);
-		if (!tok || tok->type != ISL_TOKEN_TO) {
-			isl_stream_error(s, tok, "expecting '->'");
-			if (tok)
-				isl_stream_push_token(s, tok);
-			goto error;
-		}
-		isl_token_free(tok);
-		tok = isl_stream_next_token(s);
-	}
-	if (!tok || tok->type != '{') {
-		isl_stream_error(s, tok, "expecting '{'");
-		if (tok)
-			isl_stream_push_token(s, tok);
+	map = read_obj_start(s, v);
+	if (!map)
 		goto error;
-	}
-	isl_token_free(tok);
-
-	tok = isl_stream_next_token(s);
-	if (!tok)
-		;
-	else if (tok->type == ISL_TOKEN_IDENT && !strcmp(tok->u.s, "Sym")) {
-		isl_token_free(tok);
-		if (isl_stream_eat(s, '='))
-			goto error;
-		map = read_map_tuple(s, map, isl_dim_param, v, 0, 1);
-		if (!map)
-			goto error;
-	} else
-		isl_stream_push_token(s, tok);
 
 	obj = obj_read_disjuncts(s, v, map);
 	if (obj.type == isl_obj_none || !obj.v)
 		goto error;
 
-	tok = isl_stream_next_token(s);
-	if (tok && tok->type == '}') {
-		isl_token_free(tok);
-	} else {
-		isl_stream_error(s, tok, "unexpected isl_token");
-		if (tok)
-			isl_token_free(tok);
+	if (read_obj_end(s) < 0)
 		goto error;
-	}
 
 	vars_free(v);
 	isl_map_free(map);
@@ -2828,6 +3107,240 @@ __isl_give isl_union_set *isl_stream_read_union_set(__isl_keep isl_stream *s)
 	return extract_union_set(s->ctx, obj);
 }
 
+/* Read a union map (if "type" is isl_obj_map) or
+ * a union set (if "type" is isl_obj_set) from "s" and
+ * call "fn" on each of its disjuncts as soon as it has been read,
+ * without constructing the union.
+ * The disjuncts are passed to "fn" as they appear in the input,
+ * so that several disjuncts may live in the same space.
+ */
+static isl_stat read_union_foreach(__isl_keep isl_stream *s,
+	struct isl_obj_vtable *type,
+	isl_stat (*fn)(__isl_take isl_map *map, void *user), void *user)
+{
+	struct vars *v;
+	isl_map *map;
+
+	v = vars_new(s->ctx);
+	if (!v)
+		return isl_stat_error;
+	map = read_obj_start(s, v);
+	if (!map)
+		goto error;
+
+	while (!isl_stream_next_token_is(s, '}')) {
+		struct isl_obj o;
+
+		o = obj_read_body(s, isl_map_copy(map), v);
+		if (o.type == isl_obj_none || !o.v)
+			goto error;
+		if (o.type != type) {
+			o.type->free(o.v);
+			isl_stream_error(s, NULL, type == isl_obj_map ?
+				    "expecting map" : "expecting set");
+			goto error;
+		}
+		if (fn(o.v, user) < 0)
+			goto error;
+		if (!isl_stream_eat_if_available(s, ';'))
+			break;
+	}
+
+	if (read_obj_end(s) < 0)
+		goto error;
+
+	vars_free(v);
+	isl_map_free(map);
+	return isl_stat_ok;
+error:
+	vars_free(v);
+	isl_map_free(map);
+	return isl_stat_error;
+}
+
+/* Read a union map from "s" and call "fn" on each of its disjuncts
+ * as soon as it has been read.
+ */
+isl_stat isl_stream_read_union_map_foreach_map(__isl_keep isl_stream *s,
+	isl_stat (*fn)(__isl_take isl_map *map, void *user), void *user)
+{
+	if (!s)
+		return isl_stat_error;
+	return read_union_foreach(s, isl_obj_map, fn, user);
+}
+
+/* Data used in read_set_entry.
+ *
+ * "fn" and "user" are the arguments of
+ * isl_stream_read_union_set_foreach_set.
+ */
+struct isl_read_set_data {
+	isl_stat (*fn)(__isl_take isl_set *set, void *user);
+	void *user;
+};
+
+/* Call data->fn on "map", which is known to be a set.
+ */
+static isl_stat read_set_entry(__isl_take isl_map *map, void *user)
+{
+	struct isl_read_set_data *data = user;
+
+	return data->fn(set_from_map(map), data->user);
+}
+
+/* Read a union set from "s" and call "fn" on each of its disjuncts
+ * as soon as it has been read.
+ */
+isl_stat isl_stream_read_union_set_foreach_set(__isl_keep isl_stream *s,
+	isl_stat (*fn)(__isl_take isl_set *set, void *user), void *user)
+{
+	struct isl_read_set_data data = { fn, user };
+
+	if (!s)
+		return isl_stat_error;
+	return read_union_foreach(s, isl_obj_set, &read_set_entry, &data);
+}
+
+/* Return the position of the first character in "str" after "pos"
+ * that is not part of a comment or a quoted string
+ * and that is not a white space character.
+ * The position of the terminating NUL character is returned
+ * if there is no such character.
+ */
+static size_t skip_ignored(const char *str, size_t pos)
+{
+	for (;;) {
+		if (str[pos] == '#') {
+			while (str[pos] && str[pos] != '\n')
+				++pos;
+		} else if (isspace((unsigned char) str[pos])) {
+			++pos;
+		} else
+			return pos;
+	}
+}
+
+/* Return the position of the first character in "str" at or after "pos"
+ * that is equal to one of "stop" at nesting depth zero.
+ * Brackets, parentheses and braces increase the nesting depth,
+ * while the characters in comments and quoted strings are ignored.
+ * The position of the terminating NUL character is returned
+ * if there is no such character or if the nesting becomes negative.
+ */
+static size_t find_top_level(const char *str, size_t pos, const char *stop)
+{
+	int depth = 0;
+
+	for (; str[pos]; ++pos) {
+		char c = str[pos];
+
+		if (depth == 0 && strchr(stop, c))
+			return pos;
+		if (c == '#') {
+			while (str[pos + 1] && str[pos + 1] != '\n')
+				++pos;
+		} else if (c == '"') {
+			while (str[pos + 1] && str[pos + 1] != '"')
+				++pos;
+			if (str[pos + 1])
+				++pos;
+		} else if (c == '(' || c == '[' || c == '{') {
+			depth++;
+		} else if (c == ')' || c == ']' || c == '}') {
+			if (--depth < 0)
+				break;
+		}
+	}
+
+	for (; str[pos]; ++pos)
+		;
+	return pos;
+}
+
+/* Construct a string consisting of the first "prefix_len" characters
+ * of "str", followed by the "len" characters starting at "pos" and
+ * a closing brace and pass it to "fn".
+ */
+static isl_stat call_on_chunk(isl_ctx *ctx, const char *str, size_t prefix_len,
+	size_t pos, size_t len,
+	isl_stat (*fn)(__isl_take char *chunk, void *user), void *user)
+{
+	char *chunk;
+
+	chunk = isl_alloc_array(ctx, char, prefix_len + len + 2);
+	if (!chunk)
+		return isl_stat_error;
+	memcpy(chunk, str, prefix_len);
+	memcpy(chunk + prefix_len, str + pos, len);
+	chunk[prefix_len + len] = '}';
+	chunk[prefix_len + len + 1] = '\0';
+
+	return fn(chunk, user);
+}
+
+/* Split the textual description "str" of a union map or union set
+ * into chunks of roughly "size" characters and call "fn" on each of them.
+ * Each chunk is itself a valid description of a union map or union set,
+ * consisting of the parameter declaration of "str" (if any),
+ * followed by a sequence of consecutive disjuncts of "str" in braces.
+ * The union of the objects described by the chunks is therefore equal
+ * to the object described by "str".
+ * The chunks can be parsed independently, e.g., in separate isl_ctx
+ * objects on different threads.
+ *
+ * The input is split at the semicolons that separate the disjuncts
+ * at the outermost nesting level.  If "str" does not have the form
+ * of a (possibly parametric) sequence of disjuncts in braces or
+ * if it includes a declaration of symbolic constants,
+ * then "fn" is called on a copy of the entire input.
+ */
+isl_stat isl_union_map_str_foreach_chunk(isl_ctx *ctx, const char *str,
+	size_t size, isl_stat (*fn)(__isl_take char *chunk, void *user),
+	void *user)
+{
+	size_t prefix_len, start, pos, end;
+	char *chunk;
+
+	if (!str)
+		return isl_stat_error;
+
+	prefix_len = find_top_level(str, 0, "{;:");
+	if (str[prefix_len] != '{')
+		goto whole;
+	prefix_len++;
+	start = skip_ignored(str, prefix_len);
+	if (!strncmp(str + start, "Sym", 3) &&
+	    !isalnum((unsigned char) str[start + 3]) && str[start + 3] != '_')
+		goto whole;
+	end = find_top_level(str, prefix_len, "}");
+	if (str[end] != '}')
+		goto whole;
+
+	start = pos = prefix_len;
+	do {
+		pos = find_top_level(str, pos, ";}");
+		if (pos >= end) {
+			pos = end;
+		} else {
+			++pos;
+			if (pos - start < size)
+				continue;
+		}
+		if (call_on_chunk(ctx, str, prefix_len, start, pos - start,
+				fn, user) < 0)
+			return isl_stat_error;
+		start = pos;
+	} while (pos < end);
+
+	return isl_stat_ok;
+whole:
+	chunk = isl_alloc_array(ctx, char, strlen(str) + 1);
+	if (!chunk)
+		return isl_stat_error;
+	strcpy(chunk, str);
+	return fn(chunk, user);
+}
+
 static __isl_give isl_basic_map *basic_map_read(__isl_keep isl_stream *s)
 {
 	struct isl_obj obj;
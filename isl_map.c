@@ -44,6 +44,7 @@
 #include <isl_options_private.h>
 #include <isl_morph.h>
 #include <isl_val_private.h>
+#include <isl_hash_private.h>
 
 #include <bset_to_bmap.c>
 #include <bset_from_bmap.c>
@@ -10458,6 +10459,80 @@ uint32_t isl_set_get_hash(__isl_keep isl_set *set)
 	return isl_map_get_hash(set_to_map(set));
 }
 
+/* Normalize "map", even if it was marked normalized before
+ * some of its basic maps were modified in place.
+ */
+static __isl_give isl_map *renormalize(__isl_take isl_map *map)
+{
+	map = isl_map_cow(map);
+	if (!map)
+		return NULL;
+	ISL_F_CLR(map, ISL_MAP_NORMALIZED);
+	return isl_map_normalize(map);
+}
+
+/* Bring "map" into a canonical form.
+ *
+ * The map is first normalized such that the subsequent operations
+ * do not depend on the order of the disjuncts, the constraints or
+ * the local variables in the representation of "map".
+ * Then implicit equalities are detected, redundant constraints
+ * are removed and pairs of basic maps are coalesced,
+ * normalizing the result after each step.
+ *
+ * Two maps with the same representation up to the order
+ * of the disjuncts, constraints and local variables
+ * therefore have the same canonical form.
+ * Equal maps with different representations often also have
+ * the same canonical form, but this is not guaranteed.
+ */
+__isl_give isl_map *isl_map_canonicalize(__isl_take isl_map *map)
+{
+	map = renormalize(map);
+	map = isl_map_remove_redundancies(map);
+	map = renormalize(map);
+	map = isl_map_coalesce(map);
+	map = renormalize(map);
+	return map;
+}
+
+__isl_give isl_set *isl_set_canonicalize(__isl_take isl_set *set)
+{
+	return set_from_map(isl_map_canonicalize(set_to_map(set)));
+}
+
+/* Compute a 64-bit hash value that digests the canonical form of "map"
+ * and store it in "hash".
+ *
+ * Unlike isl_map_get_hash, the hash value also depends on the space
+ * of "map" and it is computed from the textual representation
+ * of the canonical form such that it does not depend on
+ * the addresses of any objects.  It therefore remains the same
+ * across different runs and different isl_ctx objects.
+ */
+isl_stat isl_map_get_stable_hash(__isl_keep isl_map *map, uint64_t *hash)
+{
+	char *str;
+
+	if (!hash)
+		isl_die(isl_map_get_ctx(map), isl_error_invalid,
+			"no hash value pointer", return isl_stat_error);
+	map = isl_map_canonicalize(isl_map_copy(map));
+	str = isl_map_to_str(map);
+	isl_map_free(map);
+	if (!str)
+		return isl_stat_error;
+	*hash = isl_hash64_string(isl_hash64_init(), str);
+	free(str);
+
+	return isl_stat_ok;
+}
+
+isl_stat isl_set_get_stable_hash(__isl_keep isl_set *set, uint64_t *hash)
+{
+	return isl_map_get_stable_hash(set_to_map(set), hash);
+}
+
 /* Return the number of basic maps in the (current) representation of "map".
  */
 int isl_map_n_basic_map(__isl_keep isl_map *map)
@@ -35,6 +35,8 @@ struct isl_options {
 
 	int			coalesce_bounded_wrapping;
 
+	int			trusted_input;
+
 	int			schedule_max_coefficient;
 	int			schedule_max_constant_term;
 	int			schedule_parametric;
@@ -48,13 +50,18 @@ struct isl_options {
 	unsigned		schedule_algorithm;
 	int			schedule_carry_self_first;
 	int			schedule_serialize_sccs;
+	int			schedule_max_operations;
+	char			*schedule_cache_dir;
+	int			schedule_cache_size;
 
 	int			tile_scale_tile_loops;
 	int			tile_shift_point_loops;
+	int			tile_cache_size;
 
 	char			*ast_iterator_type;
 	int			ast_always_print_block;
 	int			ast_print_macro_once;
+	int			ast_print_openmp;
 
 	int			ast_build_atomic_upper_bound;
 	int			ast_build_prefer_pdiv;
@@ -65,6 +72,7 @@ struct isl_options {
 	int			ast_build_scale_strides;
 	int			ast_build_allow_else;
 	int			ast_build_allow_or;
+	int			ast_build_share_exprs;
 
 	int			print_stats;
 	unsigned long		max_operations;
@@ -33,6 +33,7 @@
 #include <isl/ast_build.h>
 #include <isl_sort.h>
 #include <isl_output_private.h>
+#include <isl_binary_private.h>
 
 #include <bset_to_bmap.c>
 #include <set_to_map.c>
@@ -1487,6 +1488,8 @@ __isl_give isl_printer *isl_printer_print_basic_map(__isl_take isl_printer *p,
 		return isl_basic_map_print_isl(bmap, p, 0);
 	else if (p->output_format == ISL_FORMAT_OMEGA)
 		return basic_map_print_omega(bmap, p);
+	else if (p->output_format == ISL_FORMAT_BINARY)
+		return isl_basic_map_print_binary(bmap, p);
 	isl_assert(bmap->ctx, 0, goto error);
 error:
 	isl_printer_free(p);
@@ -1509,6 +1512,8 @@ __isl_give isl_printer *isl_printer_print_basic_set(__isl_take isl_printer *p,
 		return bset_print_constraints_polylib(bset, p);
 	else if (p->output_format == ISL_FORMAT_OMEGA)
 		return basic_set_print_omega(bset, p);
+	else if (p->output_format == ISL_FORMAT_BINARY)
+		return isl_basic_map_print_binary(bset_to_bmap(bset), p);
 	isl_assert(p->ctx, 0, goto error);
 error:
 	isl_printer_free(p);
@@ -1530,6 +1535,8 @@ __isl_give isl_printer *isl_printer_print_set(__isl_take isl_printer *p,
 		return isl_set_print_omega(set, p);
 	else if (p->output_format == ISL_FORMAT_LATEX)
 		return isl_map_print_latex(set_to_map(set), p);
+	else if (p->output_format == ISL_FORMAT_BINARY)
+		return isl_map_print_binary(set_to_map(set), p);
 	isl_assert(set->ctx, 0, goto error);
 error:
 	isl_printer_free(p);
@@ -1552,6 +1559,8 @@ __isl_give isl_printer *isl_printer_print_map(__isl_take isl_printer *p,
 		return isl_map_print_omega(map, p);
 	else if (p->output_format == ISL_FORMAT_LATEX)
 		return isl_map_print_latex(map, p);
+	else if (p->output_format == ISL_FORMAT_BINARY)
+		return isl_map_print_binary(map, p);
 	isl_assert(map->ctx, 0, goto error);
 error:
 	isl_printer_free(p);
@@ -1655,6 +1664,8 @@ __isl_give isl_printer *isl_printer_print_union_map(__isl_take isl_printer *p,
 		return isl_union_map_print_isl(umap, p);
 	if (p->output_format == ISL_FORMAT_LATEX)
 		return isl_union_map_print_latex(umap, p);
+	if (p->output_format == ISL_FORMAT_BINARY)
+		return isl_union_map_print_binary(umap, p);
 
 	isl_die(p->ctx, isl_error_invalid,
 		"invalid output format for isl_union_map", goto error);
@@ -1673,6 +1684,8 @@ __isl_give isl_printer *isl_printer_print_union_set(__isl_take isl_printer *p,
 		return isl_union_map_print_isl(uset_to_umap(uset), p);
 	if (p->output_format == ISL_FORMAT_LATEX)
 		return isl_union_map_print_latex(uset_to_umap(uset), p);
+	if (p->output_format == ISL_FORMAT_BINARY)
+		return isl_union_map_print_binary(uset_to_umap(uset), p);
 
 	isl_die(p->ctx, isl_error_invalid,
 		"invalid output format for isl_union_set", goto error);
@@ -2837,6 +2850,8 @@ __isl_give isl_printer *isl_printer_print_pw_aff(__isl_take isl_printer *p,
 		return print_pw_aff_isl(p, pwaff);
 	else if (p->output_format == ISL_FORMAT_C)
 		return print_pw_aff_c(p, pwaff);
+	else if (p->output_format == ISL_FORMAT_BINARY)
+		return isl_pw_aff_print_binary(pwaff, p);
 	isl_die(p->ctx, isl_error_unsupported, "unsupported output format",
 		goto error);
 error:
@@ -2975,6 +2990,8 @@ __isl_give isl_printer *isl_printer_print_multi_aff(__isl_take isl_printer *p,
 
 	if (p->output_format == ISL_FORMAT_ISL)
 		return print_multi_aff_isl(p, maff);
+	else if (p->output_format == ISL_FORMAT_BINARY)
+		return isl_multi_aff_print_binary(maff, p);
 	isl_die(p->ctx, isl_error_unsupported, "unsupported output format",
 		goto error);
 error:
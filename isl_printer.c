@@ -49,6 +49,27 @@ static __isl_give isl_printer *file_print_isl_int(__isl_take isl_printer *p, isl
 	return p;
 }
 
+/* Pass the contents of the buffer of the callback printer "p"
+ * to the user callback and clear the buffer.
+ * The buffer is cleared even if the callback fails such that
+ * the same output is not passed again when the printer is freed.
+ */
+static isl_stat write_buf(__isl_keep isl_printer *p)
+{
+	isl_stat r = isl_stat_ok;
+
+	if (p->buf_n > 0)
+		r = p->write(p->buf, p->buf_n, p->write_user);
+	p->buf_n = 0;
+	p->buf[0] = '\0';
+
+	return r;
+}
+
+/* Make room for "extra" more characters in the buffer of "p".
+ * For a callback printer, the buffer is first passed to the callback
+ * and only grown if it cannot hold "extra" characters by itself.
+ */
 static int grow_buf(__isl_keep isl_printer *p, int extra)
 {
 	int new_size;
@@ -56,6 +77,14 @@ static int grow_buf(__isl_keep isl_printer *p, int extra)
 
 	if (p->buf_size == 0)
 		return -1;
+	if (p->write) {
+		if (write_buf(p) < 0) {
+			p->buf_size = 0;
+			return -1;
+		}
+		if (extra + 1 < p->buf_size)
+			return 0;
+	}
 
 	new_size = ((p->buf_n + extra + 1) * 3) / 2;
 	new_buf = isl_realloc_array(p->ctx, p->buf, char, new_size);
@@ -93,6 +122,7 @@ static __isl_give isl_printer *str_print_indent(__isl_take isl_printer *p,
 		goto error;
 	for (i = 0; i < indent; ++i)
 		p->buf[p->buf_n++] = ' ';
+	p->buf[p->buf_n] = '\0';
 	return p;
 error:
 	isl_printer_free(p);
@@ -124,6 +154,15 @@ static __isl_give isl_printer *str_flush(__isl_take isl_printer *p)
 	return p;
 }
 
+/* Pass the output that has been buffered so far to the user callback.
+ */
+static __isl_give isl_printer *callback_flush(__isl_take isl_printer *p)
+{
+	if (write_buf(p) < 0)
+		return isl_printer_free(p);
+	return p;
+}
+
 static __isl_give isl_printer *str_print_str(__isl_take isl_printer *p,
 	const char *s)
 {
@@ -213,6 +252,21 @@ static struct isl_printer_ops str_ops = {
 	str_flush
 };
 
+/* A callback printer collects its output in the same way
+ * as a string printer, except that the output is passed to
+ * the user callback whenever the buffer is full (see grow_buf) or
+ * when the printer is flushed.
+ */
+static struct isl_printer_ops callback_ops = {
+	str_start_line,
+	str_end_line,
+	str_print_double,
+	str_print_int,
+	str_print_isl_int,
+	str_print_str,
+	callback_flush
+};
+
 __isl_give isl_printer *isl_printer_to_file(isl_ctx *ctx, FILE *file)
 {
 	struct isl_printer *p = isl_calloc_type(ctx, struct isl_printer);
@@ -236,21 +290,25 @@ __isl_give isl_printer *isl_printer_to_file(isl_ctx *ctx, FILE *file)
 	return p;
 }
 
-__isl_give isl_printer *isl_printer_to_str(isl_ctx *ctx)
+/* Allocate a printer with operations "ops" that prints
+ * to a buffer of initial size "size".
+ */
+static __isl_give isl_printer *alloc_buf_printer(isl_ctx *ctx,
+	struct isl_printer_ops *ops, int size)
 {
 	struct isl_printer *p = isl_calloc_type(ctx, struct isl_printer);
 	if (!p)
 		return NULL;
 	p->ctx = ctx;
 	isl_ctx_ref(p->ctx);
-	p->ops = &str_ops;
+	p->ops = ops;
 	p->file = NULL;
-	p->buf = isl_alloc_array(ctx, char, 256);
+	p->buf = isl_alloc_array(ctx, char, size);
 	if (!p->buf)
 		goto error;
 	p->buf_n = 0;
 	p->buf[0] = '\0';
-	p->buf_size = 256;
+	p->buf_size = size;
 	p->indent = 0;
 	p->output_format = ISL_FORMAT_ISL;
 	p->indent_prefix = NULL;
@@ -265,10 +323,44 @@ error:
 	return NULL;
 }
 
+__isl_give isl_printer *isl_printer_to_str(isl_ctx *ctx)
+{
+	return alloc_buf_printer(ctx, &str_ops, 256);
+}
+
+/* The size of the buffer of a callback printer.
+ * The buffer is only grown beyond this size if a single piece of output
+ * does not fit.
+ */
+#define ISL_PRINTER_CALLBACK_SIZE	4096
+
+/* Create a printer that passes its output to "write" in chunks,
+ * without ever constructing the entire output in memory.
+ * "write" is called with "user" as its final argument
+ * whenever the internal buffer is full, when the printer is flushed and
+ * when the printer is freed.
+ * If "write" returns isl_stat_error, then the printer is freed.
+ */
+__isl_give isl_printer *isl_printer_to_callback(isl_ctx *ctx,
+	isl_stat (*write)(const char *buf, size_t len, void *user), void *user)
+{
+	isl_printer *p;
+
+	p = alloc_buf_printer(ctx, &callback_ops, ISL_PRINTER_CALLBACK_SIZE);
+	if (!p)
+		return NULL;
+	p->write = write;
+	p->write_user = user;
+
+	return p;
+}
+
 __isl_null isl_printer *isl_printer_free(__isl_take isl_printer *p)
 {
 	if (!p)
 		return NULL;
+	if (p->write && p->buf)
+		write_buf(p);
 	free(p->buf);
 	free(p->indent_prefix);
 	free(p->prefix);
@@ -686,6 +778,30 @@ __isl_give char *isl_printer_get_str(__isl_keep isl_printer *printer)
 	return strdup(printer->buf);
 }
 
+/* Return the string printed to the string printer "p" and free "p".
+ * In contrast to isl_printer_get_str, the buffer of "p"
+ * is handed over to the caller instead of being copied.
+ */
+__isl_give char *isl_printer_take_str(__isl_take isl_printer *p)
+{
+	char *s;
+
+	if (!p)
+		return NULL;
+	if (p->ops != &str_ops)
+		isl_die(isl_printer_get_ctx(p), isl_error_invalid,
+			"isl_printer_take_str can only be called on a string "
+			"printer", goto error);
+	s = p->buf;
+	p->buf = NULL;
+	isl_printer_free(p);
+
+	return s;
+error:
+	isl_printer_free(p);
+	return NULL;
+}
+
 __isl_give isl_printer *isl_printer_flush(__isl_take isl_printer *p)
 {
 	if (!p)
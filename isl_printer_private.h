@@ -7,7 +7,12 @@
 
 struct isl_printer_ops;
 
-/* A printer to a file or a string.
+/* A printer to a file, a string or a user callback.
+ *
+ * For a string printer, "buf" contains the output printed so far.
+ * For a callback printer, "buf" contains the output that has not
+ * been passed to "write" yet.  Whenever "buf" is full, its contents
+ * are passed to "write", along with "write_user", and "buf" is cleared.
  *
  * "dump" is set if the printing is performed from an isl_*_dump function.
  *
@@ -30,6 +35,8 @@ struct isl_printer {
 	int		buf_n;
 	int		buf_size;
 	char		*buf;
+	isl_stat	(*write)(const char *buf, size_t len, void *user);
+	void		*write_user;
 	int		indent;
 	int		output_format;
 	int		dump;
@@ -48,5 +55,6 @@ struct isl_printer {
 
 __isl_give isl_printer *isl_printer_set_dump(__isl_take isl_printer *p,
 	int dump);
+__isl_give char *isl_printer_take_str(__isl_take isl_printer *p);
 
 #endif
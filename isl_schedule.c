@@ -682,3 +682,8 @@ __isl_give isl_printer *isl_printer_print_schedule(__isl_take isl_printer *p,
 #undef BASE
 #define BASE schedule
 #include <print_templ_yaml.c>
+
+#undef BASE
+#define BASE schedule
+
+#include <isl_list_templ.c>
@@ -0,0 +1,343 @@
+/*
+ * Use of this software is governed by the MIT license
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "isl_config.h"
+#if HAVE_DECL_MKSTEMP
+#include <unistd.h>
+#elif HAVE_DECL__GETPID
+#include <process.h>
+#endif
+#include <isl_ctx_private.h>
+#include <isl_options_private.h>
+#include <isl_schedule_constraints.h>
+#include <isl_schedule_cache.h>
+#include <isl_hash_private.h>
+#include <isl_stream_private.h>
+#include <isl/id.h>
+#include <isl/map.h>
+#include <isl/union_map.h>
+#include <isl/union_set.h>
+#include <isl/printer.h>
+#include <isl/version.h>
+
+#include <uset_to_umap.c>
+
+/* A schedule cache directory contains at most schedule_cache_size
+ * entries.  The entry for a key is stored in the file
+ * isl-schedule-<slot>.yaml in this directory, with <slot> the key
+ * modulo the number of entries, such that a new entry replaces
+ * any previous entry with a key that maps to the same slot.
+ * The first line of the file contains the full key
+ * in the format below, followed by the schedule in YAML format.
+ */
+#define CACHE_HEADER	"# isl schedule cache %08lx%08lx\n"
+
+/* Is the identifier "id" (if any) attached to a user pointer?
+ * A schedule read back from the cache would not have
+ * such a user pointer.
+ */
+static int id_has_user(__isl_take isl_id *id)
+{
+	int has_user;
+
+	if (!id)
+		return 0;
+	has_user = isl_id_get_user(id) != NULL;
+	isl_id_free(id);
+
+	return has_user;
+}
+
+/* Are none of the identifiers of the tuple and the parameters
+ * of the set "set" attached to a user pointer?
+ */
+static isl_bool has_no_user_ids(__isl_keep isl_map *set, void *user)
+{
+	int i, n;
+
+	if (isl_map_has_tuple_id(set, isl_dim_out) &&
+	    id_has_user(isl_map_get_tuple_id(set, isl_dim_out)))
+		return isl_bool_false;
+	n = isl_map_dim(set, isl_dim_param);
+	for (i = 0; i < n; ++i) {
+		if (!isl_map_has_dim_id(set, isl_dim_param, i))
+			continue;
+		if (id_has_user(isl_map_get_dim_id(set, isl_dim_param, i)))
+			return isl_bool_false;
+	}
+
+	return isl_bool_true;
+}
+
+/* Should the schedule cache be used for computing a schedule for "sc"?
+ *
+ * This is only the case if a schedule cache directory has been set and
+ * if none of the identifiers in the domain of "sc" are attached
+ * to a user pointer, since a cached schedule only preserves
+ * the names of identifiers.
+ */
+isl_bool isl_schedule_cache_is_enabled(__isl_keep isl_schedule_constraints *sc)
+{
+	isl_ctx *ctx;
+	isl_union_set *domain;
+	isl_bool enabled;
+
+	ctx = isl_schedule_constraints_get_ctx(sc);
+	if (!ctx)
+		return isl_bool_error;
+	if (!ctx->opt->schedule_cache_dir || !*ctx->opt->schedule_cache_dir ||
+	    ctx->opt->schedule_cache_size <= 0)
+		return isl_bool_false;
+
+	domain = isl_schedule_constraints_get_domain(sc);
+	enabled = isl_union_map_every_map(uset_to_umap(domain),
+						&has_no_user_ids, NULL);
+	isl_union_set_free(domain);
+
+	return enabled;
+}
+
+/* Compute a key for the schedule computed for "sc" and
+ * store it in "key".
+ *
+ * The key digests the isl version, the options that affect
+ * the scheduler and the canonical form of "sc".
+ * The schedule_max_operations option is not included since
+ * schedules computed using any of the fallback strategies
+ * are not stored in the cache.
+ */
+isl_stat isl_schedule_cache_get_key(__isl_keep isl_schedule_constraints *sc,
+	uint64_t *key)
+{
+	isl_ctx *ctx;
+	struct isl_options *opt;
+	char buffer[200];
+	uint64_t hash, sc_hash;
+
+	ctx = isl_schedule_constraints_get_ctx(sc);
+	if (!ctx)
+		return isl_stat_error;
+	opt = ctx->opt;
+
+	hash = isl_hash64_init();
+	hash = isl_hash64_string(hash, isl_version());
+	snprintf(buffer, sizeof(buffer),
+		"%d %d %d %d %d %d %d %d %d %d %u %d %d %d",
+		opt->schedule_max_coefficient, opt->schedule_max_constant_term,
+		opt->schedule_parametric, opt->schedule_outer_coincidence,
+		opt->schedule_maximize_band_depth,
+		opt->schedule_maximize_coincidence, opt->schedule_split_scaled,
+		opt->schedule_treat_coalescing,
+		opt->schedule_separate_components,
+		opt->schedule_whole_component, opt->schedule_algorithm,
+		opt->schedule_carry_self_first, opt->schedule_serialize_sccs,
+		opt->coalesce_bounded_wrapping);
+	hash = isl_hash64_string(hash, buffer);
+	if (isl_schedule_constraints_get_stable_hash(sc, &sc_hash) < 0)
+		return isl_stat_error;
+	*key = isl_hash64_uint64(hash, sc_hash);
+
+	return isl_stat_ok;
+}
+
+/* Return the name of the file in the schedule cache directory
+ * that holds the entry for "key", with "suffix" appended.
+ */
+static char *cache_file_name(isl_ctx *ctx, uint64_t key, const char *suffix)
+{
+	const char *dir = ctx->opt->schedule_cache_dir;
+	unsigned long slot;
+	size_t len;
+	char *name;
+
+	slot = key % ctx->opt->schedule_cache_size;
+	len = strlen(dir) + strlen(suffix) + 40;
+	name = isl_alloc_array(ctx, char, len);
+	if (!name)
+		return NULL;
+	snprintf(name, len, "%s/isl-schedule-%lu.yaml%s", dir, slot, suffix);
+
+	return name;
+}
+
+/* Print the header of a cache entry for "key" to "buffer".
+ */
+static void print_header(char *buffer, size_t size, uint64_t key)
+{
+	snprintf(buffer, size, CACHE_HEADER,
+		(unsigned long) (key >> 32), (unsigned long) (key & 0xFFFFFFFF));
+}
+
+/* Look for a schedule with key "key" in the schedule cache directory.
+ * Return NULL if no such schedule is available.
+ *
+ * If the entry cannot be read, then it is treated as missing
+ * and any error that occurred while reading it is cleared.
+ * The entry is read from a silent stream and
+ * the on_error option is temporarily set to continue
+ * such that no such error is reported either.
+ */
+__isl_give isl_schedule *isl_schedule_cache_lookup(isl_ctx *ctx, uint64_t key)
+{
+	char *name;
+	char expected[40], header[40];
+	FILE *file;
+	isl_schedule *schedule = NULL;
+	isl_stream *s;
+
+	name = cache_file_name(ctx, key, "");
+	if (!name)
+		return NULL;
+	file = fopen(name, "r");
+	free(name);
+
+	print_header(expected, sizeof(expected), key);
+	if (file && fgets(header, sizeof(header), file) &&
+	    !strcmp(header, expected)) {
+		int on_error = isl_options_get_on_error(ctx);
+
+		isl_options_set_on_error(ctx, ISL_ON_ERROR_CONTINUE);
+		s = isl_stream_new_file(ctx, file);
+		isl_stream_set_silent(s, 1);
+		if (s)
+			schedule = isl_stream_read_schedule(s);
+		isl_stream_free(s);
+		isl_options_set_on_error(ctx, on_error);
+		if (!schedule)
+			isl_ctx_reset_error(ctx);
+	}
+	if (file)
+		fclose(file);
+
+	if (schedule)
+		ctx->schedule_cache_hits++;
+	else
+		ctx->schedule_cache_misses++;
+
+	return schedule;
+}
+
+#if HAVE_DECL_MKSTEMP
+
+/* Create a temporary file in the schedule cache directory
+ * for writing the entry for "key" and open it for writing.
+ * "tmp_name" is the name of the entry with a suffix
+ * that is replaced by mkstemp to form a unique file name.
+ */
+static FILE *open_tmp(isl_ctx *ctx, uint64_t key, char **tmp_name)
+{
+	int fd;
+	FILE *file;
+
+	*tmp_name = cache_file_name(ctx, key, ".XXXXXX");
+	if (!*tmp_name)
+		return NULL;
+	fd = mkstemp(*tmp_name);
+	if (fd < 0)
+		return NULL;
+	file = fdopen(fd, "w");
+	if (!file) {
+		close(fd);
+		remove(*tmp_name);
+	}
+
+	return file;
+}
+
+#else
+
+/* Create a temporary file in the schedule cache directory
+ * for writing the entry for "key" and open it for writing.
+ * The name of the file is stored in "tmp_name".
+ * mkstemp is not available, so the process identifier,
+ * if available, is used to distinguish the temporary files
+ * of different processes.
+ */
+static FILE *open_tmp(isl_ctx *ctx, uint64_t key, char **tmp_name)
+{
+	char suffix[40];
+
+#if HAVE_DECL__GETPID
+	snprintf(suffix, sizeof(suffix), ".%d.tmp", (int) _getpid());
+#else
+	snprintf(suffix, sizeof(suffix), ".tmp");
+#endif
+	*tmp_name = cache_file_name(ctx, key, suffix);
+	if (!*tmp_name)
+		return NULL;
+	return fopen(*tmp_name, "w");
+}
+
+#endif
+
+/* Store "schedule" under key "key" in the schedule cache directory.
+ *
+ * The entry is first written to a temporary file in the same directory
+ * with a name that is unique to this process.
+ * This file is then renamed such that other processes sharing
+ * the same directory never see a partially written entry.
+ * Failure to write the entry is not considered to be an error.
+ */
+isl_stat isl_schedule_cache_store(isl_ctx *ctx, uint64_t key,
+	__isl_keep isl_schedule *schedule)
+{
+	char *name, *tmp_name = NULL;
+	char header[40];
+	FILE *file;
+	isl_printer *p;
+	int ok;
+
+	if (!schedule)
+		return isl_stat_error;
+
+	name = cache_file_name(ctx, key, "");
+	file = name ? open_tmp(ctx, key, &tmp_name) : NULL;
+	if (!file) {
+		free(name);
+		free(tmp_name);
+		return name && tmp_name ? isl_stat_ok : isl_stat_error;
+	}
+
+	print_header(header, sizeof(header), key);
+	fputs(header, file);
+	p = isl_printer_to_file(ctx, file);
+	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_FLOW);
+	p = isl_printer_print_schedule(p, schedule);
+	p = isl_printer_end_line(p);
+	ok = p != NULL;
+	isl_printer_free(p);
+	ok = !ferror(file) && ok;
+	if (fclose(file) != 0)
+		ok = 0;
+
+	if (!ok || rename(tmp_name, name) != 0)
+		remove(tmp_name);
+	free(name);
+	free(tmp_name);
+
+	return isl_stat_ok;
+}
+
+/* Return the number of schedule computations that were found
+ * in the schedule cache directory.
+ */
+int isl_ctx_get_schedule_cache_hits(isl_ctx *ctx)
+{
+	if (!ctx)
+		return -1;
+	return ctx->schedule_cache_hits;
+}
+
+/* Return the number of schedule computations that were not found
+ * in the schedule cache directory.
+ */
+int isl_ctx_get_schedule_cache_misses(isl_ctx *ctx)
+{
+	if (!ctx)
+		return -1;
+	return ctx->schedule_cache_misses;
+}
@@ -0,0 +1,13 @@
+#ifndef ISL_SCHEDULE_CACHE_H
+#define ISL_SCHEDULE_CACHE_H
+
+#include <isl/schedule.h>
+
+isl_bool isl_schedule_cache_is_enabled(__isl_keep isl_schedule_constraints *sc);
+isl_stat isl_schedule_cache_get_key(__isl_keep isl_schedule_constraints *sc,
+	uint64_t *key);
+__isl_give isl_schedule *isl_schedule_cache_lookup(isl_ctx *ctx, uint64_t key);
+isl_stat isl_schedule_cache_store(isl_ctx *ctx, uint64_t key,
+	__isl_keep isl_schedule *schedule);
+
+#endif
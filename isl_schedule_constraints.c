@@ -16,6 +16,7 @@
 #include <isl/union_set.h>
 #include <isl/union_map.h>
 #include <isl/stream.h>
+#include <isl_hash_private.h>
 
 /* The constraints that need to be satisfied by a schedule on "domain".
  *
@@ -37,14 +38,125 @@
  * are local within the band.
  * A dependence is local within a band if domain and range are mapped
  * to the same schedule point by the band.
+ *
+ * "coef_cache" caches the duals of the dependence relations computed
+ * by the scheduler.  It is shared by copies of "sc".
+ * The duals depend on the instance set of the nodes involved
+ * (through the compression and the sizes of the instance set),
+ * so the cache is replaced whenever "domain" or "context" are modified.
  */
 struct isl_schedule_constraints {
 	isl_union_set *domain;
 	isl_set *context;
 
 	isl_union_map *constraint[isl_edge_last + 1];
+
+	struct isl_sched_coef_cache *coef_cache;
 };
 
+/* Return a new reference to "cache".
+ */
+struct isl_sched_coef_cache *isl_sched_coef_cache_copy(
+	struct isl_sched_coef_cache *cache)
+{
+	if (!cache)
+		return NULL;
+
+	cache->ref++;
+	return cache;
+}
+
+/* Free a reference to "cache".
+ */
+struct isl_sched_coef_cache *isl_sched_coef_cache_free(
+	struct isl_sched_coef_cache *cache)
+{
+	if (!cache)
+		return NULL;
+
+	if (--cache->ref > 0)
+		return NULL;
+
+	isl_map_to_basic_set_free(cache->intra);
+	isl_map_to_basic_set_free(cache->intra_param);
+	isl_map_to_basic_set_free(cache->inter);
+	free(cache);
+
+	return NULL;
+}
+
+/* Allocate an empty cache for the duals of "n" dependence relations.
+ */
+static struct isl_sched_coef_cache *isl_sched_coef_cache_alloc(isl_ctx *ctx,
+	int n)
+{
+	struct isl_sched_coef_cache *cache;
+
+	cache = isl_calloc_type(ctx, struct isl_sched_coef_cache);
+	if (!cache)
+		return NULL;
+
+	cache->ref = 1;
+	cache->intra = isl_map_to_basic_set_alloc(ctx, 2 * n);
+	cache->intra_param = isl_map_to_basic_set_alloc(ctx, 2 * n);
+	cache->inter = isl_map_to_basic_set_alloc(ctx, 2 * n);
+	if (!cache->intra || !cache->intra_param || !cache->inter)
+		return isl_sched_coef_cache_free(cache);
+
+	return cache;
+}
+
+/* Return a reference to the cache of duals of dependence relations
+ * associated to "sc".
+ */
+struct isl_sched_coef_cache *isl_schedule_constraints_get_coef_cache(
+	__isl_keep isl_schedule_constraints *sc)
+{
+	if (!sc)
+		return NULL;
+
+	return isl_sched_coef_cache_copy(sc->coef_cache);
+}
+
+/* Associate an empty cache of duals of dependence relations to "sc".
+ */
+static __isl_give isl_schedule_constraints *init_coef_cache(
+	__isl_take isl_schedule_constraints *sc)
+{
+	isl_ctx *ctx;
+
+	if (!sc)
+		return NULL;
+
+	ctx = isl_schedule_constraints_get_ctx(sc);
+	sc->coef_cache = isl_sched_coef_cache_alloc(ctx,
+					isl_schedule_constraints_n_map(sc));
+	if (!sc->coef_cache)
+		return isl_schedule_constraints_free(sc);
+
+	return sc;
+}
+
+/* Replace the cache of duals of dependence relations associated to "sc",
+ * if any, by an empty cache.
+ * This needs to be called whenever the domain or the context
+ * of "sc" is modified.  Copies of "sc" created before the modification
+ * keep on using the original cache.
+ * If "sc" does not have a cache yet, then it is still being constructed
+ * and the cache will be created by isl_schedule_constraints_init.
+ */
+static __isl_give isl_schedule_constraints *reset_coef_cache(
+	__isl_take isl_schedule_constraints *sc)
+{
+	if (!sc)
+		return NULL;
+	if (!sc->coef_cache)
+		return sc;
+
+	sc->coef_cache = isl_sched_coef_cache_free(sc->coef_cache);
+	return init_coef_cache(sc);
+}
+
 __isl_give isl_schedule_constraints *isl_schedule_constraints_copy(
 	__isl_keep isl_schedule_constraints *sc)
 {
@@ -67,6 +179,7 @@ __isl_give isl_schedule_constraints *isl_schedule_constraints_copy(
 		if (!sc_copy->constraint[i])
 			return isl_schedule_constraints_free(sc_copy);
 	}
+	sc_copy->coef_cache = isl_sched_coef_cache_copy(sc->coef_cache);
 
 	return sc_copy;
 }
@@ -111,7 +224,7 @@ static __isl_give isl_schedule_constraints *isl_schedule_constraints_init(
 	if (!sc->domain || !sc->context)
 		return isl_schedule_constraints_free(sc);
 
-	return sc;
+	return init_coef_cache(sc);
 }
 
 /* Construct an isl_schedule_constraints object for computing a schedule
@@ -150,7 +263,7 @@ static __isl_give isl_schedule_constraints *isl_schedule_constraints_set_domain(
 	isl_union_set_free(sc->domain);
 	sc->domain = domain;
 
-	return sc;
+	return reset_coef_cache(sc);
 error:
 	isl_schedule_constraints_free(sc);
 	isl_union_set_free(domain);
@@ -168,7 +281,7 @@ __isl_give isl_schedule_constraints *isl_schedule_constraints_set_context(
 	isl_set_free(sc->context);
 	sc->context = context;
 
-	return sc;
+	return reset_coef_cache(sc);
 error:
 	isl_schedule_constraints_free(sc);
 	isl_set_free(context);
@@ -249,6 +362,7 @@ __isl_null isl_schedule_constraints *isl_schedule_constraints_free(
 	isl_set_free(sc->context);
 	for (i = isl_edge_first; i <= isl_edge_last; ++i)
 		isl_union_map_free(sc->constraint[i]);
+	isl_sched_coef_cache_free(sc->coef_cache);
 
 	free(sc);
 
@@ -442,7 +556,7 @@ __isl_give isl_schedule_constraints *isl_schedule_constraints_apply(
 	if (!sc->domain)
 		return isl_schedule_constraints_free(sc);
 
-	return sc;
+	return reset_coef_cache(sc);
 error:
 	isl_schedule_constraints_free(sc);
 	isl_union_map_free(umap);
@@ -748,3 +862,33 @@ int isl_schedule_constraints_n_map(__isl_keep isl_schedule_constraints *sc)
 
 	return n;
 }
+
+/* Compute a 64-bit hash value that digests the canonical forms
+ * of the domain, the context and the constraints of "sc" and
+ * that remains the same across different runs and
+ * store it in "hash".
+ */
+isl_stat isl_schedule_constraints_get_stable_hash(
+	__isl_keep isl_schedule_constraints *sc, uint64_t *hash)
+{
+	enum isl_edge_type i;
+	uint64_t h;
+
+	if (!sc)
+		return isl_stat_error;
+
+	*hash = isl_hash64_init();
+	if (isl_union_set_get_stable_hash(sc->domain, &h) < 0)
+		return isl_stat_error;
+	*hash = isl_hash64_uint64(*hash, h);
+	if (isl_set_get_stable_hash(sc->context, &h) < 0)
+		return isl_stat_error;
+	*hash = isl_hash64_uint64(*hash, h);
+	for (i = isl_edge_first; i <= isl_edge_last; ++i) {
+		if (isl_union_map_get_stable_hash(sc->constraint[i], &h) < 0)
+			return isl_stat_error;
+		*hash = isl_hash64_uint64(*hash, h);
+	}
+
+	return isl_stat_ok;
+}
@@ -2,6 +2,7 @@
 #define ISL_SCHEDULE_CONSTRAINTS_H
 
 #include <isl/schedule.h>
+#include <isl/map_to_basic_set.h>
 
 enum isl_edge_type {
 	isl_edge_validity = 0,
@@ -14,6 +15,33 @@ enum isl_edge_type {
 	isl_edge_local
 };
 
+/* A cache of the sets of coefficients of valid constraints computed
+ * by the scheduler for dependence relations, shared between
+ * the dependence graphs derived from the same schedule constraints.
+ *
+ * "ref" is the reference count; the cache is modified in place.
+ *
+ * intra maps dependence relations from a node to itself to their dual,
+ *	possibly without coefficients for the parameters
+ * intra_param maps dependence relations from a node to itself
+ *	to their dual, including coefficients for the parameters
+ * inter maps dependence relations between distinct nodes to their dual
+ */
+struct isl_sched_coef_cache {
+	int ref;
+
+	isl_map_to_basic_set *intra;
+	isl_map_to_basic_set *intra_param;
+	isl_map_to_basic_set *inter;
+};
+
+struct isl_sched_coef_cache *isl_sched_coef_cache_copy(
+	struct isl_sched_coef_cache *cache);
+struct isl_sched_coef_cache *isl_sched_coef_cache_free(
+	struct isl_sched_coef_cache *cache);
+struct isl_sched_coef_cache *isl_schedule_constraints_get_coef_cache(
+	__isl_keep isl_schedule_constraints *sc);
+
 __isl_give isl_schedule_constraints *
 isl_schedule_constraints_align_params(__isl_take isl_schedule_constraints *sc);
 
@@ -27,4 +55,7 @@ int isl_schedule_constraints_n_basic_map(
 	__isl_keep isl_schedule_constraints *sc);
 int isl_schedule_constraints_n_map(__isl_keep isl_schedule_constraints *sc);
 
+isl_stat isl_schedule_constraints_get_stable_hash(
+	__isl_keep isl_schedule_constraints *sc, uint64_t *hash);
+
 #endif
@@ -11,13 +11,24 @@
  * B.P. 105 - 78153 Le Chesnay, France
  */
 
+#include <ctype.h>
+#include <string.h>
+
 #include <isl/id.h>
 #include <isl/val.h>
 #include <isl/space.h>
 #include <isl/set.h>
+#include <isl/map.h>
+#include <isl/aff.h>
+#include <isl/constraint.h>
+#include <isl/ilp.h>
+#include <isl/flow.h>
+#include <isl/union_map.h>
+#include <isl/union_set.h>
 #include <isl_schedule_band.h>
 #include <isl_schedule_private.h>
 #include <isl_schedule_node_private.h>
+#include <isl_printer_private.h>
 
 /* Create a new schedule node in the given schedule, point at the given
  * tree with given ancestors and child positions.
@@ -1958,6 +1969,260 @@ error:
 	return NULL;
 }
 
+/* Return a relation between pairs of elements of "space" that
+ * are less than "size" apart in each dimension.
+ * That is, return
+ *
+ *	{ [b] -> [b'] : -size < b' - b < size }
+ *
+ * Any pair of elements that belong to the same tile when tiling
+ * with tile size "size" in each dimension satisfies these constraints.
+ */
+static __isl_give isl_map *tile_neighbours(__isl_take isl_space *space,
+	int size)
+{
+	int i, n;
+	isl_local_space *ls;
+	isl_basic_map *bmap;
+
+	n = isl_space_dim(space, isl_dim_set);
+	space = isl_space_map_from_set(space);
+	ls = isl_local_space_from_space(isl_space_copy(space));
+	bmap = isl_basic_map_universe(space);
+	for (i = 0; i < n; ++i) {
+		isl_constraint *c;
+
+		c = isl_constraint_alloc_inequality(isl_local_space_copy(ls));
+		c = isl_constraint_set_coefficient_si(c, isl_dim_in, i, -1);
+		c = isl_constraint_set_coefficient_si(c, isl_dim_out, i, 1);
+		c = isl_constraint_set_constant_si(c, size - 1);
+		bmap = isl_basic_map_add_constraint(bmap, c);
+		c = isl_constraint_alloc_inequality(isl_local_space_copy(ls));
+		c = isl_constraint_set_coefficient_si(c, isl_dim_in, i, 1);
+		c = isl_constraint_set_coefficient_si(c, isl_dim_out, i, -1);
+		c = isl_constraint_set_constant_si(c, size - 1);
+		bmap = isl_basic_map_add_constraint(bmap, c);
+	}
+	isl_local_space_free(ls);
+
+	return isl_map_from_basic_map(bmap);
+}
+
+/* Data used in add_footprint.
+ *
+ * "context" contains the constraints on the parameters
+ * imposed by the context nodes above the band node.
+ * "footprint" collects the estimated footprints of the different arrays.
+ */
+struct isl_tile_footprint_data {
+	isl_set *context;
+	isl_val *footprint;
+};
+
+/* Given the set "deltas" of differences between the elements
+ * of a single array that are accessed from within the same tile,
+ * add an estimate of the number of elements of this array accessed
+ * from within a tile to data->footprint.
+ *
+ * The estimate is the product of the extents of the accessed elements
+ * in the different array dimensions, where the extent of a dimension
+ * is one more than the maximal difference in that dimension
+ * over all values of the parameters that satisfy data->context.
+ * If the extent of any dimension is unbounded, which in particular
+ * happens if it depends on a parameter that is not bounded
+ * by data->context, then the estimate is infinite.
+ * This ensures that a tile never appears to fit
+ * if the footprint cannot be bounded.
+ */
+static isl_stat add_footprint(__isl_take isl_set *deltas, void *user)
+{
+	struct isl_tile_footprint_data *data = user;
+	int i, n;
+	isl_ctx *ctx;
+	isl_local_space *ls;
+	isl_val *product;
+
+	ctx = isl_set_get_ctx(deltas);
+	deltas = isl_set_intersect_params(deltas,
+					isl_set_copy(data->context));
+	n = isl_set_dim(deltas, isl_dim_set);
+	ls = isl_local_space_from_space(isl_set_get_space(deltas));
+	product = isl_val_one(ctx);
+	for (i = 0; i < n; ++i) {
+		isl_aff *aff;
+		isl_val *max;
+
+		aff = isl_aff_var_on_domain(isl_local_space_copy(ls),
+					    isl_dim_set, i);
+		max = isl_set_max_val(deltas, aff);
+		isl_aff_free(aff);
+		if (!max) {
+			product = isl_val_free(product);
+			break;
+		}
+		if (isl_val_is_infty(max)) {
+			isl_val_free(product);
+			product = max;
+			break;
+		}
+		if (!isl_val_is_int(max)) {
+			isl_val_free(max);
+			continue;
+		}
+		max = isl_val_add_ui(max, 1);
+		product = isl_val_mul(product, max);
+	}
+	isl_local_space_free(ls);
+	isl_set_free(deltas);
+
+	data->footprint = isl_val_add(data->footprint, product);
+	if (!data->footprint)
+		return isl_stat_error;
+	return isl_stat_ok;
+}
+
+/* Estimate the number of array elements accessed through "access"
+ * from within a single tile of the band node "node",
+ * when tiled with tile size "size" in each direction.
+ *
+ * First construct the relation between pairs of statement instances
+ * that may belong to the same tile.
+ * Then compute, for each array, the differences between the elements
+ * accessed by such pairs and derive an estimate from those
+ * in add_footprint, taking into account the constraints
+ * on the parameters in "context".
+ */
+static __isl_give isl_val *band_tile_footprint(
+	__isl_keep isl_schedule_node *node, __isl_keep isl_union_map *access,
+	__isl_keep isl_set *context, int size)
+{
+	struct isl_tile_footprint_data data;
+	isl_union_map *partial, *near;
+	isl_union_set *deltas;
+	isl_map *map;
+
+	partial = isl_schedule_node_band_get_partial_schedule_union_map(node);
+	partial = isl_union_map_intersect_domain(partial,
+					isl_schedule_node_get_domain(node));
+	map = tile_neighbours(isl_schedule_node_band_get_space(node), size);
+	near = isl_union_map_apply_range(isl_union_map_copy(partial),
+					isl_union_map_from_map(map));
+	near = isl_union_map_apply_range(near, isl_union_map_reverse(partial));
+	near = isl_union_map_apply_range(
+			isl_union_map_reverse(isl_union_map_copy(access)), near);
+	near = isl_union_map_apply_range(near, isl_union_map_copy(access));
+	deltas = isl_union_map_deltas(near);
+
+	data.context = context;
+	data.footprint = isl_val_zero(isl_schedule_node_get_ctx(node));
+	if (isl_union_set_foreach_set(deltas, &add_footprint, &data) < 0)
+		data.footprint = isl_val_free(data.footprint);
+	isl_union_set_free(deltas);
+
+	return data.footprint;
+}
+
+/* Return the constraints on the parameters imposed by
+ * the context nodes that are ancestors of "node".
+ */
+static __isl_give isl_set *outer_context(__isl_keep isl_schedule_node *node)
+{
+	int i, n;
+	isl_set *context;
+
+	context = isl_set_universe(isl_space_params_alloc(
+					isl_schedule_node_get_ctx(node), 0));
+	n = isl_schedule_node_get_tree_depth(node);
+	for (i = 1; i <= n; ++i) {
+		isl_schedule_node *ancestor;
+
+		ancestor = isl_schedule_node_ancestor(
+					isl_schedule_node_copy(node), i);
+		if (!ancestor)
+			return isl_set_free(context);
+		if (isl_schedule_node_get_type(ancestor) ==
+		    isl_schedule_node_context)
+			context = isl_set_intersect_params(context,
+			    isl_schedule_node_context_get_context(ancestor));
+		isl_schedule_node_free(ancestor);
+	}
+
+	return context;
+}
+
+/* Tile the band node "node" with tile sizes that are chosen
+ * such that the estimated number of array elements accessed
+ * through "access" from within a single tile fits in a cache
+ * of "tile_cache_size" array elements.
+ *
+ * The same tile size is used in each direction.
+ * The candidate tile sizes are the powers of two starting at 2.
+ * The largest candidate for which the estimate (see band_tile_footprint)
+ * fits is selected.  If even the smallest candidate does not fit,
+ * then the smallest candidate is used.
+ * In particular, this is the case if the footprint of a tile
+ * cannot be bounded, e.g., because it depends on a parameter
+ * that is not bounded by the domain or any outer context node.
+ * Since the estimated footprint can only increase with the tile size,
+ * the search stops at the first candidate that does not fit.
+ *
+ * A band node without any members is returned unchanged.
+ */
+__isl_give isl_schedule_node *isl_schedule_node_band_tile_auto(
+	__isl_take isl_schedule_node *node, __isl_take isl_union_map *access)
+{
+	int n, size, best;
+	isl_ctx *ctx;
+	isl_set *context;
+	isl_val *cache_size;
+	isl_multi_val *sizes;
+
+	if (!node || !access)
+		goto error;
+	ctx = isl_schedule_node_get_ctx(node);
+	if (isl_schedule_node_get_type(node) != isl_schedule_node_band)
+		isl_die(ctx, isl_error_invalid, "not a band node",
+			goto error);
+	n = isl_schedule_node_band_n_member(node);
+	if (n == 0) {
+		isl_union_map_free(access);
+		return node;
+	}
+
+	cache_size = isl_val_int_from_si(ctx,
+				isl_options_get_tile_cache_size(ctx));
+	context = outer_context(node);
+	best = 2;
+	for (size = 4; size <= isl_options_get_tile_cache_size(ctx);
+	     size *= 2) {
+		isl_val *footprint;
+		isl_bool fits;
+
+		footprint = band_tile_footprint(node, access, context, size);
+		fits = isl_val_le(footprint, cache_size);
+		isl_val_free(footprint);
+		if (!footprint || fits < 0)
+			goto error_cache;
+		if (!fits)
+			break;
+		best = size;
+	}
+	isl_set_free(context);
+	isl_val_free(cache_size);
+	isl_union_map_free(access);
+
+	sizes = isl_multi_val_zero(isl_schedule_node_band_get_space(node));
+	sizes = isl_multi_val_add_val(sizes, isl_val_int_from_si(ctx, best));
+	return isl_schedule_node_band_tile(node, sizes);
+error_cache:
+	isl_set_free(context);
+	isl_val_free(cache_size);
+error:
+	isl_union_map_free(access);
+	isl_schedule_node_free(node);
+	return NULL;
+}
+
 /* Move the band node "node" down to all the leaves in the subtree
  * rooted at "node".
  * Return a pointer to the node in the resulting tree that is in the same
@@ -2560,6 +2825,301 @@ __isl_give isl_schedule_node *isl_schedule_node_insert_mark(
 	return node;
 }
 
+/* Does the OpenMP reduction clause "clause" of the form
+ *
+ *	reduction(op:var1, var2, ...)
+ *
+ * mention the variable "var"?
+ */
+static int reduction_mentions(const char *clause, const char *var)
+{
+	size_t len;
+
+	if (strncmp(clause, "reduction(", strlen("reduction(")))
+		return 0;
+	clause = strchr(clause, ':');
+	if (!clause)
+		return 0;
+	len = strlen(var);
+	while (*clause && *clause != ')') {
+		++clause;
+		while (isspace((unsigned char) *clause))
+			++clause;
+		if (!strncmp(clause, var, len)) {
+			const char *end = clause + len;
+
+			while (isspace((unsigned char) *end))
+				++end;
+			if (*end == ',' || *end == ')')
+				return 1;
+		}
+		clause += strcspn(clause, ",)");
+	}
+
+	return 0;
+}
+
+/* Is "var" mentioned in a reduction clause of one of the mark nodes
+ * that appear directly above "node"?
+ */
+static isl_bool reduction_above(__isl_keep isl_schedule_node *node,
+	const char *var)
+{
+	isl_bool found = isl_bool_false;
+
+	node = isl_schedule_node_copy(node);
+	while (!found) {
+		isl_bool has_parent;
+		isl_id *mark;
+
+		has_parent = isl_schedule_node_has_parent(node);
+		if (has_parent < 0)
+			found = isl_bool_error;
+		if (has_parent <= 0)
+			break;
+		node = isl_schedule_node_parent(node);
+		if (isl_schedule_node_get_type(node) != isl_schedule_node_mark)
+			break;
+		mark = isl_schedule_node_mark_get_id(node);
+		if (!mark)
+			found = isl_bool_error;
+		else
+			found = reduction_mentions(isl_id_get_name(mark), var);
+		isl_id_free(mark);
+	}
+	isl_schedule_node_free(node);
+
+	return found;
+}
+
+/* Data used in add_private.
+ *
+ * "node" is the node above which the private mark is inserted.
+ * "shared" contains the data elements that cannot be privatized.
+ * "vars" collects the identifiers of the private scalars.
+ */
+struct isl_private_data {
+	isl_schedule_node *node;
+	isl_union_set *shared;
+	isl_id_list *vars;
+};
+
+/* Is the scalar "set" (partly) contained in data->shared?
+ */
+static isl_bool is_shared(__isl_keep isl_set *set,
+	struct isl_private_data *data)
+{
+	isl_set *shared;
+	isl_bool empty;
+
+	shared = isl_union_set_extract_set(data->shared, isl_set_get_space(set));
+	empty = isl_set_is_empty(shared);
+	isl_set_free(shared);
+
+	return isl_bool_not(empty);
+}
+
+/* If "set" is a set of elements of a named scalar that
+ * does not appear in data->shared and that is not mentioned
+ * in any reduction clause directly above data->node,
+ * then add the identifier of the scalar to data->vars.
+ */
+static isl_stat add_private(__isl_take isl_set *set, void *user)
+{
+	struct isl_private_data *data = user;
+	isl_bool shared, reduction;
+	isl_id *id;
+
+	if (isl_set_dim(set, isl_dim_set) != 0 ||
+	    !isl_set_has_tuple_name(set)) {
+		isl_set_free(set);
+		return isl_stat_ok;
+	}
+
+	shared = is_shared(set, data);
+	if (shared < 0 || shared) {
+		isl_set_free(set);
+		return shared < 0 ? isl_stat_error : isl_stat_ok;
+	}
+
+	id = isl_set_get_tuple_id(set);
+	isl_set_free(set);
+	reduction = reduction_above(data->node, isl_id_get_name(id));
+	if (reduction < 0 || reduction) {
+		isl_id_free(id);
+		return reduction < 0 ? isl_stat_error : isl_stat_ok;
+	}
+	data->vars = isl_id_list_add(data->vars, id);
+	if (!data->vars)
+		return isl_stat_error;
+
+	return isl_stat_ok;
+}
+
+/* Compare the names of "a" and "b".
+ */
+static int cmp_name(__isl_keep isl_id *a, __isl_keep isl_id *b, void *user)
+{
+	return strcmp(isl_id_get_name(a), isl_id_get_name(b));
+}
+
+/* Return the pairs of statement instances reaching "node"
+ * that belong to the same iteration of the loop corresponding to "node",
+ * i.e., that have the same value for the prefix schedule of "node"
+ * and, if "node" is a band node, for its partial schedule.
+ */
+static __isl_give isl_union_map *same_iteration(
+	__isl_keep isl_schedule_node *node)
+{
+	isl_union_map *prefix, *partial, *reverse;
+
+	prefix = isl_schedule_node_get_prefix_schedule_union_map(node);
+	if (isl_schedule_node_get_type(node) == isl_schedule_node_band) {
+		partial =
+		    isl_schedule_node_band_get_partial_schedule_union_map(node);
+		prefix = isl_union_map_flat_range_product(prefix, partial);
+	}
+
+	reverse = isl_union_map_reverse(isl_union_map_copy(prefix));
+	return isl_union_map_apply_range(prefix, reverse);
+}
+
+/* Return the data elements accessed through "reads" and "writes"
+ * that cannot be privatized in the loop corresponding to "node".
+ *
+ * Perform dataflow analysis on the schedule containing "node" and
+ * collect the elements that are live-in to an iteration of the loop,
+ * i.e., that are read by a statement instance reaching "node"
+ * without being written in the same iteration before the read, and
+ * those that are live-out of the loop, i.e., that are read
+ * by a statement instance outside the loop from a write inside the loop.
+ */
+static __isl_give isl_union_set *shared_data(
+	__isl_keep isl_schedule_node *node, __isl_take isl_union_map *reads,
+	__isl_take isl_union_map *writes)
+{
+	isl_union_access_info *access;
+	isl_union_flow *flow;
+	isl_union_set *domain, *shared;
+	isl_union_map *dep, *pairs, *live_in, *live_out;
+
+	domain = isl_schedule_node_get_domain(node);
+	access = isl_union_access_info_from_sink(reads);
+	access = isl_union_access_info_set_must_source(access, writes);
+	access = isl_union_access_info_set_schedule(access,
+					    isl_schedule_node_get_schedule(node));
+	flow = isl_union_access_info_compute_flow(access);
+
+	live_in = isl_union_flow_get_may_no_source(flow);
+	live_in = isl_union_map_intersect_domain(live_in,
+					    isl_union_set_copy(domain));
+	shared = isl_union_map_range(live_in);
+
+	dep = isl_union_flow_get_full_may_dependence(flow);
+	isl_union_flow_free(flow);
+	pairs = isl_union_map_uncurry(isl_union_map_copy(dep));
+	pairs = isl_union_map_subtract_domain(pairs,
+				isl_union_map_wrap(same_iteration(node)));
+	live_in = isl_union_map_domain_factor_range(pairs);
+	live_in = isl_union_map_intersect_domain(live_in,
+					    isl_union_set_copy(domain));
+	shared = isl_union_set_union(shared, isl_union_map_range(live_in));
+
+	dep = isl_union_map_intersect_domain(dep, isl_union_set_copy(domain));
+	live_out = isl_union_set_unwrap(isl_union_map_range(dep));
+	live_out = isl_union_map_subtract_domain(live_out, domain);
+	shared = isl_union_set_union(shared, isl_union_map_range(live_out));
+
+	return shared;
+}
+
+/* Insert a mark node representing an OpenMP "private" clause
+ * between "node" and its parent, for use by the AST printer
+ * when the ast_print_openmp option is set.
+ * Return a pointer to the new mark node, or
+ * the original node if there are no private scalars.
+ *
+ * "reads" and "writes" are the read and write accesses
+ * of the entire schedule containing "node".
+ * The writes are assumed to be must-writes.
+ * The private scalars are the scalars (zero-dimensional arrays)
+ * written by the statement instances that reach "node" that are
+ * neither live-in to an iteration of the loop corresponding to "node"
+ * nor live-out of this loop.  See shared_data.
+ * Scalars that appear in a reduction clause of one of the mark nodes
+ * directly above "node" are not privatized.
+ *
+ * The mark identifier has the form
+ *
+ *	private(var1, var2, ...)
+ *
+ * with the scalars sorted by name.
+ */
+__isl_give isl_schedule_node *isl_schedule_node_insert_private_mark(
+	__isl_take isl_schedule_node *node, __isl_take isl_union_map *reads,
+	__isl_take isl_union_map *writes)
+{
+	struct isl_private_data data;
+	isl_ctx *ctx;
+	isl_union_set *written;
+	isl_printer *p;
+	char *name;
+	int i, n;
+
+	if (!node || !reads || !writes)
+		goto error;
+
+	ctx = isl_schedule_node_get_ctx(node);
+	written = isl_union_map_range(isl_union_map_intersect_domain(
+					isl_union_map_copy(writes),
+					isl_schedule_node_get_domain(node)));
+	data.node = node;
+	data.shared = shared_data(node, reads, writes);
+	data.vars = isl_id_list_alloc(ctx, 0);
+	if (isl_union_set_foreach_set(written, &add_private, &data) < 0)
+		data.vars = isl_id_list_free(data.vars);
+	isl_union_set_free(written);
+	isl_union_set_free(data.shared);
+	data.vars = isl_id_list_sort(data.vars, &cmp_name, NULL);
+	if (!data.vars)
+		return isl_schedule_node_free(node);
+
+	n = isl_id_list_n_id(data.vars);
+	if (n == 0) {
+		isl_id_list_free(data.vars);
+		return node;
+	}
+
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_print_str(p, "private(");
+	for (i = 0; i < n; ++i) {
+		isl_id *id;
+
+		if (i)
+			p = isl_printer_print_str(p, ", ");
+		id = isl_id_list_get_id(data.vars, i);
+		p = isl_printer_print_str(p, isl_id_get_name(id));
+		isl_id_free(id);
+	}
+	p = isl_printer_print_str(p, ")");
+	name = isl_printer_get_str(p);
+	isl_printer_free(p);
+	isl_id_list_free(data.vars);
+	if (!name)
+		return isl_schedule_node_free(node);
+
+	node = isl_schedule_node_insert_mark(node,
+					isl_id_alloc(ctx, name, NULL));
+	free(name);
+
+	return node;
+error:
+	isl_union_map_free(reads);
+	isl_union_map_free(writes);
+	isl_schedule_node_free(node);
+	return NULL;
+}
+
 /* Attach the current subtree of "node" to a sequence of filter tree nodes
  * with filters described by "filters", attach this sequence
  * of filter tree nodes as children to a new tree of type "type" and
@@ -4762,8 +5322,7 @@ __isl_give char *isl_schedule_node_to_str(__isl_keep isl_schedule_node *node)
 	printer = isl_printer_to_str(isl_schedule_node_get_ctx(node));
 	printer = isl_printer_set_yaml_style(printer, ISL_YAML_STYLE_BLOCK);
 	printer = isl_printer_print_schedule_node(printer, node);
-	s = isl_printer_get_str(printer);
-	isl_printer_free(printer);
+	s = isl_printer_take_str(printer);
 
 	return s;
 }
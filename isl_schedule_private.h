@@ -22,6 +22,11 @@ struct isl_schedule {
 	struct isl_schedule_tree *leaf;
 };
 
+#undef EL
+#define EL isl_schedule
+
+#include <isl_list_templ.h>
+
 __isl_give isl_schedule *isl_schedule_from_schedule_tree(isl_ctx *ctx,
 	__isl_take isl_schedule_tree *tree);
 __isl_give isl_schedule *isl_schedule_set_root(
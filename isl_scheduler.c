@@ -24,7 +24,8 @@
 #include <isl/constraint.h>
 #include <isl/schedule.h>
 #include <isl_schedule_constraints.h>
-#include <isl/schedule_node.h>
+#include <isl_schedule_cache.h>
+#include <isl_schedule_node_private.h>
 #include <isl_mat_private.h>
 #include <isl_vec_private.h>
 #include <isl/set.h>
@@ -81,6 +82,10 @@
  *
  * scc is the index of SCC (or WCC) this node belongs to
  *
+ * "changed" is only used when a schedule is recomputed incrementally
+ * and is set if the instance set of the node or the validity constraints
+ * on the node prevent the reuse of the previous schedule.
+ *
  * "cluster" is only used inside extract_clusters and identifies
  * the cluster of SCCs that the node belongs to.
  *
@@ -118,6 +123,7 @@ struct isl_sched_node {
 
 	int	 scc;
 	int	 cluster;
+	int	 changed;
 
 	int	*coincident;
 
@@ -304,17 +310,14 @@ static int is_multi_edge_type(struct isl_sched_edge *edge)
 /* Internal information about the dependence graph used during
  * the construction of the schedule.
  *
- * intra_hmap is a cache, mapping dependence relations to their dual,
- *	for dependences from a node to itself, possibly without
- *	coefficients for the parameters
- * intra_hmap_param is a cache, mapping dependence relations to their dual,
- *	for dependences from a node to itself, including coefficients
- *	for the parameters
- * inter_hmap is a cache, mapping dependence relations to their dual,
- *	for dependences between distinct nodes
- * if compression is involved then the key for these maps
- * is the original, uncompressed dependence relation, while
- * the value is the dual of the compressed dependence relation.
+ * coef_cache is a cache, mapping dependence relations to their dual,
+ *	shared by the graph with the subgraphs derived from it
+ *	and with the schedule constraints from which it was constructed,
+ *	such that the duals can be reused by subsequent schedule
+ *	computations on (copies of) the same schedule constraints
+ *	if compression is involved then the key for these maps
+ *	is the original, uncompressed dependence relation, while
+ *	the value is the dual of the compressed dependence relation.
  *
  * n is the number of nodes
  * node is the list of nodes
@@ -357,11 +360,19 @@ static int is_multi_edge_type(struct isl_sched_edge *edge)
  *
  * max_weight is used during clustering and represents the maximal
  * weight of the relevant proximity edges.
+ *
+ * max_operations is the number of operations the scheduler may perform
+ *	before switching to cheaper strategies, or zero if there is no limit
+ * start_operations is the number of operations performed by the isl_ctx
+ *	when the computation of the schedule started
+ *
+ * prev is a previously computed schedule from which the schedules
+ *	of (weakly connected) components without any changed nodes
+ *	can be reused; it is only set on the top-level graph and
+ *	only until the components have been determined
  */
 struct isl_sched_graph {
-	isl_map_to_basic_set *intra_hmap;
-	isl_map_to_basic_set *intra_hmap_param;
-	isl_map_to_basic_set *inter_hmap;
+	struct isl_sched_coef_cache *coef_cache;
 
 	struct isl_sched_node *node;
 	int n;
@@ -393,6 +404,11 @@ struct isl_sched_graph {
 	int weak;
 
 	int max_weight;
+
+	int max_operations;
+	unsigned long start_operations;
+
+	isl_schedule *prev;
 };
 
 /* Initialize node_table based on the list of nodes.
@@ -678,9 +694,6 @@ static isl_stat graph_alloc(isl_ctx *ctx, struct isl_sched_graph *graph,
 	graph->edge = isl_calloc_array(ctx,
 					struct isl_sched_edge, graph->n_edge);
 
-	graph->intra_hmap = isl_map_to_basic_set_alloc(ctx, 2 * n_edge);
-	graph->intra_hmap_param = isl_map_to_basic_set_alloc(ctx, 2 * n_edge);
-	graph->inter_hmap = isl_map_to_basic_set_alloc(ctx, 2 * n_edge);
 
 	if (!graph->node || !graph->region || (graph->n_edge && !graph->edge) ||
 	    !graph->sorted)
@@ -719,9 +732,7 @@ static void graph_free(isl_ctx *ctx, struct isl_sched_graph *graph)
 {
 	int i;
 
-	isl_map_to_basic_set_free(graph->intra_hmap);
-	isl_map_to_basic_set_free(graph->intra_hmap_param);
-	isl_map_to_basic_set_free(graph->inter_hmap);
+	isl_sched_coef_cache_free(graph->coef_cache);
 
 	if (graph->node)
 		for (i = 0; i < graph->n; ++i)
@@ -740,6 +751,39 @@ static void graph_free(isl_ctx *ctx, struct isl_sched_graph *graph)
 		isl_hash_table_free(ctx, graph->edge_table[i]);
 	isl_hash_table_free(ctx, graph->node_table);
 	isl_basic_set_free(graph->lp);
+	isl_schedule_free(graph->prev);
+}
+
+/* Copy the operation budget of "src" to "dst".
+ */
+static void copy_budget(struct isl_sched_graph *dst,
+	struct isl_sched_graph *src)
+{
+	dst->max_operations = src->max_operations;
+	dst->start_operations = src->start_operations;
+}
+
+/* Has the scheduler used up more than "num"/"den" of the operation budget
+ * of "graph"?
+ * Always return 0 if there is no budget.
+ */
+static int over_budget(isl_ctx *ctx, struct isl_sched_graph *graph,
+	int num, int den)
+{
+	unsigned long used;
+
+	if (graph->max_operations <= 0)
+		return 0;
+	used = ctx->operations - graph->start_operations;
+	return used >= (unsigned long) graph->max_operations / den * num;
+}
+
+/* Record that the scheduler switched to the cheaper strategy "fallback"
+ * because it ran out of (part of) its operation budget.
+ */
+static void add_fallback(isl_ctx *ctx, enum isl_schedule_fallback fallback)
+{
+	ctx->schedule_fallbacks |= fallback;
 }
 
 /* For each "set" on which this function is called, increment
@@ -1407,6 +1451,10 @@ static isl_stat graph_init(struct isl_sched_graph *graph,
 	    isl_schedule_constraints_n_map(sc)) < 0)
 		return isl_stat_error;
 
+	graph->coef_cache = isl_schedule_constraints_get_coef_cache(sc);
+	if (!graph->coef_cache)
+		return isl_stat_error;
+
 	if (compute_max_row(graph, sc) < 0)
 		return isl_stat_error;
 	graph->root = graph;
@@ -1645,16 +1693,18 @@ static __isl_give isl_basic_set *intra_coefficients(
 	isl_map *key;
 	isl_basic_set *coef;
 	isl_maybe_isl_basic_set m;
-	isl_map_to_basic_set **hmap = &graph->intra_hmap;
+	isl_map_to_basic_set **hmap;
 	int treat;
 
-	if (!map)
-		return NULL;
+	if (!map || !graph->coef_cache)
+		goto error;
 
 	ctx = isl_map_get_ctx(map);
 	treat = !need_param && isl_options_get_schedule_treat_coalescing(ctx);
-	if (!treat)
-		hmap = &graph->intra_hmap_param;
+	if (treat)
+		hmap = &graph->coef_cache->intra;
+	else
+		hmap = &graph->coef_cache->intra_param;
 	m = isl_map_to_basic_set_try_get(*hmap, map);
 	if (m.valid < 0 || m.valid) {
 		isl_map_free(map);
@@ -1676,6 +1726,9 @@ static __isl_give isl_basic_set *intra_coefficients(
 	*hmap = isl_map_to_basic_set_set(*hmap, key, isl_basic_set_copy(coef));
 
 	return coef;
+error:
+	isl_map_free(map);
+	return NULL;
 }
 
 /* Given a dependence relation R, construct the set of coefficients
@@ -1697,8 +1750,13 @@ static __isl_give isl_basic_set *inter_coefficients(
 	isl_map *key;
 	isl_basic_set *coef;
 	isl_maybe_isl_basic_set m;
+	isl_map_to_basic_set **hmap;
+
+	if (!map || !graph->coef_cache)
+		goto error;
 
-	m = isl_map_to_basic_set_try_get(graph->inter_hmap, map);
+	hmap = &graph->coef_cache->inter;
+	m = isl_map_to_basic_set_try_get(*hmap, map);
 	if (m.valid < 0 || m.valid) {
 		isl_map_free(map);
 		return m.value;
@@ -1713,10 +1771,12 @@ static __isl_give isl_basic_set *inter_coefficients(
 				    isl_multi_aff_copy(edge->dst->decompress));
 	set = isl_map_wrap(isl_map_remove_divs(map));
 	coef = isl_set_coefficients(set);
-	graph->inter_hmap = isl_map_to_basic_set_set(graph->inter_hmap, key,
-					isl_basic_set_copy(coef));
+	*hmap = isl_map_to_basic_set_set(*hmap, key, isl_basic_set_copy(coef));
 
 	return coef;
+error:
+	isl_map_free(map);
+	return NULL;
 }
 
 /* Return the position of the coefficients of the variables in
@@ -3607,6 +3667,8 @@ static isl_stat extract_sub_graph(isl_ctx *ctx, struct isl_sched_graph *graph,
 	if (graph_alloc(ctx, sub, n, n_edge) < 0)
 		return isl_stat_error;
 	sub->root = graph->root;
+	sub->coef_cache = isl_sched_coef_cache_copy(graph->coef_cache);
+	copy_budget(sub, graph);
 	if (copy_nodes(sub, graph, node_pred, data) < 0)
 		return isl_stat_error;
 	if (graph_init_table(ctx, sub) < 0)
@@ -5629,6 +5691,13 @@ static __isl_give isl_schedule_node *compute_schedule_finish_band(
  * until we are no longer able to compute a schedule.
  * Since there are only a finite number of dependences,
  * there will only be a finite number of iterations.
+ *
+ * If the scheduler has used up three quarters of its operation budget,
+ * then no further rows are computed for the current band.
+ * The caller will then fall back to carrying dependences
+ * (or to splitting up the graph) if the band is empty.
+ * This is only possible if there are any validity dependences
+ * left to carry.
  */
 static isl_stat compute_schedule_wcc_band(isl_ctx *ctx,
 	struct isl_sched_graph *graph)
@@ -5657,6 +5726,17 @@ static isl_stat compute_schedule_wcc_band(isl_ctx *ctx,
 		graph->src_scc = -1;
 		graph->dst_scc = -1;
 
+		if (over_budget(ctx, graph, 3, 4)) {
+			int carry;
+
+			carry = has_validity_edges(graph);
+			if (carry < 0)
+				return isl_stat_error;
+			if (carry) {
+				add_fallback(ctx, isl_schedule_fallback_carry);
+				return isl_stat_ok;
+			}
+		}
 		if (setup_lp(ctx, graph, use_coincidence) < 0)
 			return isl_stat_error;
 		sol = solve_lp(ctx, graph);
@@ -6240,6 +6320,7 @@ static isl_stat init_merge_graph(isl_ctx *ctx, struct isl_sched_graph *graph,
 	isl_union_map_free(cluster_map);
 
 	r = graph_init(merge_graph, sc);
+	copy_budget(merge_graph, graph);
 
 	isl_schedule_constraints_free(sc);
 
@@ -7190,6 +7271,9 @@ static __isl_give isl_schedule_node *finish_bands_clustering(
  * the band into "node" and to continue the computation.
  *
  * compute_weights initializes the weights that are used by find_proximity.
+ *
+ * If the scheduler has used up half of its operation budget,
+ * then no further clusters are merged.
  */
 static __isl_give isl_schedule_node *compute_schedule_wcc_clustering(
 	__isl_take isl_schedule_node *node, struct isl_sched_graph *graph)
@@ -7207,6 +7291,10 @@ static __isl_give isl_schedule_node *compute_schedule_wcc_clustering(
 		goto error;
 
 	for (;;) {
+		if (over_budget(ctx, graph, 1, 2)) {
+			add_fallback(ctx, isl_schedule_fallback_clustering);
+			break;
+		}
 		i = find_proximity(graph, &c);
 		if (i < 0)
 			goto error;
@@ -7242,11 +7330,18 @@ error:
  * there is no point in trying to combine SCCs
  * in compute_schedule_wcc_clustering, so compute_schedule_wcc_whole
  * is called instead.
+ *
+ * If the scheduler has used up its entire operation budget, then
+ * the SCCs are simply serialized and scheduled separately.
+ * If it has only used up half of its budget, then
+ * compute_schedule_wcc_whole is called instead of
+ * compute_schedule_wcc_clustering.
  */
 static __isl_give isl_schedule_node *compute_schedule_wcc(
 	__isl_take isl_schedule_node *node, struct isl_sched_graph *graph)
 {
 	isl_ctx *ctx;
+	int whole;
 
 	if (!node)
 		return NULL;
@@ -7261,7 +7356,18 @@ static __isl_give isl_schedule_node *compute_schedule_wcc(
 	if (need_feautrier_step(ctx, graph))
 		return compute_schedule_wcc_feautrier(node, graph);
 
-	if (graph->scc <= 1 || isl_options_get_schedule_whole_component(ctx))
+	if (graph->scc > 1 && over_budget(ctx, graph, 1, 1)) {
+		add_fallback(ctx, isl_schedule_fallback_serialize);
+		return compute_component_schedule(node, graph, 1);
+	}
+
+	whole = isl_options_get_schedule_whole_component(ctx);
+	if (graph->scc > 1 && !whole && over_budget(ctx, graph, 1, 2)) {
+		add_fallback(ctx, isl_schedule_fallback_clustering);
+		whole = 1;
+	}
+
+	if (graph->scc <= 1 || whole)
 		return compute_schedule_wcc_whole(node, graph);
 	else
 		return compute_schedule_wcc_clustering(node, graph);
@@ -7323,6 +7429,164 @@ static __isl_give isl_schedule_node *compute_component_schedule(
 	return node;
 }
 
+/* Does component "component" of "graph" contain any node
+ * that was marked changed by mark_changed?
+ */
+static int component_changed(struct isl_sched_graph *graph, int component)
+{
+	int i;
+
+	for (i = 0; i < graph->n; ++i)
+		if (graph->node[i].scc == component && graph->node[i].changed)
+			return 1;
+
+	return 0;
+}
+
+/* Return a pointer to the subtree of the previous schedule graph->prev
+ * that covers all the instances of component "component" of "graph".
+ * In particular, starting below the domain node, descend into the child
+ * of a set or sequence node for as long as it is the only child
+ * with a filter that intersects the component.
+ */
+static __isl_give isl_schedule_node *find_prev_subtree(isl_ctx *ctx,
+	struct isl_sched_graph *graph, int component)
+{
+	isl_union_set *dom;
+	isl_schedule_node *node;
+
+	dom = isl_sched_graph_domain(ctx, graph, &node_scc_exactly, component);
+	node = isl_schedule_get_root(graph->prev);
+	node = isl_schedule_node_child(node, 0);
+	while (node) {
+		enum isl_schedule_node_type type;
+		int i, n, pos;
+
+		type = isl_schedule_node_get_type(node);
+		if (type != isl_schedule_node_set &&
+		    type != isl_schedule_node_sequence)
+			break;
+		n = isl_schedule_node_n_children(node);
+		pos = -1;
+		for (i = 0; i < n; ++i) {
+			isl_schedule_node *child;
+			isl_union_set *filter;
+			isl_bool disjoint;
+
+			child = isl_schedule_node_get_child(node, i);
+			filter = isl_schedule_node_filter_get_filter(child);
+			isl_schedule_node_free(child);
+			disjoint = isl_union_set_is_disjoint(filter, dom);
+			isl_union_set_free(filter);
+			if (disjoint < 0) {
+				node = isl_schedule_node_free(node);
+				break;
+			}
+			if (disjoint)
+				continue;
+			if (pos >= 0)
+				break;
+			pos = i;
+		}
+		if (!node || pos < 0 || i < n)
+			break;
+		node = isl_schedule_node_child(node, pos);
+		node = isl_schedule_node_child(node, 0);
+	}
+	isl_union_set_free(dom);
+
+	return node;
+}
+
+/* Insert the schedule of component "component" of "graph"
+ * at position "node" of the schedule tree.
+ * If none of the nodes in the component has changed with respect
+ * to the previous schedule, then the corresponding subtree
+ * of the previous schedule is grafted at "node".
+ * Otherwise, or if this subtree contains any anchored nodes,
+ * a schedule for the component is computed from scratch.
+ * The domain of graph->prev has been restricted to the current domain
+ * in compute_schedule_with_prev, so the subtree does not refer
+ * to any statements that have been removed.
+ * It may still contain statements in other components,
+ * but if there is more than one component, then those are filtered out
+ * by the ancestors of "node".  Otherwise, there are no such statements.
+ */
+static __isl_give isl_schedule_node *reuse_sub_schedule(
+	__isl_take isl_schedule_node *node, isl_ctx *ctx,
+	struct isl_sched_graph *graph, int component)
+{
+	isl_bool anchored;
+	isl_schedule_node *prev;
+	isl_schedule_tree *tree;
+
+	if (component_changed(graph, component))
+		return compute_sub_schedule(node, ctx, graph,
+				    &node_scc_exactly,
+				    &edge_scc_exactly, component, 1);
+
+	prev = find_prev_subtree(ctx, graph, component);
+	anchored = isl_schedule_node_is_subtree_anchored(prev);
+	if (anchored < 0 || anchored) {
+		isl_schedule_node_free(prev);
+		if (anchored < 0)
+			return isl_schedule_node_free(node);
+		return compute_sub_schedule(node, ctx, graph,
+				    &node_scc_exactly,
+				    &edge_scc_exactly, component, 1);
+	}
+	tree = isl_schedule_node_get_tree(prev);
+	isl_schedule_node_free(prev);
+
+	return isl_schedule_node_graft_tree(node, tree);
+}
+
+/* Insert a schedule for the components of "graph" at position "node"
+ * of the schedule tree, reusing the schedules in graph->prev
+ * for those components that have not changed.
+ * The components are combined in the same way
+ * as in compute_component_schedule.
+ * The previous schedule is only used at the outer level,
+ * so it is dropped from "graph" before any schedule is computed.
+ * In particular, if there is only a single component and it has changed,
+ * then it is scheduled from scratch.
+ */
+static __isl_give isl_schedule_node *reuse_component_schedule(
+	__isl_take isl_schedule_node *node, struct isl_sched_graph *graph)
+{
+	int component;
+	isl_ctx *ctx;
+	isl_union_set_list *filters;
+
+	ctx = isl_schedule_node_get_ctx(node);
+	if (graph->scc <= 1) {
+		if (component_changed(graph, 0)) {
+			graph->prev = isl_schedule_free(graph->prev);
+			return compute_schedule_wcc(node, graph);
+		}
+		node = reuse_sub_schedule(node, ctx, graph, 0);
+		graph->prev = isl_schedule_free(graph->prev);
+		return node;
+	}
+
+	filters = extract_sccs(ctx, graph);
+	if (graph->weak)
+		node = isl_schedule_node_insert_set(node, filters);
+	else
+		node = isl_schedule_node_insert_sequence(node, filters);
+
+	for (component = 0; component < graph->scc; ++component) {
+		node = isl_schedule_node_child(node, component);
+		node = isl_schedule_node_child(node, 0);
+		node = reuse_sub_schedule(node, ctx, graph, component);
+		node = isl_schedule_node_parent(node);
+		node = isl_schedule_node_parent(node);
+	}
+	graph->prev = isl_schedule_free(graph->prev);
+
+	return node;
+}
+
 /* Compute a schedule for the given dependence graph and insert it at "node".
  * Return the updated schedule node.
  *
@@ -7332,17 +7596,22 @@ static __isl_give isl_schedule_node *compute_component_schedule(
  * If the schedule_serialize_sccs option is set, then we check for strongly
  * connected components instead and compute a separate schedule for
  * each such strongly connected component.
+ * The same happens if the scheduler has used up its entire operation budget.
  */
 static __isl_give isl_schedule_node *compute_schedule(isl_schedule_node *node,
 	struct isl_sched_graph *graph)
 {
 	isl_ctx *ctx;
+	int serialize;
 
 	if (!node)
 		return NULL;
 
 	ctx = isl_schedule_node_get_ctx(node);
-	if (isl_options_get_schedule_serialize_sccs(ctx)) {
+	serialize = isl_options_get_schedule_serialize_sccs(ctx);
+	if (!serialize && over_budget(ctx, graph, 1, 1))
+		serialize = -1;
+	if (serialize) {
 		if (detect_sccs(ctx, graph) < 0)
 			return isl_schedule_node_free(node);
 	} else {
@@ -7350,29 +7619,127 @@ static __isl_give isl_schedule_node *compute_schedule(isl_schedule_node *node,
 			return isl_schedule_node_free(node);
 	}
 
+	if (serialize < 0 && graph->scc > 1)
+		add_fallback(ctx, isl_schedule_fallback_serialize);
+	if (graph->prev)
+		return reuse_component_schedule(node, graph);
 	if (graph->scc > 1)
 		return compute_component_schedule(node, graph, 1);
 
 	return compute_schedule_wcc(node, graph);
 }
 
+/* Is the dependence relation of "edge" respected by the schedule "map"?
+ * That is, is every sink instance scheduled strictly after
+ * the corresponding source instance?
+ */
+static isl_bool edge_respected(struct isl_sched_edge *edge,
+	__isl_keep isl_union_map *map)
+{
+	isl_union_set *dom;
+	isl_union_map *src, *dst, *order;
+	isl_union_map *dep;
+	isl_bool respected;
+
+	dom = isl_union_set_from_set(isl_set_universe(
+				    isl_space_copy(edge->src->space)));
+	src = isl_union_map_intersect_domain(isl_union_map_copy(map), dom);
+	dom = isl_union_set_from_set(isl_set_universe(
+				    isl_space_copy(edge->dst->space)));
+	dst = isl_union_map_intersect_domain(isl_union_map_copy(map), dom);
+	order = isl_union_map_lex_lt_union_map(src, dst);
+	dep = isl_union_map_from_map(isl_map_copy(edge->map));
+	respected = isl_union_map_is_subset(dep, order);
+	isl_union_map_free(dep);
+	isl_union_map_free(order);
+
+	return respected;
+}
+
+/* Mark the nodes of "graph" for which the schedule in graph->prev
+ * cannot be reused as changed.
+ * "domain" is the domain of the schedule constraints.
+ *
+ * A node has changed if its instance set is different from
+ * the corresponding instance set in the domain of graph->prev.
+ * Moreover, if the schedule in graph->prev does not respect
+ * the (conditional) validity constraints of an edge between
+ * two nodes that have not changed,
+ * then both of these nodes are marked changed as well.
+ * Any other changes in the schedule constraints on unchanged nodes
+ * are not taken into account.
+ */
+static isl_stat mark_changed(struct isl_sched_graph *graph,
+	__isl_keep isl_union_set *domain)
+{
+	int i;
+	isl_union_set *prev_domain;
+	isl_union_map *prev_map;
+
+	prev_domain = isl_schedule_get_domain(graph->prev);
+	for (i = 0; i < graph->n; ++i) {
+		struct isl_sched_node *node = &graph->node[i];
+		isl_set *set, *prev_set;
+		isl_bool equal;
+
+		set = isl_union_set_extract_set(domain,
+						isl_space_copy(node->space));
+		prev_set = isl_union_set_extract_set(prev_domain,
+						isl_space_copy(node->space));
+		equal = isl_set_is_equal(set, prev_set);
+		isl_set_free(set);
+		isl_set_free(prev_set);
+		if (equal < 0)
+			break;
+		node->changed = !equal;
+	}
+	isl_union_set_free(prev_domain);
+	if (i < graph->n)
+		return isl_stat_error;
+
+	prev_map = isl_schedule_get_map(graph->prev);
+	for (i = 0; i < graph->n_edge; ++i) {
+		struct isl_sched_edge *edge = &graph->edge[i];
+		isl_bool respected;
+
+		if (!is_any_validity(edge))
+			continue;
+		if (edge->src->changed || edge->dst->changed)
+			continue;
+		respected = edge_respected(edge, prev_map);
+		if (respected < 0)
+			break;
+		if (respected)
+			continue;
+		edge->src->changed = 1;
+		edge->dst->changed = 1;
+	}
+	isl_union_map_free(prev_map);
+	if (i < graph->n_edge)
+		return isl_stat_error;
+
+	return isl_stat_ok;
+}
+
 /* Compute a schedule on sc->domain that respects the given schedule
- * constraints.
+ * constraints, reusing parts of the schedule "prev" if it is not NULL.
  *
- * In particular, the schedule respects all the validity dependences.
- * If the default isl scheduling algorithm is used, it tries to minimize
- * the dependence distances over the proximity dependences.
- * If Feautrier's scheduling algorithm is used, the proximity dependence
- * distances are only minimized during the extension to a full-dimensional
- * schedule.
+ * If "prev" is not NULL, then the nodes for which the schedule
+ * in "prev" cannot be reused are marked by mark_changed and
+ * "prev" is kept track of in the graph until compute_schedule has
+ * determined the (weakly connected) components.
+ * The domain of "prev" is intersected with sc->domain after
+ * the changed nodes have been marked, such that statements
+ * that have been removed since "prev" was computed do not appear
+ * in any subtree of "prev" that gets reused.
  *
- * If there are any condition and conditional validity dependences,
- * then the conditional validity dependences may be violated inside
- * a tilable band, provided they have no adjacent non-local
- * condition dependences.
+ * If the schedule_max_operations option is set, then the scheduler
+ * switches to cheaper strategies as it uses up this budget.
+ * The strategies that were used are kept track of in
+ * ctx->schedule_fallbacks.
  */
-__isl_give isl_schedule *isl_schedule_constraints_compute_schedule(
-	__isl_take isl_schedule_constraints *sc)
+static __isl_give isl_schedule *compute_schedule_with_prev(
+	__isl_take isl_schedule_constraints *sc, __isl_take isl_schedule *prev)
 {
 	isl_ctx *ctx = isl_schedule_constraints_get_ctx(sc);
 	struct isl_sched_graph graph = { 0 };
@@ -7380,16 +7747,30 @@ __isl_give isl_schedule *isl_schedule_constraints_compute_schedule(
 	isl_schedule_node *node;
 	isl_union_set *domain;
 
+	if (ctx) {
+		ctx->schedule_fallbacks = isl_schedule_fallback_none;
+		graph.max_operations =
+			    isl_options_get_schedule_max_operations(ctx);
+		graph.start_operations = ctx->operations;
+	}
+
 	sc = isl_schedule_constraints_align_params(sc);
 
 	domain = isl_schedule_constraints_get_domain(sc);
 	if (isl_union_set_n_set(domain) == 0) {
+		isl_schedule_free(prev);
 		isl_schedule_constraints_free(sc);
 		return isl_schedule_from_domain(domain);
 	}
 
 	if (graph_init(&graph, sc) < 0)
 		domain = isl_union_set_free(domain);
+	graph.prev = prev;
+	if (graph.prev && mark_changed(&graph, domain) < 0)
+		domain = isl_union_set_free(domain);
+	if (graph.prev)
+		graph.prev = isl_schedule_intersect_domain(graph.prev,
+						isl_union_set_copy(domain));
 
 	node = isl_schedule_node_from_domain(domain);
 	node = isl_schedule_node_child(node, 0);
@@ -7404,6 +7785,94 @@ __isl_give isl_schedule *isl_schedule_constraints_compute_schedule(
 	return sched;
 }
 
+/* Compute a schedule on sc->domain that respects the given schedule
+ * constraints.
+ *
+ * In particular, the schedule respects all the validity dependences.
+ * If the default isl scheduling algorithm is used, it tries to minimize
+ * the dependence distances over the proximity dependences.
+ * If Feautrier's scheduling algorithm is used, the proximity dependence
+ * distances are only minimized during the extension to a full-dimensional
+ * schedule.
+ *
+ * If there are any condition and conditional validity dependences,
+ * then the conditional validity dependences may be violated inside
+ * a tilable band, provided they have no adjacent non-local
+ * condition dependences.
+ *
+ * If the schedule cache is enabled, then the schedule is first looked up
+ * in the cache directory and, if it is not available there,
+ * the computed schedule is stored in the cache directory,
+ * unless the scheduler had to switch to any of the cheaper strategies.
+ */
+__isl_give isl_schedule *isl_schedule_constraints_compute_schedule(
+	__isl_take isl_schedule_constraints *sc)
+{
+	isl_ctx *ctx;
+	isl_bool cached;
+	uint64_t key;
+	isl_schedule *sched;
+
+	cached = isl_schedule_cache_is_enabled(sc);
+	if (cached < 0)
+		goto error;
+	if (!cached)
+		return compute_schedule_with_prev(sc, NULL);
+
+	ctx = isl_schedule_constraints_get_ctx(sc);
+	if (isl_schedule_cache_get_key(sc, &key) < 0)
+		goto error;
+	sched = isl_schedule_cache_lookup(ctx, key);
+	if (sched) {
+		ctx->schedule_fallbacks = isl_schedule_fallback_none;
+		isl_schedule_constraints_free(sc);
+		return sched;
+	}
+
+	sched = compute_schedule_with_prev(sc, NULL);
+	if (ctx->schedule_fallbacks == isl_schedule_fallback_none &&
+	    isl_schedule_cache_store(ctx, key, sched) < 0)
+		return isl_schedule_free(sched);
+
+	return sched;
+error:
+	isl_schedule_constraints_free(sc);
+	return NULL;
+}
+
+/* Compute a schedule on sc->domain that respects the given schedule
+ * constraints, given a schedule "prev" that was previously computed
+ * for similar schedule constraints, e.g., before some statements
+ * were added or removed.
+ *
+ * The schedule of each (weakly connected) component of the dependence
+ * graph that only involves statements with the same instance set
+ * as in "prev" and for which "prev" respects the validity constraints
+ * is taken from "prev".  Only the remaining components are scheduled
+ * from scratch.
+ */
+__isl_give isl_schedule *isl_schedule_constraints_recompute_schedule(
+	__isl_take isl_schedule_constraints *sc, __isl_take isl_schedule *prev)
+{
+	if (!prev) {
+		isl_schedule_constraints_free(sc);
+		return NULL;
+	}
+	return compute_schedule_with_prev(sc, prev);
+}
+
+/* Return the cheaper strategies, as a combination of
+ * isl_schedule_fallback values, that the scheduler switched to
+ * during the last call to isl_schedule_constraints_compute_schedule
+ * because it ran out of (part of) its operation budget.
+ */
+int isl_ctx_last_schedule_fallbacks(isl_ctx *ctx)
+{
+	if (!ctx)
+		return -1;
+	return ctx->schedule_fallbacks;
+}
+
 /* Compute a schedule for the given union of domains that respects
  * all the validity dependences and minimizes
  * the dependence distances over the proximity dependences.
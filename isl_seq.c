@@ -46,18 +46,29 @@ void isl_seq_cpy(isl_int *dst, isl_int *src, unsigned len)
 		isl_int_set(dst[i], src[i]);
 }
 
+/* The sequences that are manipulated by the functions in this file
+ * are typically constraints on a large number of variables that
+ * only involve a few of those variables.
+ * Several of the functions below therefore skip the zero elements
+ * of their inputs such that the number of (potentially expensive)
+ * arithmetic operations is proportional to the number of non-zero
+ * elements rather than to the length of the sequences.
+ */
+
 void isl_seq_submul(isl_int *dst, isl_int f, isl_int *src, unsigned len)
 {
 	int i;
 	for (i = 0; i < len; ++i)
-		isl_int_submul(dst[i], f, src[i]);
+		if (!isl_int_is_zero(src[i]))
+			isl_int_submul(dst[i], f, src[i]);
 }
 
 void isl_seq_addmul(isl_int *dst, isl_int f, isl_int *src, unsigned len)
 {
 	int i;
 	for (i = 0; i < len; ++i)
-		isl_int_addmul(dst[i], f, src[i]);
+		if (!isl_int_is_zero(src[i]))
+			isl_int_addmul(dst[i], f, src[i]);
 }
 
 void isl_seq_swp_or_cpy(isl_int *dst, isl_int *src, unsigned len)
@@ -70,15 +81,23 @@ void isl_seq_swp_or_cpy(isl_int *dst, isl_int *src, unsigned len)
 void isl_seq_scale(isl_int *dst, isl_int *src, isl_int m, unsigned len)
 {
 	int i;
-	for (i = 0; i < len; ++i)
-		isl_int_mul(dst[i], src[i], m);
+	for (i = 0; i < len; ++i) {
+		if (isl_int_is_zero(src[i]))
+			isl_int_set_si(dst[i], 0);
+		else
+			isl_int_mul(dst[i], src[i], m);
+	}
 }
 
 void isl_seq_scale_down(isl_int *dst, isl_int *src, isl_int m, unsigned len)
 {
 	int i;
-	for (i = 0; i < len; ++i)
-		isl_int_divexact(dst[i], src[i], m);
+	for (i = 0; i < len; ++i) {
+		if (isl_int_is_zero(src[i]))
+			isl_int_set_si(dst[i], 0);
+		else
+			isl_int_divexact(dst[i], src[i], m);
+	}
 }
 
 void isl_seq_cdiv_q(isl_int *dst, isl_int *src, isl_int m, unsigned len)
@@ -111,13 +130,20 @@ void isl_seq_combine(isl_int *dst, isl_int m1, isl_int *src1,
 	if (dst == src1 && isl_int_is_one(m1)) {
 		if (isl_int_is_zero(m2))
 			return;
-		for (i = 0; i < len; ++i)
-			isl_int_addmul(src1[i], m2, src2[i]);
+		isl_seq_addmul(src1, m2, src2, len);
 		return;
 	}
 
 	isl_int_init(tmp);
 	for (i = 0; i < len; ++i) {
+		if (isl_int_is_zero(src2[i])) {
+			isl_int_mul(dst[i], m1, src1[i]);
+			continue;
+		}
+		if (isl_int_is_zero(src1[i])) {
+			isl_int_mul(dst[i], m2, src2[i]);
+			continue;
+		}
 		isl_int_mul(tmp, m1, src1[i]);
 		isl_int_addmul(tmp, m2, src2[i]);
 		isl_int_set(dst[i], tmp);
@@ -286,7 +312,8 @@ void isl_seq_inner_product(isl_int *p1, isl_int *p2, unsigned len,
 	}
 	isl_int_mul(*prod, p1[0], p2[0]);
 	for (i = 1; i < len; ++i)
-		isl_int_addmul(*prod, p1[i], p2[i]);
+		if (!isl_int_is_zero(p1[i]))
+			isl_int_addmul(*prod, p1[i], p2[i]);
 }
 
 uint32_t isl_seq_hash(isl_int *p, unsigned len, uint32_t hash)
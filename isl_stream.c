@@ -129,11 +129,18 @@ void isl_token_free(struct isl_token *tok)
 	free(tok);
 }
 
+/* Report a syntax error at "tok" or, if "tok" is NULL,
+ * at the current position of "s".
+ * Nothing is printed if "s" has been marked silent.
+ */
 void isl_stream_error(__isl_keep isl_stream *s, struct isl_token *tok,
 	char *msg)
 {
 	int line = tok ? tok->line : s->line;
 	int col = tok ? tok->col : s->col;
+
+	if (s->silent)
+		return;
 	fprintf(stderr, "syntax error (%d, %d): %s\n", line, col, msg);
 	if (tok) {
 		if (tok->type < 256)
@@ -167,6 +174,15 @@ void isl_stream_error(__isl_keep isl_stream *s, struct isl_token *tok,
 	}
 }
 
+/* Mark "s" as being silent or not, depending on "silent".
+ * Syntax errors are not printed on a silent stream.
+ */
+void isl_stream_set_silent(__isl_keep isl_stream *s, int silent)
+{
+	if (s)
+		s->silent = silent;
+}
+
 static __isl_give isl_stream* isl_stream_new(struct isl_ctx *ctx)
 {
 	int i;
@@ -198,12 +214,24 @@ error:
 	return NULL;
 }
 
+/* Create a stream that reads from "file".
+ * If "file" is seekable, then the characters that are read
+ * from "file", but not consumed by the stream,
+ * can be returned to "file" when the stream is freed.
+ * It can therefore be read in blocks into s->file_buffer.
+ */
 __isl_give isl_stream* isl_stream_new_file(struct isl_ctx *ctx, FILE *file)
 {
 	isl_stream *s = isl_stream_new(ctx);
 	if (!s)
 		return NULL;
 	s->file = file;
+	if (file && fseek(file, 0, SEEK_CUR) == 0) {
+		s->file_size = 1 << 16;
+		s->file_buffer = isl_alloc_array(ctx, char, s->file_size);
+		if (!s->file_buffer)
+			s->file_size = 0;
+	}
 	return s;
 }
 
@@ -219,6 +247,38 @@ __isl_give isl_stream* isl_stream_new_str(struct isl_ctx *ctx, const char *str)
 	return s;
 }
 
+/* Read a character from s->file, refilling s->file_buffer
+ * if it has been exhausted.
+ */
+static int file_getc(__isl_keep isl_stream *s)
+{
+	if (!s->file_buffer)
+		return fgetc(s->file);
+	if (s->file_pos >= s->file_len) {
+		s->file_len = fread(s->file_buffer, 1, s->file_size, s->file);
+		s->file_pos = 0;
+		if (s->file_len == 0)
+			return -1;
+	}
+	return (unsigned char) s->file_buffer[s->file_pos++];
+}
+
+/* Return the characters that have been read from s->file into
+ * s->file_buffer, but that have not been consumed, to s->file.
+ */
+static void file_return_unread(__isl_keep isl_stream *s)
+{
+	long n;
+
+	if (!s->file_buffer || s->file_pos >= s->file_len)
+		return;
+	n = s->file_len - s->file_pos;
+	if (fseek(s->file, -n, SEEK_CUR) != 0)
+		isl_die(s->ctx, isl_error_unknown,
+			"unable to return unread characters to file", return);
+	s->file_len = s->file_pos;
+}
+
 /* Read a character from the stream and advance s->line and s->col
  * to point to the next character.
  */
@@ -230,7 +290,7 @@ static int stream_getc(__isl_keep isl_stream *s)
 	if (s->n_un)
 		return s->c = s->un[--s->n_un];
 	if (s->file)
-		c = fgetc(s->file);
+		c = file_getc(s);
 	else {
 		c = *s->str++;
 		if (c == '\0')
@@ -276,6 +336,21 @@ static int isl_stream_getc(__isl_keep isl_stream *s)
 	return '\\';
 }
 
+/* Read a single character from "s" without any interpretation.
+ * This is used to read the compact encoding of isl objects
+ * and may only be called if no tokens have been pushed back.
+ */
+int isl_stream_getc_raw(__isl_keep isl_stream *s)
+{
+	if (!s)
+		return -1;
+	if (s->n_token != 0)
+		isl_die(s->ctx, isl_error_invalid,
+			"cannot read characters after reading tokens",
+			return -1);
+	return stream_getc(s);
+}
+
 static int isl_stream_push_char(__isl_keep isl_stream *s, int c)
 {
 	if (s->len >= s->size) {
@@ -296,48 +371,77 @@ void isl_stream_push_token(__isl_keep isl_stream *s, struct isl_token *tok)
 	s->tokens[s->n_token++] = tok;
 }
 
+/* The built-in keywords, placed at the position in the table
+ * given by builtin_keyword_hash.
+ */
+static struct {
+	const char		*name;
+	enum isl_token_type	type;
+} builtin_keywords[32] = {
+	{ "floord", ISL_TOKEN_FLOORD },
+	{ "not", ISL_TOKEN_NOT },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "implies", ISL_TOKEN_IMPLIES },
+	{ "false", ISL_TOKEN_FALSE },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "infinity", ISL_TOKEN_INFTY },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "max", ISL_TOKEN_MAX },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "ceild", ISL_TOKEN_CEILD },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "infty", ISL_TOKEN_INFTY },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "floor", ISL_TOKEN_FLOOR },
+	{ "exists", ISL_TOKEN_EXISTS },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "mod", ISL_TOKEN_MOD },
+	{ "rat", ISL_TOKEN_RAT },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "ceil", ISL_TOKEN_CEIL },
+	{ "and", ISL_TOKEN_AND },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "NaN", ISL_TOKEN_NAN },
+	{ NULL, ISL_TOKEN_IDENT },
+	{ "true", ISL_TOKEN_TRUE },
+	{ "min", ISL_TOKEN_MIN },
+	{ "or", ISL_TOKEN_OR },
+};
+
+/* Return the position in builtin_keywords of the only built-in keyword
+ * that may be equal to the identifier "name" of length "len" (> 0).
+ * The hash function only depends on the length and on the first
+ * and last characters, ignoring case, and does not map any
+ * two built-in keywords to the same position.
+ */
+static int builtin_keyword_hash(const char *name, size_t len)
+{
+	int first = tolower((unsigned char) name[0]);
+	int last = tolower((unsigned char) name[len - 1]);
+
+	return (29 * (len + first) + last) % 32;
+}
+
+/* Return the type of the (case-insensitive) keyword in s->buffer,
+ * or ISL_TOKEN_IDENT if it is not a keyword.
+ * The built-in keywords are looked up in builtin_keywords
+ * such that at most one string comparison is needed.
+ */
 static enum isl_token_type check_keywords(__isl_keep isl_stream *s)
 {
 	struct isl_hash_table_entry *entry;
 	struct isl_keyword *keyword;
 	uint32_t name_hash;
+	int pos;
 
-	if (!strcasecmp(s->buffer, "exists"))
-		return ISL_TOKEN_EXISTS;
-	if (!strcasecmp(s->buffer, "and"))
-		return ISL_TOKEN_AND;
-	if (!strcasecmp(s->buffer, "or"))
-		return ISL_TOKEN_OR;
-	if (!strcasecmp(s->buffer, "implies"))
-		return ISL_TOKEN_IMPLIES;
-	if (!strcasecmp(s->buffer, "not"))
-		return ISL_TOKEN_NOT;
-	if (!strcasecmp(s->buffer, "infty"))
-		return ISL_TOKEN_INFTY;
-	if (!strcasecmp(s->buffer, "infinity"))
-		return ISL_TOKEN_INFTY;
-	if (!strcasecmp(s->buffer, "NaN"))
-		return ISL_TOKEN_NAN;
-	if (!strcasecmp(s->buffer, "min"))
-		return ISL_TOKEN_MIN;
-	if (!strcasecmp(s->buffer, "max"))
-		return ISL_TOKEN_MAX;
-	if (!strcasecmp(s->buffer, "rat"))
-		return ISL_TOKEN_RAT;
-	if (!strcasecmp(s->buffer, "true"))
-		return ISL_TOKEN_TRUE;
-	if (!strcasecmp(s->buffer, "false"))
-		return ISL_TOKEN_FALSE;
-	if (!strcasecmp(s->buffer, "ceild"))
-		return ISL_TOKEN_CEILD;
-	if (!strcasecmp(s->buffer, "floord"))
-		return ISL_TOKEN_FLOORD;
-	if (!strcasecmp(s->buffer, "mod"))
-		return ISL_TOKEN_MOD;
-	if (!strcasecmp(s->buffer, "ceil"))
-		return ISL_TOKEN_CEIL;
-	if (!strcasecmp(s->buffer, "floor"))
-		return ISL_TOKEN_FLOOR;
+	pos = builtin_keyword_hash(s->buffer, s->len - 1);
+	if (builtin_keywords[pos].name &&
+	    !strcasecmp(s->buffer, builtin_keywords[pos].name))
+		return builtin_keywords[pos].type;
 
 	if (!s->keywords)
 		return ISL_TOKEN_IDENT;
@@ -783,6 +887,9 @@ void isl_stream_free(__isl_take isl_stream *s)
 	if (!s)
 		return;
 	free(s->buffer);
+	if (s->file)
+		file_return_unread(s);
+	free(s->file_buffer);
 	if (s->n_token != 0) {
 		struct isl_token *tok = isl_stream_next_token(s);
 		isl_stream_error(s, tok, "unexpected token");
@@ -21,6 +21,8 @@ struct isl_token {
 struct isl_token *isl_token_new(isl_ctx *ctx,
 	int line, int col, unsigned on_new_line);
 
+int isl_stream_getc_raw(__isl_keep isl_stream *s);
+
 /* An input stream that may be either a file or a string.
  *
  * line and col are the line and column number of the next character (1-based).
@@ -28,6 +30,13 @@ struct isl_token *isl_token_new(isl_ctx *ctx,
  * to the position of the returned character.
  * last_line is the line number of the previous token.
  *
+ * If "file" is seekable, then it is read in blocks of file_size
+ * characters into file_buffer, of which file_len characters are valid and
+ * file_pos characters have already been consumed.  The characters
+ * that have not been consumed are returned to "file"
+ * when the stream is freed.
+ * Otherwise, file_buffer is NULL and "file" is read character by character.
+ *
  * yaml_state and yaml_indent keep track of the currently active YAML
  * elements.  yaml_size is the size of these arrays, while yaml_depth
  * is the number of elements currently in use.
@@ -37,10 +46,16 @@ struct isl_token *isl_token_new(isl_ctx *ctx,
  * yaml_indent keeps track of the indentation at each level, with
  * ISL_YAML_INDENT_FLOW meaning that the element is in flow format
  * (such that the indentation is not relevant).
+ *
+ * If "silent" is set, then syntax errors are not printed.
  */
 struct isl_stream {
 	struct isl_ctx	*ctx;
 	FILE        	*file;
+	char		*file_buffer;
+	size_t		file_size;
+	size_t		file_len;
+	size_t		file_pos;
 	const char  	*str;
 	int	    	line;
 	int	    	col;
@@ -66,4 +81,8 @@ struct isl_stream {
 	int			yaml_size;
 	enum isl_yaml_state	*yaml_state;
 	int			*yaml_indent;
+
+	int			silent;
 };
+
+void isl_stream_set_silent(__isl_keep isl_stream *s, int silent);
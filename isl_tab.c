@@ -1072,6 +1072,27 @@ static void update_row_sign(struct isl_tab *tab, int row, int col, int row_sgn)
 	}
 }
 
+/* Divide the elements of "row" of length "len" by their greatest
+ * common divisor.
+ * The first element is the positive denominator of the row, which
+ * is typically small compared to the other elements.
+ * Start computing the greatest common divisor from this element and
+ * stop as soon as it has been reduced to one.
+ */
+static void normalize_row(isl_ctx *ctx, isl_int *row, unsigned len)
+{
+	int i;
+
+	isl_int_set(ctx->normalize_gcd, row[0]);
+	for (i = 1; i < len && !isl_int_is_one(ctx->normalize_gcd); ++i) {
+		if (isl_int_is_zero(row[i]))
+			continue;
+		isl_int_gcd(ctx->normalize_gcd, ctx->normalize_gcd, row[i]);
+	}
+	if (!isl_int_is_one(ctx->normalize_gcd))
+		isl_seq_scale_down(row, row, ctx->normalize_gcd, len);
+}
+
 /* Given a row number "row" and a column number "col", pivot the tableau
  * such that the associated variables are interchanged.
  * The given row in the tableau expresses
@@ -1121,12 +1142,18 @@ static void update_row_sign(struct isl_tab *tab, int row, int col, int row_sgn)
  * s(n_rc)d_r/|n_rc|		-s(n_rc)n_ri/|n_rc|
  * s(n_rc)d_r n_jc/(|n_rc| d_j)	(n_ji |n_rc| - s(n_rc)n_jc n_ri)/(|n_rc| d_j)
  *
+ * If the denominator of the normalized pivot row is one,
+ * i.e., if |n_rc| divides d_r and all n_ri, then the other rows
+ * do not need to be multiplied by this denominator.
+ * In any case, the elements of the pivot row that are zero
+ * do not affect the other rows.
  */
 int isl_tab_pivot(struct isl_tab *tab, int row, int col)
 {
 	int i, j;
 	int sgn;
 	int t;
+	int unit;
 	isl_ctx *ctx;
 	struct isl_mat *mat = tab->mat;
 	struct isl_tab_var *var;
@@ -1148,25 +1175,31 @@ int isl_tab_pivot(struct isl_tab *tab, int row, int col)
 			isl_int_neg(mat->row[row][1 + j], mat->row[row][1 + j]);
 		}
 	if (!isl_int_is_one(mat->row[row][0]))
-		isl_seq_normalize(mat->ctx, mat->row[row], off + tab->n_col);
+		normalize_row(mat->ctx, mat->row[row], off + tab->n_col);
+	unit = isl_int_is_one(mat->row[row][0]);
 	for (i = 0; i < tab->n_row; ++i) {
 		if (i == row)
 			continue;
 		if (isl_int_is_zero(mat->row[i][off + col]))
 			continue;
-		isl_int_mul(mat->row[i][0], mat->row[i][0], mat->row[row][0]);
+		if (!unit)
+			isl_int_mul(mat->row[i][0],
+				    mat->row[i][0], mat->row[row][0]);
 		for (j = 0; j < off - 1 + tab->n_col; ++j) {
 			if (j == off - 1 + col)
 				continue;
-			isl_int_mul(mat->row[i][1 + j],
+			if (!unit)
+				isl_int_mul(mat->row[i][1 + j],
 				    mat->row[i][1 + j], mat->row[row][0]);
+			if (isl_int_is_zero(mat->row[row][1 + j]))
+				continue;
 			isl_int_addmul(mat->row[i][1 + j],
 				    mat->row[i][off + col], mat->row[row][1 + j]);
 		}
 		isl_int_mul(mat->row[i][off + col],
 			    mat->row[i][off + col], mat->row[row][off + col]);
 		if (!isl_int_is_one(mat->row[i][0]))
-			isl_seq_normalize(mat->ctx, mat->row[i], off + tab->n_col);
+			normalize_row(mat->ctx, mat->row[i], off + tab->n_col);
 	}
 	t = tab->row_var[row];
 	tab->row_var[row] = tab->col_var[col];
@@ -1841,6 +1874,8 @@ int isl_tab_add_row(struct isl_tab *tab, isl_int *line)
 	for (i = 0; i < tab->n_var; ++i) {
 		if (tab->var[i].is_zero)
 			continue;
+		if (isl_int_is_zero(line[1 + i]))
+			continue;
 		if (tab->var[i].is_row) {
 			isl_int_lcm(a,
 				row[0], tab->mat->row[tab->var[i].index][0]);
@@ -17,7 +17,12 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <limits.h>
+#include "isl_config.h"
+#if HAVE_DECL_MKDTEMP
+#include <unistd.h>
+#endif
 #include <isl_ctx_private.h>
 #include <isl_map_private.h>
 #include <isl_aff_private.h>
@@ -39,6 +44,7 @@
 #include <isl/ilp.h>
 #include <isl_ast_build_expr.h>
 #include <isl/options.h>
+#include <isl/stream.h>
 
 #include "isl_srcdir.c"
 
@@ -453,6 +459,357 @@ int test_parse(struct isl_ctx *ctx)
 	return 0;
 }
 
+/* isl_stream_read_union_map_foreach_map callback that
+ * adds "map" to the union map pointed to by "user".
+ */
+static isl_stat add_read_map(__isl_take isl_map *map, void *user)
+{
+	isl_union_map **umap = user;
+
+	*umap = isl_union_map_add_map(*umap, map);
+
+	return *umap ? isl_stat_ok : isl_stat_error;
+}
+
+/* isl_stream_read_union_set_foreach_set callback that
+ * adds "set" to the union set pointed to by "user".
+ */
+static isl_stat add_read_set(__isl_take isl_set *set, void *user)
+{
+	isl_union_set **uset = user;
+
+	*uset = isl_union_set_add_set(*uset, set);
+
+	return *uset ? isl_stat_ok : isl_stat_error;
+}
+
+/* Check that reading a union map or union set disjunct by disjunct
+ * produces the same result as reading it as a whole.
+ */
+static int test_read_foreach(isl_ctx *ctx)
+{
+	const char *str;
+	isl_stream *s;
+	isl_union_map *umap1, *umap2;
+	isl_union_set *uset1, *uset2;
+	isl_stat r;
+	isl_bool equal;
+
+	str = "[n] -> { A[i] -> B[i] : i < n; A[i] -> C[] : i > 0 or i < -5; "
+		"A[i] -> B[i + 1] : i > n; D[] -> [x = 5] }";
+	umap1 = isl_union_map_read_from_str(ctx, str);
+	umap2 = isl_union_map_empty(isl_union_map_get_space(umap1));
+	s = isl_stream_new_str(ctx, str);
+	r = isl_stream_read_union_map_foreach_map(s, &add_read_map, &umap2);
+	isl_stream_free(s);
+	equal = r < 0 ? isl_bool_error :
+				isl_union_map_is_equal(umap1, umap2);
+	isl_union_map_free(umap1);
+	isl_union_map_free(umap2);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"union map not read correctly", return -1);
+
+	str = "{ A[i] : 0 <= i < 10; B[]; A[i] : i = 20 }";
+	uset1 = isl_union_set_read_from_str(ctx, str);
+	uset2 = isl_union_set_empty(isl_union_set_get_space(uset1));
+	s = isl_stream_new_str(ctx, str);
+	r = isl_stream_read_union_set_foreach_set(s, &add_read_set, &uset2);
+	isl_stream_free(s);
+	equal = r < 0 ? isl_bool_error :
+				isl_union_set_is_equal(uset1, uset2);
+	isl_union_set_free(uset1);
+	isl_union_set_free(uset2);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"union set not read correctly", return -1);
+
+	return 0;
+}
+
+/* isl_union_map_str_foreach_chunk callback that parses "chunk" and
+ * adds the result to the union map pointed to by "user".
+ * The chunk is parsed in a separate isl_ctx and transferred
+ * through the binary encoding, as it would be if it were parsed
+ * on a different thread.
+ */
+static isl_stat add_chunk(__isl_take char *chunk, void *user)
+{
+	isl_union_map **umap = user;
+	isl_ctx *ctx, *chunk_ctx;
+	isl_union_map *part;
+	isl_printer *p;
+	isl_stream *s;
+	char *str;
+
+	ctx = isl_union_map_get_ctx(*umap);
+	chunk_ctx = isl_ctx_alloc();
+	part = isl_union_map_read_from_str(chunk_ctx, chunk);
+	free(chunk);
+	p = isl_printer_to_str(chunk_ctx);
+	p = isl_printer_set_output_format(p, ISL_FORMAT_BINARY);
+	p = isl_printer_print_union_map(p, part);
+	str = isl_printer_get_str(p);
+	isl_printer_free(p);
+	isl_union_map_free(part);
+	isl_ctx_free(chunk_ctx);
+	if (!str)
+		return isl_stat_error;
+
+	s = isl_stream_new_str(ctx, str);
+	part = isl_stream_read_binary_union_map(s);
+	isl_stream_free(s);
+	free(str);
+	*umap = isl_union_map_union(*umap, part);
+
+	return *umap ? isl_stat_ok : isl_stat_error;
+}
+
+/* Inputs for test_read_chunks.
+ */
+static const char *read_chunks_tests[] = {
+	"[n] -> { A[i] -> B[i] : i < n; A[i] -> C[] : i > 0 or i < -5; "
+	    "A[i] -> B[i + 1] : exists (e : i = 2e and e > n); "
+	    "# comment; with a semicolon\n"
+	    "D[] -> [x = 5]; E[i] -> [floor((i + 1)/2)]; }",
+	"{ [i] -> [j] : i = j }",
+	"[n] -> { }",
+	"{ Sym = [n] [i] -> [n] }",
+};
+
+/* Check that splitting "str" into chunks of roughly "size" characters,
+ * parsing those chunks separately and combining the results produces
+ * the same union map as parsing "str" in one go.
+ */
+static int test_read_chunks_size(isl_ctx *ctx, const char *str, int size)
+{
+	isl_union_map *umap1, *umap2;
+	isl_stat r;
+	isl_bool equal;
+
+	umap1 = isl_union_map_read_from_str(ctx, str);
+	umap2 = isl_union_map_empty(isl_union_map_get_space(umap1));
+	r = isl_union_map_str_foreach_chunk(ctx, str, size, &add_chunk, &umap2);
+	equal = r < 0 ? isl_bool_error : isl_union_map_is_equal(umap1, umap2);
+	isl_union_map_free(umap1);
+	isl_union_map_free(umap2);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"chunks not read correctly", return -1);
+
+	return 0;
+}
+
+/* Check that reading union maps in chunks of various sizes
+ * produces the same results as reading them in one go.
+ */
+static int test_read_chunks(isl_ctx *ctx)
+{
+	int i, size;
+
+	for (i = 0; i < ARRAY_SIZE(read_chunks_tests); ++i)
+		for (size = 1; size < 100; size *= 4)
+			if (test_read_chunks_size(ctx, read_chunks_tests[i],
+						size) < 0)
+				return -1;
+
+	return 0;
+}
+
+/* Inputs for test_read_trusted.
+ */
+static const char *read_trusted_tests[] = {
+	"{ [i] -> [j] : 2 i = j and j = 2i and i >= 0 and i <= 10 and i < 20 }",
+	"[n] -> { A[i] -> B[j] : 0 <= i < n and j = i + 1 and not (i = 5); "
+	    "A[i] -> C[] : i > n or (i < -5 and i > -10) }",
+	"{ [i] -> [j] : 2 * floor(i/2) + 3 * floor(j/4) <= 10 and 2 i = j }",
+	"{ [m] -> [w] : exists (a : w >= 0 and a < m and "
+	    "-1 + w <= a <= 2m - w) }",
+	"{ [i] -> [] : i >= 0 and i <= 10 and i >= 0 }",
+};
+
+/* Inputs for test_read_trusted_eq, each containing equality constraints
+ * that are not in normal form, along with an equivalent description
+ * in normal form.
+ */
+static struct {
+	const char *input;
+	const char *normal;
+} read_trusted_eq_tests[] = {
+	{ "{ [i] : 2i = 6 }", "{ [3] }" },
+	{ "{ [i, j] : i = j and j = 3 and i >= 0 }", "{ [3, 3] }" },
+	{ "{ [i, j] : 2i = 4j and j >= 0 and i <= 10 }",
+	  "{ [i, j] : i = 2j and 0 <= j <= 5 }" },
+	{ "{ [i] : 3i = 5 }", "{ [i] : false }" },
+	{ "{ [i] : i = 2 and i >= 5 }", "{ [i] : false }" },
+};
+
+/* Check that equality constraints that are not in normal form
+ * are handled correctly when the trusted-input option is set.
+ * In particular, check that the result is equal to
+ * the corresponding set in normal form and
+ * that it can be passed to isl_set_is_subset,
+ * which requires the equality constraints to be in normal form.
+ */
+static int test_read_trusted_eq(isl_ctx *ctx)
+{
+	int i;
+	int trusted;
+
+	trusted = isl_options_get_trusted_input(ctx);
+	isl_options_set_trusted_input(ctx, 1);
+	for (i = 0; i < ARRAY_SIZE(read_trusted_eq_tests); ++i) {
+		isl_set *set1, *set2;
+		isl_bool equal, subset;
+
+		set1 = isl_set_read_from_str(ctx,
+					read_trusted_eq_tests[i].input);
+		set2 = isl_set_read_from_str(ctx,
+					read_trusted_eq_tests[i].normal);
+		equal = isl_set_is_equal(set1, set2);
+		subset = isl_set_is_subset(set1, set2);
+		isl_set_free(set1);
+		isl_set_free(set2);
+		if (equal < 0 || subset < 0)
+			goto error;
+		if (!equal || !subset)
+			isl_die(ctx, isl_error_unknown,
+				"trusted input not read correctly", goto error);
+	}
+	isl_options_set_trusted_input(ctx, trusted);
+
+	return 0;
+error:
+	isl_options_set_trusted_input(ctx, trusted);
+	return -1;
+}
+
+/* Check that simplifying conjunctions of plain affine constraints
+ * once per conjunction produces the expected results and
+ * that reading the output of isl back in with the trusted-input option
+ * set produces the same union map and the same output.
+ * Also check that equality constraints that are not in normal form
+ * are handled correctly with the trusted-input option set.
+ */
+static int test_read_trusted(isl_ctx *ctx)
+{
+	int i;
+	int trusted;
+
+	trusted = isl_options_get_trusted_input(ctx);
+	for (i = 0; i < ARRAY_SIZE(read_trusted_tests); ++i) {
+		isl_union_map *umap1, *umap2;
+		char *str1, *str2;
+		isl_bool equal;
+		int same;
+
+		isl_options_set_trusted_input(ctx, 0);
+		umap1 = isl_union_map_read_from_str(ctx, read_trusted_tests[i]);
+		str1 = isl_union_map_to_str(umap1);
+		isl_options_set_trusted_input(ctx, 1);
+		umap2 = isl_union_map_read_from_str(ctx, str1);
+		str2 = isl_union_map_to_str(umap2);
+		equal = isl_union_map_is_equal(umap1, umap2);
+		same = str1 && str2 && !strcmp(str1, str2);
+		isl_union_map_free(umap1);
+		isl_union_map_free(umap2);
+		free(str1);
+		free(str2);
+		if (equal < 0)
+			goto error;
+		if (!equal || !same)
+			isl_die(ctx, isl_error_unknown,
+				"trusted input not read correctly", goto error);
+	}
+	isl_options_set_trusted_input(ctx, trusted);
+
+	return test_read_trusted_eq(ctx);
+error:
+	isl_options_set_trusted_input(ctx, trusted);
+	return -1;
+}
+
+/* Check that several objects can be read from a seekable file,
+ * both through separate streams and through a single stream,
+ * even if the file is larger than the blocks in which it is read.
+ * The first set is written out with a long stretch of white space
+ * such that it does not fit in a single block.
+ * After the sets have been read through separate streams,
+ * the characters that were read into the block buffer
+ * but not consumed should have been returned to the file.
+ * When reading through a single stream, also check that a token
+ * that is pushed back onto the stream is read again.
+ */
+static int test_read_file_blocks(isl_ctx *ctx)
+{
+	int i;
+	FILE *file;
+	char rest[10];
+	isl_set *set1, *set2, *big, *small;
+	isl_stream *s;
+	struct isl_token *tok;
+	struct isl_obj obj1, obj2;
+	int equal, ok;
+
+	file = tmpfile();
+	if (!file)
+		isl_die(ctx, isl_error_unknown, "unable to open temporary file",
+			return -1);
+	fprintf(file, "{ [i] :");
+	for (i = 0; i < 100000; ++i)
+		fputc(' ', file);
+	fprintf(file, "0 <= i < 10 }\n{ [i] : i >= 5 }\nrest\n");
+	big = isl_set_read_from_str(ctx, "{ [i] : 0 <= i < 10 }");
+	small = isl_set_read_from_str(ctx, "{ [i] : i >= 5 }");
+
+	rewind(file);
+	set1 = isl_set_read_from_file(ctx, file);
+	set2 = isl_set_read_from_file(ctx, file);
+	ok = fscanf(file, "%9s", rest) == 1 && !strcmp(rest, "rest");
+	equal = isl_set_is_equal(set1, big);
+	if (equal >= 0 && equal)
+		equal = isl_set_is_equal(set2, small);
+	isl_set_free(set1);
+	isl_set_free(set2);
+
+	rewind(file);
+	s = isl_stream_new_file(ctx, file);
+	obj1 = isl_stream_read_obj(s);
+	tok = isl_stream_next_token(s);
+	if (tok)
+		isl_stream_push_token(s, tok);
+	obj2 = isl_stream_read_obj(s);
+	isl_stream_free(s);
+	if (equal >= 0 && equal && tok &&
+	    obj1.type == isl_obj_set && obj2.type == isl_obj_set) {
+		equal = isl_set_is_equal(obj1.v, big);
+		if (equal >= 0 && equal)
+			equal = isl_set_is_equal(obj2.v, small);
+	} else if (equal >= 0)
+		equal = 0;
+	if (obj1.v)
+		obj1.type->free(obj1.v);
+	if (obj2.v)
+		obj2.type->free(obj2.v);
+
+	fclose(file);
+	isl_set_free(big);
+	isl_set_free(small);
+	if (equal < 0)
+		return -1;
+	if (!equal || !ok)
+		isl_die(ctx, isl_error_unknown,
+			"sets not read back correctly from file", return -1);
+
+	return 0;
+}
+
 static int test_read(isl_ctx *ctx)
 {
 	char *filename;
@@ -483,6 +840,15 @@ static int test_read(isl_ctx *ctx)
 		isl_die(ctx, isl_error_unknown,
 			"read sets not equal", return -1);
 
+	if (test_read_foreach(ctx) < 0)
+		return -1;
+	if (test_read_chunks(ctx) < 0)
+		return -1;
+	if (test_read_trusted(ctx) < 0)
+		return -1;
+	if (test_read_file_blocks(ctx) < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -4315,113 +4681,468 @@ static int test_skewing_schedule(isl_ctx *ctx)
 	return test_special_schedule(ctx, D, V, P, S);
 }
 
-int test_schedule(isl_ctx *ctx)
+/* Check that the scheduler still produces a valid schedule
+ * when it runs out of its operation budget and that it reports
+ * that it switched to cheaper strategies.
+ * Also check that no such switch is reported without a budget.
+ */
+static int test_budget_schedule(isl_ctx *ctx)
 {
-	const char *D, *W, *R, *V, *P, *S;
-	int max_coincidence;
-	int treat_coalescing;
+	const char *D, *V;
+	int max_operations;
+	int fallbacks;
+	isl_union_map *validity, *sched, *order;
+	isl_schedule_constraints *sc;
+	isl_schedule *schedule;
+	isl_bool valid;
+
+	D = "[n] -> { A[i, j] : 0 <= i, j < n; B[i, j] : 0 <= i, j < n; "
+		"C[i] : 0 <= i < n }";
+	V = "[n] -> { A[i, j] -> A[i, j + 1] : 0 <= i < n and 0 <= j < n - 1; "
+		"A[i, j] -> B[j, i] : 0 <= i, j < n; "
+		"B[i, j] -> B[i + 1, j] : 0 <= i < n - 1 and 0 <= j < n; "
+		"B[i, j] -> C[i] : 0 <= i, j < n }";
+	validity = isl_union_map_read_from_str(ctx, V);
+	sc = isl_schedule_constraints_on_domain(
+				isl_union_set_read_from_str(ctx, D));
+	sc = isl_schedule_constraints_set_validity(sc,
+				isl_union_map_copy(validity));
+	sc = isl_schedule_constraints_set_proximity(sc,
+				isl_union_map_copy(validity));
+
+	schedule = isl_schedule_constraints_compute_schedule(
+				isl_schedule_constraints_copy(sc));
+	isl_schedule_free(schedule);
+	fallbacks = isl_ctx_last_schedule_fallbacks(ctx);
 
-	/* Handle resulting schedule with zero bands. */
-	if (test_one_schedule(ctx, "{[]}", "{}", "{}", "{[] -> []}", 0, 0) < 0)
-		return -1;
+	max_operations = isl_options_get_schedule_max_operations(ctx);
+	isl_options_set_schedule_max_operations(ctx, 1);
+	schedule = isl_schedule_constraints_compute_schedule(sc);
+	isl_options_set_schedule_max_operations(ctx, max_operations);
 
-	/* Jacobi */
-	D = "[T,N] -> { S1[t,i] : 1 <= t <= T and 2 <= i <= N - 1 }";
-	W = "{ S1[t,i] -> a[t,i] }";
-	R = "{ S1[t,i] -> a[t-1,i]; S1[t,i] -> a[t-1,i-1]; "
-	    	"S1[t,i] -> a[t-1,i+1] }";
-	S = "{ S1[t,i] -> [t,i] }";
-	if (test_one_schedule(ctx, D, W, R, S, 2, 0) < 0)
-		return -1;
+	if (fallbacks != isl_schedule_fallback_none)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected fallback without budget",
+			schedule = isl_schedule_free(schedule));
+	fallbacks = isl_ctx_last_schedule_fallbacks(ctx);
+	if (schedule && fallbacks == isl_schedule_fallback_none)
+		isl_die(ctx, isl_error_unknown, "expecting fallback",
+			schedule = isl_schedule_free(schedule));
 
-	/* Fig. 5 of CC2008 */
-	D = "[N] -> { S_0[i, j] : i >= 0 and i <= -1 + N and j >= 2 and "
-				"j <= -1 + N }";
-	W = "[N] -> { S_0[i, j] -> a[i, j] : i >= 0 and i <= -1 + N and "
-				"j >= 2 and j <= -1 + N }";
-	R = "[N] -> { S_0[i, j] -> a[j, i] : i >= 0 and i <= -1 + N and "
-				"j >= 2 and j <= -1 + N; "
-		    "S_0[i, j] -> a[i, -1 + j] : i >= 0 and i <= -1 + N and "
-				"j >= 2 and j <= -1 + N }";
-	S = "[N] -> { S_0[i, j] -> [0, i, 0, j, 0] }";
-	if (test_one_schedule(ctx, D, W, R, S, 2, 0) < 0)
-		return -1;
+	sched = isl_schedule_get_map(schedule);
+	isl_schedule_free(schedule);
+	order = isl_union_map_lex_lt_union_map(isl_union_map_copy(sched),
+					    isl_union_map_copy(sched));
+	valid = isl_union_map_is_subset(validity, order);
+	isl_union_map_free(order);
+	isl_union_map_free(sched);
+	isl_union_map_free(validity);
 
-	D = "{ S1[i] : 0 <= i <= 10; S2[i] : 0 <= i <= 9 }";
-	W = "{ S1[i] -> a[i] }";
-	R = "{ S2[i] -> a[i+1] }";
-	S = "{ S1[i] -> [0,i]; S2[i] -> [1,i] }";
-	if (test_one_schedule(ctx, D, W, R, S, 1, 1) < 0)
+	if (valid < 0)
 		return -1;
+	if (!valid)
+		isl_die(ctx, isl_error_unknown,
+			"schedule violates validity constraints", return -1);
 
-	D = "{ S1[i] : 0 <= i < 10; S2[i] : 0 <= i < 10 }";
-	W = "{ S1[i] -> a[i] }";
-	R = "{ S2[i] -> a[9-i] }";
-	S = "{ S1[i] -> [0,i]; S2[i] -> [1,i] }";
-	if (test_one_schedule(ctx, D, W, R, S, 1, 1) < 0)
-		return -1;
+	return 0;
+}
 
-	D = "[N] -> { S1[i] : 0 <= i < N; S2[i] : 0 <= i < N }";
-	W = "{ S1[i] -> a[i] }";
-	R = "[N] -> { S2[i] -> a[N-1-i] }";
-	S = "{ S1[i] -> [0,i]; S2[i] -> [1,i] }";
-	if (test_one_schedule(ctx, D, W, R, S, 1, 1) < 0)
-		return -1;
-	
-	D = "{ S1[i] : 0 < i < 10; S2[i] : 0 <= i < 10 }";
-	W = "{ S1[i] -> a[i]; S2[i] -> b[i] }";
-	R = "{ S2[i] -> a[i]; S1[i] -> b[i-1] }";
-	S = "{ S1[i] -> [i,0]; S2[i] -> [i,1] }";
-	if (test_one_schedule(ctx, D, W, R, S, 0, 0) < 0)
-		return -1;
+/* Construct schedule constraints on the domain "D" with validity and
+ * proximity constraints "V" and context "C".
+ */
+static __isl_give isl_schedule_constraints *construct_schedule_constraints(
+	isl_ctx *ctx, const char *D, const char *V, const char *C)
+{
+	isl_schedule_constraints *sc;
 
-	D = "[N] -> { S1[i] : 1 <= i <= N; S2[i,j] : 1 <= i,j <= N }";
-	W = "{ S1[i] -> a[0,i]; S2[i,j] -> a[i,j] }";
-	R = "{ S2[i,j] -> a[i-1,j] }";
-	S = "{ S1[i] -> [0,i,0]; S2[i,j] -> [1,i,j] }";
-	if (test_one_schedule(ctx, D, W, R, S, 2, 1) < 0)
-		return -1;
+	sc = isl_schedule_constraints_on_domain(
+				isl_union_set_read_from_str(ctx, D));
+	sc = isl_schedule_constraints_set_context(sc,
+				isl_set_read_from_str(ctx, C));
+	sc = isl_schedule_constraints_set_validity(sc,
+				isl_union_map_read_from_str(ctx, V));
+	sc = isl_schedule_constraints_set_proximity(sc,
+				isl_union_map_read_from_str(ctx, V));
 
-	D = "[N] -> { S1[i] : 1 <= i <= N; S2[i,j] : 1 <= i,j <= N }";
-	W = "{ S1[i] -> a[i,0]; S2[i,j] -> a[i,j] }";
-	R = "{ S2[i,j] -> a[i,j-1] }";
-	S = "{ S1[i] -> [0,i,0]; S2[i,j] -> [1,i,j] }";
-	if (test_one_schedule(ctx, D, W, R, S, 2, 1) < 0)
-		return -1;
+	return sc;
+}
 
-	D = "[N] -> { S_0[]; S_1[i] : i >= 0 and i <= -1 + N; S_2[] }";
-	W = "[N] -> { S_0[] -> a[0]; S_2[] -> b[0]; "
-		    "S_1[i] -> a[1 + i] : i >= 0 and i <= -1 + N }";
-	R = "[N] -> { S_2[] -> a[N]; S_1[i] -> a[i] : i >= 0 and i <= -1 + N }";
-	S = "[N] -> { S_1[i] -> [1, i, 0]; S_2[] -> [2, 0, 1]; "
-		    "S_0[] -> [0, 0, 0] }";
-	if (test_one_schedule(ctx, D, W, R, S, 1, 0) < 0)
-		return -1;
-	ctx->opt->schedule_parametric = 0;
-	if (test_one_schedule(ctx, D, W, R, S, 0, 0) < 0)
-		return -1;
-	ctx->opt->schedule_parametric = 1;
+/* Compute a schedule for "sc" and return a union map representation.
+ */
+static __isl_give isl_union_map *compute_schedule_map(
+	__isl_take isl_schedule_constraints *sc)
+{
+	isl_schedule *schedule;
+	isl_union_map *sched;
 
-	D = "[N] -> { S1[i] : 1 <= i <= N; S2[i] : 1 <= i <= N; "
-		    "S3[i,j] : 1 <= i,j <= N; S4[i] : 1 <= i <= N }";
-	W = "{ S1[i] -> a[i,0]; S2[i] -> a[0,i]; S3[i,j] -> a[i,j] }";
-	R = "[N] -> { S3[i,j] -> a[i-1,j]; S3[i,j] -> a[i,j-1]; "
-		    "S4[i] -> a[i,N] }";
-	S = "{ S1[i] -> [0,i,0]; S2[i] -> [1,i,0]; S3[i,j] -> [2,i,j]; "
-		"S4[i] -> [4,i,0] }";
-	max_coincidence = isl_options_get_schedule_maximize_coincidence(ctx);
-	isl_options_set_schedule_maximize_coincidence(ctx, 0);
-	if (test_one_schedule(ctx, D, W, R, S, 2, 0) < 0)
-		return -1;
-	isl_options_set_schedule_maximize_coincidence(ctx, max_coincidence);
+	schedule = isl_schedule_constraints_compute_schedule(sc);
+	sched = isl_schedule_get_map(schedule);
+	isl_schedule_free(schedule);
 
-	D = "[N] -> { S_0[i, j] : i >= 1 and i <= N and j >= 1 and j <= N }";
-	W = "[N] -> { S_0[i, j] -> s[0] : i >= 1 and i <= N and j >= 1 and "
-					"j <= N }";
-	R = "[N] -> { S_0[i, j] -> s[0] : i >= 1 and i <= N and j >= 1 and "
-					"j <= N; "
-		    "S_0[i, j] -> a[i, j] : i >= 1 and i <= N and j >= 1 and "
-					"j <= N }";
+	return sched;
+}
+
+/* Return the schedule of the statement instances in "filter"
+ * in the subtree of "schedule" below the (set or sequence) child
+ * of the root that contains these instances.
+ */
+static __isl_give isl_union_map *get_component_schedule(
+	__isl_keep isl_schedule *schedule, const char *filter)
+{
+	int i, n;
+	isl_union_set *dom;
+	isl_union_map *map;
+	isl_schedule_node *node;
+
+	dom = isl_union_set_read_from_str(isl_schedule_get_ctx(schedule),
+					filter);
+	node = isl_schedule_get_root(schedule);
+	node = isl_schedule_node_child(node, 0);
+	n = isl_schedule_node_n_children(node);
+	for (i = 0; i < n; ++i) {
+		isl_union_set *child_filter;
+		isl_bool disjoint;
+
+		node = isl_schedule_node_child(node, i);
+		child_filter = isl_schedule_node_filter_get_filter(node);
+		disjoint = isl_union_set_is_disjoint(child_filter, dom);
+		isl_union_set_free(child_filter);
+		if (disjoint < 0)
+			node = isl_schedule_node_free(node);
+		if (disjoint <= 0)
+			break;
+		node = isl_schedule_node_parent(node);
+	}
+	node = isl_schedule_node_child(node, 0);
+	map = isl_schedule_node_get_subtree_schedule_union_map(node);
+	isl_schedule_node_free(node);
+
+	return isl_union_map_intersect_domain(map, dom);
+}
+
+/* Check that "schedule" respects the validity constraints "V".
+ */
+static int check_valid_schedule(__isl_keep isl_schedule *schedule,
+	const char *V)
+{
+	isl_ctx *ctx;
+	isl_union_map *validity, *sched, *order;
+	isl_bool valid;
+
+	if (!schedule)
+		return -1;
+	ctx = isl_schedule_get_ctx(schedule);
+	validity = isl_union_map_read_from_str(ctx, V);
+	sched = isl_schedule_get_map(schedule);
+	order = isl_union_map_lex_lt_union_map(isl_union_map_copy(sched),
+					    sched);
+	valid = isl_union_map_is_subset(validity, order);
+	isl_union_map_free(order);
+	isl_union_map_free(validity);
+
+	if (valid < 0)
+		return -1;
+	if (!valid)
+		isl_die(ctx, isl_error_unknown,
+			"schedule violates validity constraints", return -1);
+
+	return 0;
+}
+
+/* isl_schedule_foreach_schedule_node_top_down callback that
+ * sets *user if the filter of a filter node or the partial schedule
+ * of a band node refers to instances of a statement called "B".
+ */
+static isl_bool mentions_B(__isl_keep isl_schedule_node *node, void *user)
+{
+	int *found = user;
+	isl_union_set *uset;
+	isl_union_map *umap;
+	isl_set *set;
+	isl_bool empty;
+
+	switch (isl_schedule_node_get_type(node)) {
+	case isl_schedule_node_filter:
+		uset = isl_schedule_node_filter_get_filter(node);
+		break;
+	case isl_schedule_node_band:
+		umap = isl_schedule_node_band_get_partial_schedule_union_map(
+									node);
+		uset = isl_union_map_domain(umap);
+		break;
+	default:
+		return isl_bool_true;
+	}
+	set = isl_union_set_extract_set(uset, isl_space_set_alloc(
+			isl_schedule_node_get_ctx(node), 0, 1));
+	isl_union_set_free(uset);
+	set = isl_set_set_tuple_name(set, "B");
+	empty = isl_set_plain_is_empty(set);
+	isl_set_free(set);
+	if (empty < 0)
+		return isl_bool_error;
+	if (!empty)
+		*found = 1;
+
+	return isl_bool_true;
+}
+
+/* Check that isl_schedule_constraints_recompute_schedule reuses
+ * the previous schedule of a component that is not affected
+ * by the addition of a statement,
+ * that it recomputes the schedule of a component if the previous
+ * schedule no longer respects the validity constraints, and
+ * that statements that have been removed do not appear
+ * in a reused schedule.
+ * The previous schedule is constructed by hand and schedules A and B
+ * in reverse order, which the scheduler would never do by itself,
+ * such that the schedule of A and B can only be equal
+ * to this schedule if it is reused.
+ */
+static int test_recompute_schedule(isl_ctx *ctx)
+{
+	const char *P, *D1, *D2, *V2, *V3, *D4;
+	isl_schedule_constraints *sc;
+	isl_schedule *prev, *schedule;
+	isl_union_map *map1, *map2;
+	isl_bool equal;
+	int found = 0;
+	int r;
+
+	P = "domain: \"[n] -> { A[i] : 0 <= i < n; B[i] : 0 <= i < n; "
+		"E[i, j] : 0 <= i, j < n }\"\n"
+	    "child:\n"
+	    "  set:\n"
+	    "  - filter: \"{ A[i]; B[i] }\"\n"
+	    "    child:\n"
+	    "      schedule: \"[{ A[i] -> [(-i)]; B[i] -> [(-i)] }]\"\n"
+	    "      child:\n"
+	    "        sequence:\n"
+	    "        - filter: \"{ A[i] }\"\n"
+	    "        - filter: \"{ B[i] }\"\n"
+	    "  - filter: \"{ E[i, j] }\"\n"
+	    "    child:\n"
+	    "      schedule: \"[{ E[i, j] -> [(i)] }, "
+				"{ E[i, j] -> [(j)] }]\"\n";
+	D1 = "[n] -> { A[i] : 0 <= i < n; B[i] : 0 <= i < n; "
+		"E[i, j] : 0 <= i, j < n }";
+	D2 = "[n] -> { A[i] : 0 <= i < n; B[i] : 0 <= i < n; "
+		"E[i, j] : 0 <= i, j < n; F[i] : 0 <= i < n }";
+	V2 = "[n] -> { A[i] -> B[i] : 0 <= i < n; "
+		"E[i, j] -> E[i, j + 1] : 0 <= i < n and 0 <= j < n - 1; "
+		"E[i, j] -> F[i] : 0 <= i, j < n }";
+	V3 = "[n] -> { A[i] -> B[i] : 0 <= i < n; "
+		"A[i] -> B[i + 1] : 0 <= i < n - 1; "
+		"E[i, j] -> E[i, j + 1] : 0 <= i < n and 0 <= j < n - 1 }";
+	D4 = "[n] -> { A[i] : 0 <= i < n }";
+
+	prev = isl_schedule_read_from_str(ctx, P);
+
+	sc = construct_schedule_constraints(ctx, D2, V2, "[n] -> { : }");
+	schedule = isl_schedule_constraints_recompute_schedule(sc,
+						isl_schedule_copy(prev));
+	r = check_valid_schedule(schedule, V2);
+	map1 = get_component_schedule(prev, "[n] -> { A[i]; B[i] }");
+	map2 = get_component_schedule(schedule, "[n] -> { A[i]; B[i] }");
+	equal = isl_union_map_is_equal(map1, map2);
+	isl_union_map_free(map1);
+	isl_union_map_free(map2);
+	isl_schedule_free(schedule);
+	if (r >= 0 && equal < 0)
+		r = -1;
+	if (r >= 0 && !equal)
+		isl_die(ctx, isl_error_unknown,
+			"schedule of unaffected component not reused",
+			r = -1);
+
+	sc = construct_schedule_constraints(ctx, D1, V3, "[n] -> { : }");
+	schedule = isl_schedule_constraints_recompute_schedule(sc,
+						isl_schedule_copy(prev));
+	if (r >= 0)
+		r = check_valid_schedule(schedule, V3);
+	isl_schedule_free(schedule);
+
+	sc = construct_schedule_constraints(ctx, D4, "{ }", "[n] -> { : }");
+	schedule = isl_schedule_constraints_recompute_schedule(sc, prev);
+	if (r >= 0)
+		r = check_valid_schedule(schedule, "{ }");
+	map1 = isl_schedule_get_map(schedule);
+	map1 = isl_union_map_intersect_domain(map1,
+				isl_union_set_read_from_str(ctx, D4));
+	map2 = isl_union_map_read_from_str(ctx,
+					"[n] -> { A[i] -> [-i] : 0 <= i < n }");
+	equal = isl_union_map_is_equal(map1, map2);
+	isl_union_map_free(map1);
+	isl_union_map_free(map2);
+	if (isl_schedule_foreach_schedule_node_top_down(schedule,
+						&mentions_B, &found) < 0)
+		equal = isl_bool_error;
+	isl_schedule_free(schedule);
+	if (r >= 0 && equal < 0)
+		r = -1;
+	if (r >= 0 && !equal)
+		isl_die(ctx, isl_error_unknown,
+			"schedule of remaining statement not reused", r = -1);
+	if (r >= 0 && found)
+		isl_die(ctx, isl_error_unknown,
+			"removed statement appears in reused schedule",
+			r = -1);
+
+	return r;
+}
+
+/* Check that computing a schedule from a copy of some schedule constraints
+ * for which a schedule has already been computed,
+ * possibly reusing the duals of the dependence relations
+ * computed during the first computation, produces the same schedule and
+ * that these duals are not reused after the context has been modified.
+ * The context n = 1 results in compressed nodes.
+ */
+static int test_reused_schedule_constraints(isl_ctx *ctx)
+{
+	const char *D, *V, *C;
+	isl_schedule_constraints *sc;
+	isl_union_map *sched1, *sched2, *sched3, *expected;
+	isl_bool equal;
+
+	D = "[n] -> { S[i, j] : 0 <= i, j < n; T[i] : 0 <= i < n }";
+	V = "[n] -> { S[i, j] -> S[i, j + 1] : 0 <= i < n and 0 <= j < n - 1;"
+		"S[i, j] -> T[i] : 0 <= i, j < n }";
+	C = "[n] -> { : n = 1 }";
+	sc = construct_schedule_constraints(ctx, D, V, "{ : }");
+	sched1 = compute_schedule_map(isl_schedule_constraints_copy(sc));
+	sched2 = compute_schedule_map(isl_schedule_constraints_copy(sc));
+	sc = isl_schedule_constraints_set_context(sc,
+				isl_set_read_from_str(ctx, C));
+	sched3 = compute_schedule_map(sc);
+	expected = compute_schedule_map(
+			construct_schedule_constraints(ctx, D, V, C));
+
+	equal = isl_union_map_is_equal(sched1, sched2);
+	if (equal >= 0 && equal)
+		equal = isl_union_map_is_equal(sched3, expected);
+	isl_union_map_free(sched1);
+	isl_union_map_free(sched2);
+	isl_union_map_free(sched3);
+	isl_union_map_free(expected);
+
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"schedule depends on reuse of schedule constraints",
+			return -1);
+
+	return 0;
+}
+
+int test_schedule(isl_ctx *ctx)
+{
+	const char *D, *W, *R, *V, *P, *S;
+	int max_coincidence;
+	int treat_coalescing;
+
+	/* Handle resulting schedule with zero bands. */
+	if (test_one_schedule(ctx, "{[]}", "{}", "{}", "{[] -> []}", 0, 0) < 0)
+		return -1;
+
+	/* Jacobi */
+	D = "[T,N] -> { S1[t,i] : 1 <= t <= T and 2 <= i <= N - 1 }";
+	W = "{ S1[t,i] -> a[t,i] }";
+	R = "{ S1[t,i] -> a[t-1,i]; S1[t,i] -> a[t-1,i-1]; "
+	    	"S1[t,i] -> a[t-1,i+1] }";
+	S = "{ S1[t,i] -> [t,i] }";
+	if (test_one_schedule(ctx, D, W, R, S, 2, 0) < 0)
+		return -1;
+
+	/* Fig. 5 of CC2008 */
+	D = "[N] -> { S_0[i, j] : i >= 0 and i <= -1 + N and j >= 2 and "
+				"j <= -1 + N }";
+	W = "[N] -> { S_0[i, j] -> a[i, j] : i >= 0 and i <= -1 + N and "
+				"j >= 2 and j <= -1 + N }";
+	R = "[N] -> { S_0[i, j] -> a[j, i] : i >= 0 and i <= -1 + N and "
+				"j >= 2 and j <= -1 + N; "
+		    "S_0[i, j] -> a[i, -1 + j] : i >= 0 and i <= -1 + N and "
+				"j >= 2 and j <= -1 + N }";
+	S = "[N] -> { S_0[i, j] -> [0, i, 0, j, 0] }";
+	if (test_one_schedule(ctx, D, W, R, S, 2, 0) < 0)
+		return -1;
+
+	D = "{ S1[i] : 0 <= i <= 10; S2[i] : 0 <= i <= 9 }";
+	W = "{ S1[i] -> a[i] }";
+	R = "{ S2[i] -> a[i+1] }";
+	S = "{ S1[i] -> [0,i]; S2[i] -> [1,i] }";
+	if (test_one_schedule(ctx, D, W, R, S, 1, 1) < 0)
+		return -1;
+
+	D = "{ S1[i] : 0 <= i < 10; S2[i] : 0 <= i < 10 }";
+	W = "{ S1[i] -> a[i] }";
+	R = "{ S2[i] -> a[9-i] }";
+	S = "{ S1[i] -> [0,i]; S2[i] -> [1,i] }";
+	if (test_one_schedule(ctx, D, W, R, S, 1, 1) < 0)
+		return -1;
+
+	D = "[N] -> { S1[i] : 0 <= i < N; S2[i] : 0 <= i < N }";
+	W = "{ S1[i] -> a[i] }";
+	R = "[N] -> { S2[i] -> a[N-1-i] }";
+	S = "{ S1[i] -> [0,i]; S2[i] -> [1,i] }";
+	if (test_one_schedule(ctx, D, W, R, S, 1, 1) < 0)
+		return -1;
+	
+	D = "{ S1[i] : 0 < i < 10; S2[i] : 0 <= i < 10 }";
+	W = "{ S1[i] -> a[i]; S2[i] -> b[i] }";
+	R = "{ S2[i] -> a[i]; S1[i] -> b[i-1] }";
+	S = "{ S1[i] -> [i,0]; S2[i] -> [i,1] }";
+	if (test_one_schedule(ctx, D, W, R, S, 0, 0) < 0)
+		return -1;
+
+	D = "[N] -> { S1[i] : 1 <= i <= N; S2[i,j] : 1 <= i,j <= N }";
+	W = "{ S1[i] -> a[0,i]; S2[i,j] -> a[i,j] }";
+	R = "{ S2[i,j] -> a[i-1,j] }";
+	S = "{ S1[i] -> [0,i,0]; S2[i,j] -> [1,i,j] }";
+	if (test_one_schedule(ctx, D, W, R, S, 2, 1) < 0)
+		return -1;
+
+	D = "[N] -> { S1[i] : 1 <= i <= N; S2[i,j] : 1 <= i,j <= N }";
+	W = "{ S1[i] -> a[i,0]; S2[i,j] -> a[i,j] }";
+	R = "{ S2[i,j] -> a[i,j-1] }";
+	S = "{ S1[i] -> [0,i,0]; S2[i,j] -> [1,i,j] }";
+	if (test_one_schedule(ctx, D, W, R, S, 2, 1) < 0)
+		return -1;
+
+	D = "[N] -> { S_0[]; S_1[i] : i >= 0 and i <= -1 + N; S_2[] }";
+	W = "[N] -> { S_0[] -> a[0]; S_2[] -> b[0]; "
+		    "S_1[i] -> a[1 + i] : i >= 0 and i <= -1 + N }";
+	R = "[N] -> { S_2[] -> a[N]; S_1[i] -> a[i] : i >= 0 and i <= -1 + N }";
+	S = "[N] -> { S_1[i] -> [1, i, 0]; S_2[] -> [2, 0, 1]; "
+		    "S_0[] -> [0, 0, 0] }";
+	if (test_one_schedule(ctx, D, W, R, S, 1, 0) < 0)
+		return -1;
+	ctx->opt->schedule_parametric = 0;
+	if (test_one_schedule(ctx, D, W, R, S, 0, 0) < 0)
+		return -1;
+	ctx->opt->schedule_parametric = 1;
+
+	D = "[N] -> { S1[i] : 1 <= i <= N; S2[i] : 1 <= i <= N; "
+		    "S3[i,j] : 1 <= i,j <= N; S4[i] : 1 <= i <= N }";
+	W = "{ S1[i] -> a[i,0]; S2[i] -> a[0,i]; S3[i,j] -> a[i,j] }";
+	R = "[N] -> { S3[i,j] -> a[i-1,j]; S3[i,j] -> a[i,j-1]; "
+		    "S4[i] -> a[i,N] }";
+	S = "{ S1[i] -> [0,i,0]; S2[i] -> [1,i,0]; S3[i,j] -> [2,i,j]; "
+		"S4[i] -> [4,i,0] }";
+	max_coincidence = isl_options_get_schedule_maximize_coincidence(ctx);
+	isl_options_set_schedule_maximize_coincidence(ctx, 0);
+	if (test_one_schedule(ctx, D, W, R, S, 2, 0) < 0)
+		return -1;
+	isl_options_set_schedule_maximize_coincidence(ctx, max_coincidence);
+
+	D = "[N] -> { S_0[i, j] : i >= 1 and i <= N and j >= 1 and j <= N }";
+	W = "[N] -> { S_0[i, j] -> s[0] : i >= 1 and i <= N and j >= 1 and "
+					"j <= N }";
+	R = "[N] -> { S_0[i, j] -> s[0] : i >= 1 and i <= N and j >= 1 and "
+					"j <= N; "
+		    "S_0[i, j] -> a[i, j] : i >= 1 and i <= N and j >= 1 and "
+					"j <= N }";
 	S = "[N] -> { S_0[i, j] -> [0, i, 0, j, 0] }";
 	if (test_one_schedule(ctx, D, W, R, S, 0, 0) < 0)
 		return -1;
@@ -4624,6 +5345,12 @@ int test_schedule(isl_ctx *ctx)
 		return -1;
 	if (test_skewing_schedule(ctx) < 0)
 		return -1;
+	if (test_reused_schedule_constraints(ctx) < 0)
+		return -1;
+	if (test_budget_schedule(ctx) < 0)
+		return -1;
+	if (test_recompute_schedule(ctx) < 0)
+		return -1;
 
 	return 0;
 }
@@ -4660,6 +5387,152 @@ static int test_schedule_incremental(isl_ctx *ctx)
 	return r;
 }
 
+/* Compute a schedule for the schedule constraints described by "domain"
+ * and "validity" and check that the number of schedule cache hits
+ * increases by "hit" and that the number of misses increases by !hit.
+ */
+static __isl_give isl_schedule *compute_cached_schedule(isl_ctx *ctx,
+	const char *domain, const char *validity, int hit)
+{
+	isl_union_set *dom;
+	isl_union_map *dep;
+	isl_schedule_constraints *sc;
+	isl_schedule *schedule;
+	int hits, misses;
+
+	hits = isl_ctx_get_schedule_cache_hits(ctx);
+	misses = isl_ctx_get_schedule_cache_misses(ctx);
+	dom = isl_union_set_read_from_str(ctx, domain);
+	dep = isl_union_map_read_from_str(ctx, validity);
+	sc = isl_schedule_constraints_on_domain(dom);
+	sc = isl_schedule_constraints_set_validity(sc, dep);
+	schedule = isl_schedule_constraints_compute_schedule(sc);
+	if (isl_ctx_get_schedule_cache_hits(ctx) != hits + hit ||
+	    isl_ctx_get_schedule_cache_misses(ctx) != misses + !hit)
+		isl_die(ctx, isl_error_unknown, "unexpected cache statistics",
+			return isl_schedule_free(schedule));
+
+	return schedule;
+}
+
+/* Replace the schedule in the schedule cache entry "name"
+ * by an invalid schedule, keeping the header line intact.
+ */
+static isl_stat corrupt_cache_entry(isl_ctx *ctx, const char *name)
+{
+	FILE *file;
+	char header[100];
+	int ok;
+
+	file = fopen(name, "r");
+	if (!file)
+		isl_die(ctx, isl_error_unknown, "unable to open cache entry",
+			return isl_stat_error);
+	ok = fgets(header, sizeof(header), file) != NULL;
+	fclose(file);
+	if (!ok)
+		isl_die(ctx, isl_error_unknown, "unable to read cache entry",
+			return isl_stat_error);
+
+	file = fopen(name, "w");
+	if (!file)
+		isl_die(ctx, isl_error_unknown, "unable to open cache entry",
+			return isl_stat_error);
+	fprintf(file, "%s{ domain: \"{ A[i] }\", child: ]\n", header);
+	fclose(file);
+
+	return isl_stat_ok;
+}
+
+#if HAVE_DECL_MKDTEMP
+
+/* Check that a schedule stored in the schedule cache directory
+ * is found again when the same schedule constraints are scheduled,
+ * but not when the scheduler options change, and
+ * that the cached schedule is the same as the computed schedule.
+ * Also check that a corrupted entry is treated as missing and
+ * that it does not leave an error behind.
+ * The cache directory is a freshly created temporary directory and
+ * it only holds a single entry.  Both are removed at the end.
+ */
+static int test_schedule_cache(isl_ctx *ctx)
+{
+	const char *domain, *validity;
+	const char *tmpdir;
+	char dir[200], entry[250];
+	isl_schedule *schedule1, *schedule2;
+	int size, outer;
+	isl_bool equal;
+
+	domain = "[n] -> { A[i, j] : 0 <= i, j < n; B[i] : 0 <= i < n }";
+	validity = "[n] -> { A[i, j] -> A[i, j + 1]; A[i, n - 1] -> B[i] }";
+
+	tmpdir = getenv("TMPDIR");
+	if (!tmpdir)
+		tmpdir = "/tmp";
+	snprintf(dir, sizeof(dir), "%s/isl_test.XXXXXX", tmpdir);
+	if (!mkdtemp(dir))
+		isl_die(ctx, isl_error_unknown,
+			"unable to create temporary directory", return -1);
+	snprintf(entry, sizeof(entry), "%s/isl-schedule-0.yaml", dir);
+
+	size = isl_options_get_schedule_cache_size(ctx);
+	outer = isl_options_get_schedule_outer_coincidence(ctx);
+	isl_options_set_schedule_cache_dir(ctx, dir);
+	isl_options_set_schedule_cache_size(ctx, 1);
+
+	schedule1 = compute_cached_schedule(ctx, domain, validity, 0);
+	schedule2 = compute_cached_schedule(ctx, domain, validity, 1);
+	equal = isl_schedule_plain_is_equal(schedule1, schedule2);
+	isl_schedule_free(schedule1);
+	isl_schedule_free(schedule2);
+	if (equal >= 0 && !equal)
+		isl_die(ctx, isl_error_unknown,
+			"cached schedule not equal to computed schedule",
+			equal = isl_bool_error);
+
+	if (equal >= 0 && corrupt_cache_entry(ctx, entry) < 0)
+		equal = isl_bool_error;
+	if (equal >= 0) {
+		schedule1 = compute_cached_schedule(ctx, domain, validity, 0);
+		if (!schedule1)
+			equal = isl_bool_error;
+		isl_schedule_free(schedule1);
+	}
+	if (equal >= 0 && isl_ctx_last_error(ctx) != isl_error_none)
+		isl_die(ctx, isl_error_unknown,
+			"corrupted cache entry left error behind",
+			equal = isl_bool_error);
+
+	if (equal >= 0) {
+		isl_options_set_schedule_outer_coincidence(ctx, !outer);
+		schedule1 = compute_cached_schedule(ctx, domain, validity, 0);
+		isl_options_set_schedule_outer_coincidence(ctx, outer);
+		if (!schedule1)
+			equal = isl_bool_error;
+		isl_schedule_free(schedule1);
+	}
+
+	remove(entry);
+	rmdir(dir);
+	isl_options_set_schedule_cache_dir(ctx, "");
+	isl_options_set_schedule_cache_size(ctx, size);
+
+	return equal < 0 ? -1 : 0;
+}
+
+#else
+
+/* The schedule cache test requires a temporary directory,
+ * which cannot be created without mkdtemp.
+ */
+static int test_schedule_cache(isl_ctx *ctx)
+{
+	return 0;
+}
+
+#endif
+
 int test_plain_injective(isl_ctx *ctx, const char *str, int injective)
 {
 	isl_union_map *umap;
@@ -6935,9 +7808,263 @@ static int test_output_set(isl_ctx *ctx)
 	return 0;
 }
 
-int test_output(isl_ctx *ctx)
-{
-	char *s;
+/* Descriptions of union maps that are tested for reading back
+ * after printing them in the compact binary encoding.
+ */
+const char *output_binary_tests[] = {
+	"{ A[i] -> B[i + 1] : 0 <= i < 10; C[] -> D[0] }",
+	"[n] -> { S[i, j] -> [t = i + j] : i mod 3 = 0 and 0 <= j < n }",
+	"{ [[a] -> [b]] -> C[floor((a + 2b)/5)] : a >= -123456789012345678901 }",
+	"{ rat: [x] -> [y] : 2y = x and 0 <= x <= 7 }",
+	"[N, M] -> { A[i] -> B[j] : i > 2N or j < M; A[5] -> C[] }",
+	"{ [x] -> [y] : false }",
+};
+
+/* Check that printing a union map in the compact binary encoding and
+ * reading it back in results in the same union map.
+ * Also check that piecewise and multi affine expressions
+ * survive such a round trip.
+ */
+static int test_output_binary(isl_ctx *ctx)
+{
+	int i;
+	char *str;
+	isl_printer *p;
+	isl_stream *s;
+	isl_union_map *umap1, *umap2;
+	isl_pw_aff *pa1, *pa2;
+	isl_multi_aff *ma1, *ma2;
+	isl_bool equal;
+
+	for (i = 0; i < ARRAY_SIZE(output_binary_tests); ++i) {
+		umap1 = isl_union_map_read_from_str(ctx,
+						    output_binary_tests[i]);
+		p = isl_printer_to_str(ctx);
+		p = isl_printer_set_output_format(p, ISL_FORMAT_BINARY);
+		p = isl_printer_print_union_map(p, umap1);
+		str = isl_printer_get_str(p);
+		isl_printer_free(p);
+		s = isl_stream_new_str(ctx, str ? str : "");
+		umap2 = isl_stream_read_binary_union_map(s);
+		isl_stream_free(s);
+		free(str);
+		equal = isl_union_map_is_equal(umap1, umap2);
+		isl_union_map_free(umap1);
+		isl_union_map_free(umap2);
+		if (equal < 0)
+			return -1;
+		if (!equal)
+			isl_die(ctx, isl_error_unknown,
+				"binary output not read back correctly",
+				return -1);
+	}
+
+	pa1 = isl_pw_aff_read_from_str(ctx,
+		"[n] -> { A[i] -> [floor(i/3) + n] : i >= 0; A[i] -> [-i] : i < 0 }");
+	ma1 = isl_multi_aff_read_from_str(ctx,
+		"{ [i, j] -> T[j, floor((i + j)/4), 99999999999999999999] }");
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_set_output_format(p, ISL_FORMAT_BINARY);
+	p = isl_printer_print_pw_aff(p, pa1);
+	p = isl_printer_print_multi_aff(p, ma1);
+	str = isl_printer_get_str(p);
+	isl_printer_free(p);
+	s = isl_stream_new_str(ctx, str ? str : "");
+	pa2 = isl_stream_read_binary_pw_aff(s);
+	ma2 = isl_stream_read_binary_multi_aff(s);
+	isl_stream_free(s);
+	free(str);
+	equal = isl_pw_aff_is_equal(pa1, pa2);
+	if (equal >= 0 && equal)
+		equal = isl_multi_aff_plain_is_equal(ma1, ma2);
+	isl_pw_aff_free(pa1);
+	isl_pw_aff_free(pa2);
+	isl_multi_aff_free(ma1);
+	isl_multi_aff_free(ma2);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"binary output not read back correctly", return -1);
+
+	return 0;
+}
+
+/* The compact binary encoding of { [i] -> [j] : i >= 0 and j >= i }.
+ */
+static const char *binary_map = "`@mA???@Ai??@Aj@@@??A?C??AC";
+
+/* Malformed variations of "binary_map" that should be rejected
+ * (without trying to allocate huge amounts of memory).
+ * The first has a version number with a bit set beyond
+ * the bits of an unsigned long.
+ * The second claims to contain INT_MAX basic maps and
+ * the third claims to contain a basic map with INT_MAX inequalities.
+ */
+static const char *binary_fail_tests[] = {
+	"``___________OmA???@Ai??@Aj@@@??A?C??AC",
+	"`@mA???@Ai??@Aj@~~~~~~@@??A?C??AC",
+	"`@mA???@Ai??@Aj@@@??~~~~~~@?C??AC",
+};
+
+/* Check that the compact binary encoding in "binary_map" can be read
+ * and that the malformed encodings in binary_fail_tests are rejected.
+ */
+static int test_output_binary_fail(isl_ctx *ctx)
+{
+	int i, n;
+	int on_error;
+	isl_stream *s;
+	isl_map *map;
+
+	s = isl_stream_new_str(ctx, binary_map);
+	map = isl_stream_read_binary_map(s);
+	isl_stream_free(s);
+	isl_map_free(map);
+	if (!map)
+		return -1;
+
+	on_error = isl_options_get_on_error(ctx);
+	isl_options_set_on_error(ctx, ISL_ON_ERROR_CONTINUE);
+	n = ARRAY_SIZE(binary_fail_tests);
+	for (i = 0; i < n; ++i) {
+		s = isl_stream_new_str(ctx, binary_fail_tests[i]);
+		map = isl_stream_read_binary_map(s);
+		isl_stream_free(s);
+		isl_map_free(map);
+		if (map)
+			break;
+	}
+	isl_options_set_on_error(ctx, on_error);
+	isl_ctx_reset_error(ctx);
+	if (i < n)
+		isl_die(ctx, isl_error_unknown,
+			"malformed binary encoding not rejected", return -1);
+
+	return 0;
+}
+
+/* Check that union maps and union sets printed in the compact binary
+ * encoding to a file can be read back in one after the other.
+ */
+static int test_output_binary_file(isl_ctx *ctx)
+{
+	FILE *file;
+	isl_printer *p;
+	isl_union_map *umap1, *umap2;
+	isl_union_set *uset1, *uset2;
+	isl_bool equal;
+
+	file = tmpfile();
+	if (!file)
+		isl_die(ctx, isl_error_unknown, "unable to open temporary file",
+			return -1);
+	umap1 = isl_union_map_read_from_str(ctx, output_binary_tests[1]);
+	uset1 = isl_union_set_read_from_str(ctx,
+		"[n] -> { A[i] : 0 <= i < n; B[i, j] : i = 2j }");
+	p = isl_printer_to_file(ctx, file);
+	p = isl_printer_set_output_format(p, ISL_FORMAT_BINARY);
+	p = isl_printer_print_union_map(p, umap1);
+	p = isl_printer_print_union_set(p, uset1);
+	isl_printer_free(p);
+	rewind(file);
+	umap2 = isl_union_map_read_binary_from_file(ctx, file);
+	uset2 = isl_union_set_read_binary_from_file(ctx, file);
+	fclose(file);
+	equal = isl_union_map_is_equal(umap1, umap2);
+	if (equal >= 0 && equal)
+		equal = isl_union_set_is_equal(uset1, uset2);
+	isl_union_map_free(umap1);
+	isl_union_map_free(umap2);
+	isl_union_set_free(uset1);
+	isl_union_set_free(uset2);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"binary output not read back correctly", return -1);
+
+	return 0;
+}
+
+/* Internal data structure for collect_output.
+ *
+ * "buf" is the concatenation of the "n" chunks received so far and
+ * has room for "size" characters.
+ */
+struct isl_collect_output_data {
+	char *buf;
+	size_t len;
+	size_t size;
+	int n;
+};
+
+/* isl_printer_to_callback callback that appends the chunk "buf"
+ * of length "len" to data->buf.
+ */
+static isl_stat collect_output(const char *buf, size_t len, void *user)
+{
+	struct isl_collect_output_data *data = user;
+
+	if (data->len + len + 1 > data->size) {
+		data->size = 2 * (data->len + len + 1);
+		data->buf = realloc(data->buf, data->size);
+		if (!data->buf)
+			return isl_stat_error;
+	}
+	memcpy(data->buf + data->len, buf, len);
+	data->len += len;
+	data->buf[data->len] = '\0';
+	data->n++;
+
+	return isl_stat_ok;
+}
+
+/* Check that printing a large union map to a callback printer
+ * results in the same output as printing it to a string,
+ * and that this output is passed to the callback in several chunks.
+ */
+static int test_output_callback(isl_ctx *ctx)
+{
+	int i;
+	char *str;
+	char buf[100];
+	isl_printer *p;
+	isl_union_set *uset;
+	struct isl_collect_output_data data = { NULL, 0, 0, 0 };
+	int equal;
+
+	uset = isl_union_set_read_from_str(ctx, "[n] -> { }");
+	for (i = 0; i < 200; ++i) {
+		isl_set *set;
+
+		snprintf(buf, sizeof(buf),
+			"[n] -> { S_%d[i, j] : 0 <= i < n and 0 <= j < %d }",
+			i, i);
+		set = isl_set_read_from_str(ctx, buf);
+		uset = isl_union_set_add_set(uset, set);
+	}
+	str = isl_union_set_to_str(uset);
+	p = isl_printer_to_callback(ctx, &collect_output, &data);
+	p = isl_printer_print_union_set(p, uset);
+	isl_printer_free(p);
+	isl_union_set_free(uset);
+	equal = str && data.buf && !strcmp(str, data.buf);
+	free(str);
+	free(data.buf);
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected callback printer output", return -1);
+	if (data.n < 2)
+		isl_die(ctx, isl_error_unknown,
+			"expecting output in several chunks", return -1);
+
+	return 0;
+}
+
+int test_output(isl_ctx *ctx)
+{
+	char *s;
 	const char *str;
 	isl_pw_aff *pa;
 	isl_printer *p;
@@ -6945,6 +8072,14 @@ int test_output(isl_ctx *ctx)
 
 	if (test_output_set(ctx) < 0)
 		return -1;
+	if (test_output_binary(ctx) < 0)
+		return -1;
+	if (test_output_binary_fail(ctx) < 0)
+		return -1;
+	if (test_output_binary_file(ctx) < 0)
+		return -1;
+	if (test_output_callback(ctx) < 0)
+		return -1;
 
 	str = "[x] -> { [1] : x % 4 <= 2; [2] : x = 3 }";
 	pa = isl_pw_aff_read_from_str(ctx, str);
@@ -8076,6 +9211,619 @@ static int test_ast_expr(isl_ctx *ctx)
 	return 0;
 }
 
+/* Schedules for test_ast_print_stream.
+ */
+static const char *ast_print_stream_tests[] = {
+	"domain: \"[n] -> { A[i] : 0 <= i < n; B[i, j] : 0 <= i, j < n; "
+	    "C[] : n >= 10 }\"\n"
+	"child:\n"
+	"  sequence:\n"
+	"  - filter: \"{ A[i] }\"\n"
+	"    child:\n"
+	"      schedule: \"[{ A[i] -> [(i)] }]\"\n"
+	"  - filter: \"{ B[i, j] }\"\n"
+	"    child:\n"
+	"      schedule: \"[{ B[i, j] -> [(i)] }, { B[i, j] -> [(j)] }]\"\n"
+	"  - filter: \"{ C[] }\"\n",
+	"domain: \"[n] -> { A[i] : 0 <= i < n }\"\n"
+	"child:\n"
+	"  schedule: \"[{ A[i] -> [(i)] }]\"\n",
+};
+
+/* Print "tree" to "p" in the same way as
+ * isl_ast_build_print_from_schedule, i.e., if "tree" is a block,
+ * then print its children one by one.
+ */
+static __isl_give isl_printer *print_top_level(__isl_take isl_printer *p,
+	__isl_keep isl_ast_node *tree)
+{
+	int i, n;
+	isl_ast_node_list *list;
+
+	if (isl_ast_node_get_type(tree) != isl_ast_node_block)
+		return isl_ast_node_print(tree, p,
+			    isl_ast_print_options_alloc(isl_printer_get_ctx(p)));
+
+	list = isl_ast_node_block_get_children(tree);
+	n = isl_ast_node_list_n_ast_node(list);
+	for (i = 0; i < n; ++i) {
+		isl_ast_node *node;
+		isl_ast_print_options *options;
+
+		node = isl_ast_node_list_get_ast_node(list, i);
+		options = isl_ast_print_options_alloc(isl_printer_get_ctx(p));
+		p = isl_ast_node_print(node, p, options);
+		isl_ast_node_free(node);
+	}
+	isl_ast_node_list_free(list);
+
+	return p;
+}
+
+/* Check that printing the AST of each of the schedules
+ * in ast_print_stream_tests while it is being generated
+ * produces the same result as first generating the entire AST
+ * and then printing its top-level statements one by one.
+ */
+static int test_ast_print_stream(isl_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ast_print_stream_tests); ++i) {
+		const char *str = ast_print_stream_tests[i];
+		isl_schedule *schedule;
+		isl_ast_build *build;
+		isl_ast_node *tree;
+		isl_ast_print_options *options;
+		isl_printer *p;
+		char *str1, *str2;
+		int same;
+
+		build = isl_ast_build_alloc(ctx);
+		schedule = isl_schedule_read_from_str(ctx, str);
+		tree = isl_ast_build_node_from_schedule(build, schedule);
+		p = isl_printer_to_str(ctx);
+		p = isl_printer_set_output_format(p, ISL_FORMAT_C);
+		p = print_top_level(p, tree);
+		str1 = isl_printer_get_str(p);
+		isl_printer_free(p);
+		isl_ast_node_free(tree);
+
+		schedule = isl_schedule_read_from_str(ctx, str);
+		p = isl_printer_to_str(ctx);
+		p = isl_printer_set_output_format(p, ISL_FORMAT_C);
+		options = isl_ast_print_options_alloc(ctx);
+		p = isl_ast_build_print_from_schedule(build, schedule,
+							p, options);
+		str2 = isl_printer_get_str(p);
+		isl_printer_free(p);
+		isl_ast_build_free(build);
+
+		same = str1 && str2 && !strcmp(str1, str2);
+		free(str1);
+		free(str2);
+		if (!same)
+			isl_die(ctx, isl_error_unknown,
+				"streamed AST differs", return -1);
+	}
+
+	return 0;
+}
+
+/* Check that constructing the same AST expression twice
+ * in the context of the same isl_ast_build results in a cache hit and
+ * that the cached expression is identical to the original.
+ */
+static int test_ast_expr_cache(isl_ctx *ctx)
+{
+	const char *str = "[N] -> { [(floor((N + 1)/4))] }";
+	isl_set *context;
+	isl_ast_build *build;
+	isl_pw_aff *pa;
+	isl_ast_expr *expr1, *expr2;
+	int hits;
+	int equal;
+
+	context = isl_set_read_from_str(ctx, "[N] -> { : N >= 0 }");
+	build = isl_ast_build_from_context(context);
+	hits = isl_ctx_get_ast_expr_cache_hits(ctx);
+	pa = isl_pw_aff_read_from_str(ctx, str);
+	expr1 = isl_ast_build_expr_from_pw_aff(build, isl_pw_aff_copy(pa));
+	expr2 = isl_ast_build_expr_from_pw_aff(build, pa);
+	isl_ast_build_free(build);
+
+	equal = isl_ast_expr_is_equal(expr1, expr2);
+	isl_ast_expr_free(expr1);
+	isl_ast_expr_free(expr2);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"cached expression differs", return -1);
+	if (isl_ctx_get_ast_expr_cache_hits(ctx) != hits + 1)
+		isl_die(ctx, isl_error_unknown,
+			"expecting cache hit", return -1);
+
+	return 0;
+}
+
+/* Return the condition of the for node at position "pos" of "list".
+ */
+static isl_ast_expr *for_cond(__isl_keep isl_ast_node_list *list, int pos)
+{
+	isl_ast_node *node;
+	isl_ast_expr *cond;
+
+	node = isl_ast_node_list_get_ast_node(list, pos);
+	cond = isl_ast_node_for_get_cond(node);
+	isl_ast_node_free(node);
+
+	return cond;
+}
+
+/* Check that structurally identical expressions in a generated AST
+ * share storage.  In particular, the conditions "c1 < n - 1"
+ * of the two loops should be the same object.
+ */
+static int test_ast_share_exprs(isl_ctx *ctx)
+{
+	const char *str;
+	isl_union_map *schedule;
+	isl_ast_build *build;
+	isl_ast_node *tree;
+	isl_ast_node_list *list;
+	isl_ast_expr *cond1, *cond2;
+	int share, same;
+
+	share = isl_options_get_ast_build_share_exprs(ctx);
+	isl_options_set_ast_build_share_exprs(ctx, 1);
+	str = "[n] -> { A[i] -> [0, i - 1] : 0 <= i < n; "
+		"B[i] -> [1, i - 1] : 0 <= i < n }";
+	schedule = isl_union_map_read_from_str(ctx, str);
+	build = isl_ast_build_alloc(ctx);
+	tree = isl_ast_build_node_from_schedule_map(build, schedule);
+	isl_ast_build_free(build);
+	isl_options_set_ast_build_share_exprs(ctx, share);
+
+	list = isl_ast_node_block_get_children(tree);
+	isl_ast_node_free(tree);
+	cond1 = for_cond(list, 0);
+	cond2 = for_cond(list, 1);
+	isl_ast_node_list_free(list);
+
+	same = cond1 && cond1 == cond2;
+	isl_ast_expr_free(cond1);
+	isl_ast_expr_free(cond2);
+	if (!same)
+		isl_die(ctx, isl_error_unknown,
+			"expecting shared expression", return -1);
+
+	return 0;
+}
+
+/* Check that regenerating an AST with subtree reuse enabled
+ * after modifying one of the children of a sequence node
+ * reuses the AST of the other child and
+ * produces the same result as generating the AST from scratch.
+ */
+static int test_ast_subtree_reuse(isl_ctx *ctx)
+{
+	const char *str;
+	isl_schedule *schedule;
+	isl_schedule_node *node;
+	isl_multi_val *sizes;
+	isl_ast_build *build;
+	isl_ast_node *tree1, *tree2, *tree3;
+	isl_ast_node_list *list1, *list2;
+	isl_ast_node *child1, *child2;
+	char *str2, *str3;
+	int same, reused;
+
+	str = "domain: \"[n] -> { A[i] : 0 <= i < n; B[i] : 0 <= i < n }\"\n"
+	    "child:\n"
+	    "  sequence:\n"
+	    "  - filter: \"{ A[i] }\"\n"
+	    "    child:\n"
+	    "      schedule: \"[{ A[i] -> [(i)] }]\"\n"
+	    "  - filter: \"{ B[i] }\"\n"
+	    "    child:\n"
+	    "      schedule: \"[{ B[i] -> [(i)] }]\"\n";
+	schedule = isl_schedule_read_from_str(ctx, str);
+	build = isl_ast_build_alloc(ctx);
+	build = isl_ast_build_set_subtree_reuse(build, 1);
+	tree1 = isl_ast_build_node_from_schedule(build,
+						isl_schedule_copy(schedule));
+
+	node = isl_schedule_get_root(schedule);
+	isl_schedule_free(schedule);
+	node = isl_schedule_node_child(node, 0);
+	node = isl_schedule_node_child(node, 1);
+	node = isl_schedule_node_child(node, 0);
+	sizes = isl_multi_val_read_from_str(ctx, "{ [4] }");
+	node = isl_schedule_node_band_tile(node, sizes);
+	schedule = isl_schedule_node_get_schedule(node);
+	isl_schedule_node_free(node);
+
+	tree2 = isl_ast_build_node_from_schedule(build,
+						isl_schedule_copy(schedule));
+	isl_ast_build_free(build);
+	build = isl_ast_build_alloc(ctx);
+	tree3 = isl_ast_build_node_from_schedule(build, schedule);
+	isl_ast_build_free(build);
+
+	list1 = isl_ast_node_block_get_children(tree1);
+	list2 = isl_ast_node_block_get_children(tree2);
+	child1 = isl_ast_node_list_get_ast_node(list1, 0);
+	child2 = isl_ast_node_list_get_ast_node(list2, 0);
+	reused = child1 && child1 == child2;
+	isl_ast_node_free(child1);
+	isl_ast_node_free(child2);
+	isl_ast_node_list_free(list1);
+	isl_ast_node_list_free(list2);
+
+	str2 = isl_ast_node_to_C_str(tree2);
+	str3 = isl_ast_node_to_C_str(tree3);
+	same = str2 && str3 && !strcmp(str2, str3);
+	free(str2);
+	free(str3);
+	isl_ast_node_free(tree1);
+	isl_ast_node_free(tree2);
+	isl_ast_node_free(tree3);
+
+	if (!same)
+		isl_die(ctx, isl_error_unknown,
+			"regenerated AST differs", return -1);
+	if (!reused)
+		isl_die(ctx, isl_error_unknown,
+			"expecting AST of unmodified subtree to be reused",
+			return -1);
+
+	return 0;
+}
+
+/* Inputs for test_ast_print_openmp.
+ * "schedule" is a schedule tree, "dependences" are the dependences
+ * that are set on the AST build and "expected" is the expected output
+ * when the AST is printed with the ast_print_openmp option set.
+ */
+static struct {
+	const char *schedule;
+	const char *dependences;
+	const char *expected;
+} print_openmp_tests[] = {
+	{ "domain: \"[n] -> { S[i, j, k] : 0 <= i, j, k < n }\"\n"
+	  "child:\n"
+	  "  schedule: \"[{ S[i, j, k] -> [(i)] }]\"\n"
+	  "  coincident: [ 0 ]\n"
+	  "  child:\n"
+	  "    schedule: \"[{ S[i, j, k] -> [(j)] }, "
+			"{ S[i, j, k] -> [(k)] }]\"\n"
+	  "    coincident: [ 1, 1 ]\n",
+	  "[n] -> { S[i, j, k] -> S[i + 1, j, k] }",
+	  "for (int c0 = 0; c0 < n; c0 += 1) {\n"
+	  "  #pragma omp parallel for\n"
+	  "  for (int c1 = 0; c1 < n; c1 += 1) {\n"
+	  "    #pragma omp simd\n"
+	  "    for (int c2 = 0; c2 < n; c2 += 1)\n"
+	  "      S(c0, c1, c2);\n"
+	  "  }\n"
+	  "}\n" },
+	{ "domain: \"[n] -> { S[i] : 0 <= i < n }\"\n"
+	  "child:\n"
+	  "  schedule: \"[{ S[i] -> [(i)] }]\"\n"
+	  "  coincident: [ 1 ]\n",
+	  "[n] -> { S[i] -> S[i + 1] }",
+	  "for (int c0 = 0; c0 < n; c0 += 1)\n"
+	  "  S(c0);\n" },
+	{ "domain: \"[n] -> { S[i, j] : 0 <= i, j < n }\"\n"
+	  "child:\n"
+	  "  schedule: \"[{ S[i, j] -> [(i)] }, { S[i, j] -> [(j)] }]\"\n"
+	  "  coincident: [ 1, 1 ]\n",
+	  "[n] -> { S[i, j] -> S[i, j + 1] }",
+	  "#pragma omp parallel for\n"
+	  "for (int c0 = 0; c0 < n; c0 += 1)\n"
+	  "  for (int c1 = 0; c1 < n; c1 += 1)\n"
+	  "    S(c0, c1);\n" },
+	{ "domain: \"[n] -> { S[i] : 0 <= i < n }\"\n"
+	  "child:\n"
+	  "  schedule: \"[{ S[i] -> [(i)] }]\"\n"
+	  "  coincident: [ 1 ]\n",
+	  NULL,
+	  "for (int c0 = 0; c0 < n; c0 += 1)\n"
+	  "  S(c0);\n" },
+};
+
+/* Check that the for nodes generated from coincident band members
+ * are printed with the expected OpenMP pragmas
+ * if the ast_print_openmp option is set.
+ * In particular, check that a loop generated from a coincident
+ * band member is not printed with a pragma if it carries
+ * any of the dependences set on the AST build or
+ * if no dependences have been set.
+ */
+static int test_ast_print_openmp(isl_ctx *ctx)
+{
+	int i;
+	int openmp;
+
+	openmp = isl_options_get_ast_print_openmp(ctx);
+	for (i = 0; i < ARRAY_SIZE(print_openmp_tests); ++i) {
+		const char *str;
+		isl_schedule *schedule;
+		isl_ast_build *build;
+		isl_ast_node *tree;
+		char *printed;
+		int same;
+
+		schedule = isl_schedule_read_from_str(ctx,
+					print_openmp_tests[i].schedule);
+		build = isl_ast_build_alloc(ctx);
+		str = print_openmp_tests[i].dependences;
+		if (str)
+			build = isl_ast_build_set_dependences(build,
+				    isl_union_map_read_from_str(ctx, str));
+		tree = isl_ast_build_node_from_schedule(build, schedule);
+		isl_ast_build_free(build);
+
+		isl_options_set_ast_print_openmp(ctx, 1);
+		printed = isl_ast_node_to_C_str(tree);
+		isl_options_set_ast_print_openmp(ctx, openmp);
+		isl_ast_node_free(tree);
+
+		same = printed && !strcmp(printed,
+					print_openmp_tests[i].expected);
+		free(printed);
+		if (!same)
+			isl_die(ctx, isl_error_unknown,
+				"unexpected OpenMP pragmas", return -1);
+	}
+
+	return 0;
+}
+
+/* Print the for node "node" to "p" using isl_ast_node_for_print.
+ */
+static __isl_give isl_printer *print_for_openmp(__isl_take isl_printer *p,
+	__isl_take isl_ast_print_options *options,
+	__isl_keep isl_ast_node *node, void *user)
+{
+	return isl_ast_node_for_print(node, p, options);
+}
+
+/* Check that an outermost coincident loop printed through
+ * a print_for callback that calls isl_ast_node_for_print
+ * is printed with an "omp parallel for" pragma
+ * rather than with an "omp simd" pragma.
+ */
+static int test_ast_print_openmp_print_for(isl_ctx *ctx)
+{
+	const char *str;
+	const char *expected;
+	isl_schedule *schedule;
+	isl_ast_build *build;
+	isl_ast_node *tree;
+	isl_ast_print_options *options;
+	isl_printer *p;
+	char *printed;
+	int same;
+	int openmp;
+
+	str = "domain: \"[n] -> { S[i] : 0 <= i < n }\"\n"
+	    "child:\n"
+	    "  schedule: \"[{ S[i] -> [(i)] }]\"\n"
+	    "  coincident: [ 1 ]\n";
+	expected =
+	    "#pragma omp parallel for\n"
+	    "for (int c0 = 0; c0 < n; c0 += 1)\n"
+	    "  S(c0);\n";
+	schedule = isl_schedule_read_from_str(ctx, str);
+	build = isl_ast_build_alloc(ctx);
+	build = isl_ast_build_set_dependences(build,
+				isl_union_map_empty(isl_space_params_alloc(ctx, 0)));
+	tree = isl_ast_build_node_from_schedule(build, schedule);
+	isl_ast_build_free(build);
+
+	openmp = isl_options_get_ast_print_openmp(ctx);
+	isl_options_set_ast_print_openmp(ctx, 1);
+	options = isl_ast_print_options_alloc(ctx);
+	options = isl_ast_print_options_set_print_for(options,
+						&print_for_openmp, NULL);
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_set_output_format(p, ISL_FORMAT_C);
+	p = isl_ast_node_print(tree, p, options);
+	printed = isl_printer_get_str(p);
+	isl_printer_free(p);
+	isl_options_set_ast_print_openmp(ctx, openmp);
+	isl_ast_node_free(tree);
+
+	same = printed && !strcmp(printed, expected);
+	free(printed);
+	if (!same)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected OpenMP pragma", return -1);
+
+	return 0;
+}
+
+/* Check that mark nodes representing OpenMP clauses are printed
+ * as part of the "omp parallel for" pragma of the loop they apply to,
+ * and that the private clause derived by
+ * isl_schedule_node_insert_private_mark does not include
+ * the reduction variable "sum", the variable "u" that is read
+ * before it is written in an iteration, nor the variable "w"
+ * that is read after the loop.
+ */
+static int test_ast_print_openmp_clauses(isl_ctx *ctx)
+{
+	const char *str;
+	const char *expected;
+	isl_schedule *schedule;
+	isl_schedule_node *node;
+	isl_union_map *reads, *writes;
+	isl_ast_build *build;
+	isl_ast_node *tree;
+	char *printed;
+	int same;
+	int openmp;
+
+	str = "domain: \"[n] -> { S[i] : 0 <= i < n; T[i] : 0 <= i < n; "
+		"U[] }\"\n"
+	    "child:\n"
+	    "  sequence:\n"
+	    "  - filter: \"{ S[i]; T[i] }\"\n"
+	    "    child:\n"
+	    "      schedule: \"[{ S[i] -> [(i)]; T[i] -> [(i)] }]\"\n"
+	    "      coincident: [ 1 ]\n"
+	    "      child:\n"
+	    "        sequence:\n"
+	    "        - filter: \"{ S[i] }\"\n"
+	    "        - filter: \"{ T[i] }\"\n"
+	    "  - filter: \"{ U[] }\"\n";
+	expected =
+	    "{\n"
+	    "  #pragma omp parallel for reduction(+:sum) private(t)\n"
+	    "  for (int c0 = 0; c0 < n; c0 += 1) {\n"
+	    "    S(c0);\n"
+	    "    T(c0);\n"
+	    "  }\n"
+	    "  U();\n"
+	    "}\n";
+	schedule = isl_schedule_read_from_str(ctx, str);
+	node = isl_schedule_get_root(schedule);
+	isl_schedule_free(schedule);
+	node = isl_schedule_node_child(node, 0);
+	node = isl_schedule_node_child(node, 0);
+	node = isl_schedule_node_child(node, 0);
+	node = isl_schedule_node_insert_mark(node,
+				isl_id_alloc(ctx, "reduction(+:sum)", NULL));
+	node = isl_schedule_node_child(node, 0);
+	str = "{ S[i] -> B[i]; S[i] -> u[]; T[i] -> t[]; T[i] -> sum[]; "
+		"U[] -> w[] }";
+	reads = isl_union_map_read_from_str(ctx, str);
+	str = "{ S[i] -> t[]; S[i] -> u[]; S[i] -> w[]; T[i] -> sum[]; "
+		"T[i] -> A[i] }";
+	writes = isl_union_map_read_from_str(ctx, str);
+	node = isl_schedule_node_insert_private_mark(node, reads, writes);
+	schedule = isl_schedule_node_get_schedule(node);
+	isl_schedule_node_free(node);
+
+	build = isl_ast_build_alloc(ctx);
+	build = isl_ast_build_set_dependences(build,
+				isl_union_map_empty(isl_space_params_alloc(ctx, 0)));
+	tree = isl_ast_build_node_from_schedule(build, schedule);
+	isl_ast_build_free(build);
+
+	openmp = isl_options_get_ast_print_openmp(ctx);
+	isl_options_set_ast_print_openmp(ctx, 1);
+	printed = isl_ast_node_to_C_str(tree);
+	isl_options_set_ast_print_openmp(ctx, openmp);
+	isl_ast_node_free(tree);
+
+	same = printed && !strcmp(printed, expected);
+	free(printed);
+	if (!same)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected OpenMP clauses", return -1);
+
+	return 0;
+}
+
+/* Increment the counter pointed to by "user".
+ */
+static __isl_give isl_ast_node *count_domain(__isl_take isl_ast_node *node,
+	__isl_keep isl_ast_build *build, void *user)
+{
+	int *count = user;
+
+	(*count)++;
+	return node;
+}
+
+/* Check that isl_ast_build_node_from_schedule_list generates
+ * a single AST that shares the loop over A between
+ * a tiled and an untiled version of the loop over B and
+ * only dispatches between the two versions of the latter.
+ * Also check that the AST of the loop over A is only generated once
+ * by counting the number of calls to the at_each_domain callback.
+ * That is, it should be called once for A and
+ * once for each version of B.
+ */
+static int test_ast_versions(isl_ctx *ctx)
+{
+	const char *str;
+	const char *expected;
+	isl_schedule *schedule, *tiled;
+	isl_schedule_node *node;
+	isl_schedule_list *schedules;
+	isl_set_list *conditions;
+	isl_multi_val *sizes;
+	isl_ast_build *build;
+	isl_ast_node *tree;
+	char *printed;
+	int same;
+	int count = 0;
+
+	str = "domain: \"[n] -> { A[i] : 0 <= i < n; B[i] : 0 <= i < n }\"\n"
+	    "child:\n"
+	    "  sequence:\n"
+	    "  - filter: \"{ A[i] }\"\n"
+	    "    child:\n"
+	    "      schedule: \"[{ A[i] -> [(i)] }]\"\n"
+	    "  - filter: \"{ B[i] }\"\n"
+	    "    child:\n"
+	    "      schedule: \"[{ B[i] -> [(i)] }]\"\n";
+	expected =
+	    "{\n"
+	    "  for (int c0 = 0; c0 < n; c0 += 1)\n"
+	    "    A(c0);\n"
+	    "  if (n >= 100) {\n"
+	    "    for (int c0 = 0; c0 < n; c0 += 32)\n"
+	    "      for (int c1 = 0; c1 <= min(31, n - c0 - 1); c1 += 1)\n"
+	    "        B(c0 + c1);\n"
+	    "  } else if (n <= 9) {\n"
+	    "    for (int c0 = 0; c0 < n; c0 += 1)\n"
+	    "      B(c0);\n"
+	    "  }\n"
+	    "}\n";
+	schedule = isl_schedule_read_from_str(ctx, str);
+	node = isl_schedule_get_root(schedule);
+	node = isl_schedule_node_child(node, 0);
+	node = isl_schedule_node_child(node, 1);
+	node = isl_schedule_node_child(node, 0);
+	sizes = isl_multi_val_read_from_str(ctx, "{ [32] }");
+	node = isl_schedule_node_band_tile(node, sizes);
+	tiled = isl_schedule_node_get_schedule(node);
+	isl_schedule_node_free(node);
+
+	schedules = isl_schedule_list_from_schedule(tiled);
+	schedules = isl_schedule_list_add(schedules, schedule);
+	str = "[n] -> { : n >= 100 }";
+	conditions = isl_set_list_from_set(isl_set_read_from_str(ctx, str));
+	str = "[n] -> { : n < 10 }";
+	conditions = isl_set_list_add(conditions,
+					isl_set_read_from_str(ctx, str));
+	build = isl_ast_build_alloc(ctx);
+	build = isl_ast_build_set_at_each_domain(build, &count_domain, &count);
+	tree = isl_ast_build_node_from_schedule_list(build, schedules,
+							conditions);
+	isl_ast_build_free(build);
+
+	printed = isl_ast_node_to_C_str(tree);
+	isl_ast_node_free(tree);
+
+	same = printed && !strcmp(printed, expected);
+	free(printed);
+	if (!same)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected versioned AST", return -1);
+	if (count != 3)
+		isl_die(ctx, isl_error_unknown,
+			"expecting shared subtree to be generated only once",
+			return -1);
+
+	return 0;
+}
+
 static int test_ast_gen(isl_ctx *ctx)
 {
 	if (test_ast_gen1(ctx) < 0)
@@ -8090,6 +9838,22 @@ static int test_ast_gen(isl_ctx *ctx)
 		return -1;
 	if (test_ast_expr(ctx) < 0)
 		return -1;
+	if (test_ast_print_stream(ctx) < 0)
+		return -1;
+	if (test_ast_expr_cache(ctx) < 0)
+		return -1;
+	if (test_ast_share_exprs(ctx) < 0)
+		return -1;
+	if (test_ast_subtree_reuse(ctx) < 0)
+		return -1;
+	if (test_ast_print_openmp(ctx) < 0)
+		return -1;
+	if (test_ast_print_openmp_print_for(ctx) < 0)
+		return -1;
+	if (test_ast_print_openmp_clauses(ctx) < 0)
+		return -1;
+	if (test_ast_versions(ctx) < 0)
+		return -1;
 	return 0;
 }
 
@@ -8753,6 +10517,123 @@ static int test_tile(isl_ctx *ctx)
 	return 0;
 }
 
+/* Inputs for test_tile_auto.
+ * "domain" is the instance set, "context" is the context
+ * of a context node inserted above the band node (if not NULL),
+ * "schedule" is the partial schedule of the band node,
+ * "access" contains the array accesses,
+ * "cache" is the value of the tile_cache_size option and
+ * "tile" is the expected partial schedule of the tile band.
+ *
+ * For the matrix multiplication,
+ * with tile size s, each of the three arrays has an estimated
+ * footprint of s^2 elements, so that the largest power of two
+ * for which 3 s^2 fits in 1024 elements is 16.
+ * The tile sizes are not reduced below 2 if the cache is very small.
+ * If a tile accesses an entire row of an array of parametric size,
+ * then its footprint cannot be bounded, unless the parameter
+ * is bounded by the context.  In the former case,
+ * the smallest tile size is used.  In the latter case,
+ * the footprint of a tile with tile size s is 10 s.
+ */
+static struct {
+	const char *domain;
+	const char *context;
+	const char *schedule;
+	const char *access;
+	int cache;
+	const char *tile;
+} tile_auto_tests[] = {
+	{ "[n] -> { S[i,j,k] : 0 <= i,j,k < n }", NULL,
+	  "[{ S[i,j,k] -> [i] }, { S[i,j,k] -> [j] }, { S[i,j,k] -> [k] }]",
+	  "{ S[i,j,k] -> C[i,j]; S[i,j,k] -> A[i,k]; S[i,j,k] -> B[k,j] }",
+	  1024,
+	  "[{ S[i,j,k] -> [floor(i/16)] }, "
+	  "{ S[i,j,k] -> [floor(j/16)] }, "
+	  "{ S[i,j,k] -> [floor(k/16)] }]" },
+	{ "[n] -> { S[i,j,k] : 0 <= i,j,k < n }", NULL,
+	  "[{ S[i,j,k] -> [i] }, { S[i,j,k] -> [j] }, { S[i,j,k] -> [k] }]",
+	  "{ S[i,j,k] -> C[i,j]; S[i,j,k] -> A[i,k]; S[i,j,k] -> B[k,j] }",
+	  1,
+	  "[{ S[i,j,k] -> [floor(i/2)] }, "
+	  "{ S[i,j,k] -> [floor(j/2)] }, "
+	  "{ S[i,j,k] -> [floor(k/2)] }]" },
+	{ "[n] -> { S[i,k] : 0 <= i < 1000 and 0 <= k < n }", NULL,
+	  "[{ S[i,k] -> [i] }]",
+	  "{ S[i,k] -> A[i,k] }",
+	  1024,
+	  "[{ S[i,k] -> [floor(i/2)] }]" },
+	{ "[n] -> { S[i,k] : 0 <= i < 1000 and 0 <= k < n }",
+	  "[n] -> { : n <= 10 }",
+	  "[{ S[i,k] -> [i] }]",
+	  "{ S[i,k] -> A[i,k] }",
+	  1024,
+	  "[{ S[i,k] -> [floor(i/64)] }]" },
+};
+
+/* Check that isl_schedule_node_band_tile_auto selects the expected
+ * tile sizes on the inputs in tile_auto_tests.
+ */
+static int test_tile_auto(isl_ctx *ctx)
+{
+	int i;
+	int scale, shift, cache;
+
+	scale = isl_options_get_tile_scale_tile_loops(ctx);
+	shift = isl_options_get_tile_shift_point_loops(ctx);
+	cache = isl_options_get_tile_cache_size(ctx);
+	isl_options_set_tile_scale_tile_loops(ctx, 0);
+	isl_options_set_tile_shift_point_loops(ctx, 0);
+
+	for (i = 0; i < ARRAY_SIZE(tile_auto_tests); ++i) {
+		int equal;
+		const char *str;
+		isl_union_set *domain;
+		isl_union_map *access;
+		isl_multi_union_pw_aff *mupa, *mupa2;
+		isl_schedule_node *node;
+
+		isl_options_set_tile_cache_size(ctx, tile_auto_tests[i].cache);
+
+		str = tile_auto_tests[i].domain;
+		domain = isl_union_set_read_from_str(ctx, str);
+		node = isl_schedule_node_from_domain(domain);
+		node = isl_schedule_node_child(node, 0);
+		str = tile_auto_tests[i].schedule;
+		mupa = isl_multi_union_pw_aff_read_from_str(ctx, str);
+		node = isl_schedule_node_insert_partial_schedule(node, mupa);
+		str = tile_auto_tests[i].context;
+		if (str) {
+			isl_set *context = isl_set_read_from_str(ctx, str);
+			node = isl_schedule_node_insert_context(node, context);
+			node = isl_schedule_node_child(node, 0);
+		}
+		str = tile_auto_tests[i].access;
+		access = isl_union_map_read_from_str(ctx, str);
+		node = isl_schedule_node_band_tile_auto(node, access);
+
+		str = tile_auto_tests[i].tile;
+		mupa = isl_multi_union_pw_aff_read_from_str(ctx, str);
+		mupa2 = isl_schedule_node_band_get_partial_schedule(node);
+		equal = isl_multi_union_pw_aff_plain_is_equal(mupa, mupa2);
+		isl_multi_union_pw_aff_free(mupa);
+		isl_multi_union_pw_aff_free(mupa2);
+		isl_schedule_node_free(node);
+
+		if (equal < 0)
+			return -1;
+		if (!equal)
+			isl_die(ctx, isl_error_unknown,
+				"unexpected tile sizes", return -1);
+	}
+
+	isl_options_set_tile_scale_tile_loops(ctx, scale);
+	isl_options_set_tile_shift_point_loops(ctx, shift);
+	isl_options_set_tile_cache_size(ctx, cache);
+
+	return 0;
+}
+
 /* Check that the domain hash of a space is equal to the hash
  * of the domain of the space.
  */
@@ -8890,6 +10771,95 @@ static int test_chambers(isl_ctx *ctx)
 	return 0;
 }
 
+/* Inputs for test_canonical.
+ * "str1" and "str2" are descriptions of union maps and
+ * "same" is set if their canonical forms are expected to be the same.
+ */
+struct {
+	const char *str1;
+	const char *str2;
+	int same;
+} canonical_tests[] = {
+	{ "{ A[i] -> B[j] : 0 <= i <= 10 and j = i + 1 }",
+	  "{ A[i] -> B[j] : j - 1 = i and i <= 10 and i >= 0 and j >= 1 }", 1 },
+	{ "{ A[i] -> B[i] : i < 0; A[i] -> B[i] : i > 5 }",
+	  "{ A[i] -> B[i] : i >= 6 or i <= -1 }", 1 },
+	{ "{ A[i] -> B[i] : 0 <= i < 5; A[i] -> B[i] : 5 <= i < 10 }",
+	  "{ A[i] -> B[i] : 0 <= i <= 9 }", 1 },
+	{ "[n] -> { A[i] -> [floor(i/2)] : i <= n; B[] -> C[] }",
+	  "[n] -> { B[] -> C[]; A[i] -> [floor(i/2)] : n - i >= 0 }", 1 },
+	{ "{ A[i] -> B[i] : 0 <= i <= 10 }",
+	  "{ A[i] -> C[i] : 0 <= i <= 10 }", 0 },
+	{ "{ A[i] -> B[i] : 0 <= i <= 10 }",
+	  "{ A[i] -> B[i] : 0 <= i <= 11 }", 0 },
+};
+
+/* Check that isl_union_map_canonicalize produces the same results
+ * for the pairs of union maps in canonical_tests that are expected
+ * to have the same canonical form and that the stable hash values
+ * agree with this.
+ * Also check that the stable hash value does not depend
+ * on the isl_ctx in which the union map is constructed.
+ */
+static int test_canonical(isl_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(canonical_tests); ++i) {
+		isl_ctx *ctx2;
+		isl_union_map *umap1, *umap2;
+		uint64_t hash1, hash2, hash3;
+		char *str1, *str2;
+		isl_stat r;
+		int same;
+
+		umap1 = isl_union_map_read_from_str(ctx,
+						canonical_tests[i].str1);
+		umap2 = isl_union_map_read_from_str(ctx,
+						canonical_tests[i].str2);
+		if (isl_union_map_get_stable_hash(umap1, &hash1) < 0 ||
+		    isl_union_map_get_stable_hash(umap2, &hash2) < 0) {
+			isl_union_map_free(umap1);
+			isl_union_map_free(umap2);
+			return -1;
+		}
+		umap1 = isl_union_map_canonicalize(umap1);
+		umap2 = isl_union_map_canonicalize(umap2);
+		str1 = isl_union_map_to_str(umap1);
+		str2 = isl_union_map_to_str(umap2);
+		isl_union_map_free(umap1);
+		isl_union_map_free(umap2);
+		if (!str1 || !str2)
+			same = -1;
+		else
+			same = !strcmp(str1, str2);
+		free(str1);
+		free(str2);
+		if (same < 0)
+			return -1;
+		if (same != canonical_tests[i].same)
+			isl_die(ctx, isl_error_unknown,
+				"unexpected canonical form", return -1);
+		if ((hash1 == hash2) != canonical_tests[i].same)
+			isl_die(ctx, isl_error_unknown,
+				"unexpected stable hash", return -1);
+
+		ctx2 = isl_ctx_alloc();
+		umap1 = isl_union_map_read_from_str(ctx2,
+						canonical_tests[i].str1);
+		r = isl_union_map_get_stable_hash(umap1, &hash3);
+		isl_union_map_free(umap1);
+		isl_ctx_free(ctx2);
+		if (r < 0)
+			return -1;
+		if (hash1 != hash3)
+			isl_die(ctx, isl_error_unknown,
+				"stable hash depends on context", return -1);
+	}
+
+	return 0;
+}
+
 struct {
 	const char *name;
 	int (*fn)(isl_ctx *ctx);
@@ -8931,10 +10901,12 @@ struct {
 	{ "injective", &test_injective },
 	{ "schedule (whole component)", &test_schedule_whole },
 	{ "schedule (incremental)", &test_schedule_incremental },
+	{ "schedule (cache)", &test_schedule_cache },
 	{ "schedule tree", &test_schedule_tree },
 	{ "schedule tree prefix", &test_schedule_tree_prefix },
 	{ "schedule tree grouping", &test_schedule_tree_group },
 	{ "tile", &test_tile },
+	{ "automatic tile size selection", &test_tile_auto },
 	{ "union_pw", &test_union_pw },
 	{ "locus", &test_locus },
 	{ "eval", &test_eval },
@@ -8943,6 +10915,7 @@ struct {
 	{ "affine hull", &test_affine_hull },
 	{ "simple_hull", &test_simple_hull },
 	{ "coalesce", &test_coalesce },
+	{ "canonical form", &test_canonical },
 	{ "factorize", &test_factorize },
 	{ "subset", &test_subset },
 	{ "subtract", &test_subtract },
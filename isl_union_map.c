@@ -16,13 +16,14 @@
 #include <isl_map_private.h>
 #include <isl_union_map_private.h>
 #include <isl/ctx.h>
-#include <isl/hash.h>
+#include <isl_hash_private.h>
 #include <isl_aff_private.h>
 #include <isl/map.h>
 #include <isl/set.h>
 #include <isl_space_private.h>
 #include <isl/union_set.h>
 #include <isl_maybe_map.h>
+#include <isl_sort.h>
 
 #include <bset_from_bmap.c>
 #include <set_to_map.c>
@@ -4067,6 +4068,106 @@ uint32_t isl_union_set_get_hash(__isl_keep isl_union_set *uset)
 	return isl_union_map_get_hash(uset);
 }
 
+/* Bring each map in "umap" into a canonical form.
+ */
+__isl_give isl_union_map *isl_union_map_canonicalize(
+	__isl_take isl_union_map *umap)
+{
+	return inplace(umap, &isl_map_canonicalize);
+}
+
+__isl_give isl_union_set *isl_union_set_canonicalize(
+	__isl_take isl_union_set *uset)
+{
+	return isl_union_map_canonicalize(uset);
+}
+
+/* Data structure for collecting the stable hash values
+ * of the maps in a union map.
+ *
+ * "n" is the number of hash values collected so far.
+ * "hash" holds the hash values.
+ */
+struct isl_union_map_stable_hash_data {
+	int n;
+	uint64_t *hash;
+};
+
+/* Store the stable hash value of "map" in data->hash.
+ */
+static isl_stat add_stable_hash(__isl_take isl_map *map, void *user)
+{
+	struct isl_union_map_stable_hash_data *data = user;
+	isl_stat r;
+
+	r = isl_map_get_stable_hash(map, &data->hash[data->n++]);
+	isl_map_free(map);
+
+	return r;
+}
+
+/* Compare the hash values "a" and "b".
+ */
+static int cmp_stable_hash(const void *a, const void *b, void *user)
+{
+	const uint64_t *h1 = a;
+	const uint64_t *h2 = b;
+
+	if (*h1 == *h2)
+		return 0;
+	return *h1 < *h2 ? -1 : 1;
+}
+
+/* Compute a 64-bit hash value that digests the canonical form of "umap"
+ * and that remains the same across different runs and
+ * store it in "hash".
+ *
+ * The maps in "umap" are visited in an order that depends
+ * on the addresses of their spaces, so the stable hash values
+ * of the maps are sorted before they are combined.
+ */
+isl_stat isl_union_map_get_stable_hash(__isl_keep isl_union_map *umap,
+	uint64_t *hash)
+{
+	struct isl_union_map_stable_hash_data data;
+	int i, n;
+
+	if (!umap)
+		return isl_stat_error;
+	if (!hash)
+		isl_die(isl_union_map_get_ctx(umap), isl_error_invalid,
+			"no hash value pointer", return isl_stat_error);
+
+	n = isl_union_map_n_map(umap);
+	data.n = 0;
+	data.hash = isl_alloc_array(isl_union_map_get_ctx(umap), uint64_t, n);
+	if (n && !data.hash)
+		return isl_stat_error;
+	if (isl_union_map_foreach_map(umap, &add_stable_hash, &data) < 0 ||
+	    isl_sort(data.hash, n, sizeof(uint64_t), &cmp_stable_hash,
+		    NULL) < 0) {
+		free(data.hash);
+		return isl_stat_error;
+	}
+
+	*hash = isl_hash64_init();
+	for (i = 0; i < n; ++i)
+		*hash = isl_hash64_uint64(*hash, data.hash[i]);
+	free(data.hash);
+
+	return isl_stat_ok;
+}
+
+/* Compute a 64-bit hash value that digests the canonical form of "uset"
+ * and that remains the same across different runs and
+ * store it in "hash".
+ */
+isl_stat isl_union_set_get_stable_hash(__isl_keep isl_union_set *uset,
+	uint64_t *hash)
+{
+	return isl_union_map_get_stable_hash(uset, hash);
+}
+
 /* Add the number of basic sets in "set" to "n".
  */
 static isl_stat add_n(__isl_take isl_set *set, void *user)
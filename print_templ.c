@@ -29,8 +29,7 @@ __isl_give char *FN(TYPE,to_str)(__isl_keep TYPE *obj)
 		return NULL;
 	p = isl_printer_to_str(FN(TYPE,get_ctx)(obj));
 	p = FN(isl_printer_print,BASE)(p, obj);
-	s = isl_printer_get_str(p);
-	isl_printer_free(p);
+	s = isl_printer_take_str(p);
 
 	return s;
 }
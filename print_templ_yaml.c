@@ -1,3 +1,5 @@
+#include <isl_printer_private.h>
+
 #define xCAT(A,B) A ## B
 #define CAT(A,B) xCAT(A,B)
 #undef TYPE
@@ -32,8 +34,7 @@ __isl_give char *FN(TYPE,to_str)(__isl_keep TYPE *obj)
 	p = isl_printer_to_str(FN(TYPE,get_ctx)(obj));
 	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_FLOW);
 	p = FN(isl_printer_print,BASE)(p, obj);
-	s = isl_printer_get_str(p);
-	isl_printer_free(p);
+	s = isl_printer_take_str(p);
 
 	return s;
 }
@@ -0,0 +1,66 @@
+for (int c0 = 0; c0 < n; c0 += 1) {
+  for (int c1 = 0; c1 <= 7; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 8; c1 <= 15; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 16; c1 <= 23; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 24; c1 <= 31; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 32; c1 <= 39; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 40; c1 <= 47; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 48; c1 <= 55; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 56; c1 <= 63; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 64; c1 <= 71; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 72; c1 <= 79; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 80; c1 <= 87; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 88; c1 <= 95; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 96; c1 <= 103; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 104; c1 <= 111; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 112; c1 <= 119; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 120; c1 <= 127; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 128; c1 <= 135; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 136; c1 <= 143; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 144; c1 <= 151; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 152; c1 <= 159; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 160; c1 <= 167; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 168; c1 <= 175; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 176; c1 <= 183; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 184; c1 <= 191; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 192; c1 <= 199; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 200; c1 <= 207; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 208; c1 <= 215; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 216; c1 <= 223; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 224; c1 <= 231; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 232; c1 <= 239; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 240; c1 <= 247; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 248; c1 <= 255; c1 += 1)
+    A(c0, c1);
+}
@@ -0,0 +1,16 @@
+for (int c0 = 0; c0 < n; c0 += 1) {
+  for (int c1 = 0; c1 <= 31; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 32; c1 <= 47; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 48; c1 <= 63; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 64; c1 <= 79; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 80; c1 <= 95; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 96; c1 <= 111; c1 += 1)
+    A(c0, c1);
+  for (int c1 = 112; c1 <= 127; c1 += 1)
+    A(c0, c1);
+}
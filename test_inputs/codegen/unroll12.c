@@ -0,0 +1,6 @@
+for (int c0 = 0; c0 <= 99; c0 += 1) {
+  A(c0, c0 - 3 * floord(-n, 3));
+  A(c0, c0 - 3 * floord(-n, 3) + 3);
+  A(c0, c0 - 3 * floord(-n, 3) + 6);
+  A(c0, c0 - 3 * floord(-n, 3) + 9);
+}